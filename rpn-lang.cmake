@@ -3,14 +3,30 @@ set(RPN_LANG_DIR ${CMAKE_CURRENT_LIST_DIR})
 set(RPN_LANG_SRCS
   rpn-stack.cpp
   rpn-interp.cpp
+  rpn-image.cpp
   types-dict.cpp
+  array-dict.cpp
   math-dict.cpp
   stack-dict.cpp
   logic-dict.cpp
   fraction-dict.cpp
   fraction.cpp
   timecode-dict.cpp  
+  timecode.cpp
+  fft-dict.cpp
+  fft.cpp
+  vec3-dict.cpp
+  vec3.cpp
+  matrix-dict.cpp
+  matrix.cpp
+  bignum-dict.cpp
+  bignum.cpp
+  random-dict.cpp
+  random.cpp
+  trie.cpp
+  trace.cpp
   keypad-dict.cpp
+  work-pool.cpp
 )
 
 list(TRANSFORM RPN_LANG_SRCS PREPEND ${RPN_LANG_DIR}/src/)
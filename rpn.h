@@ -17,6 +17,7 @@
 #define _RPN_LANG_RPN_H_
 
 #include <memory>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <deque>
@@ -24,15 +25,70 @@
 #include <cmath>
 #include <stdexcept>
 #include <functional>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <typeinfo>
+
+namespace q {
+  struct FrameRate; // src/timecode.h
+  class Random; // src/random.h
+}
 
 namespace rpn {
+  /*
+   * number formatting.  Each Stack (so each Interp) carries its own format,
+   * it's made current on the calling thread while the stack is being
+   * evaluated or rendered.
+   */
+  struct NumberFormat {
+    int decimals = 10; // rounded to this many places, then the shortest form that round-trips
+
+    static const NumberFormat &current();
+    class Use { // scoped: makes a format current for this thread
+    public:
+      Use(const NumberFormat &f);
+      ~Use();
+    private:
+      const NumberFormat *_prev;
+    };
+  };
+
+  // writes into [first,last), returns the end like std::to_chars, 32 chars is always enough
+  char *to_chars(char *first, char *last, const double &dv, const NumberFormat &f=NumberFormat::current());
   std::string to_string(const double &dv);
 
+  class ImageWriter;
+
+  /*
+   * every Stack::Object type has a small dense tag, see TypeRegistry.
+   * the built in types have these, the rest are handed out in order
+   */
+  using TypeTag = uint16_t;
+  enum : TypeTag {
+    tt_any = 0, // rpn::Stack::Object itself, a validator matches anything with it
+    tt_double,
+    tt_integer,
+    tt_boolean,
+    tt_string,
+    tt_object,
+    tt_array,
+    tt_vec3,
+    tt_registered, // the first one TypeRegistry hands out
+    tt_untagged = 0xffff
+  };
+
   class Stack {
   public:
     class Object {
     public:
+      Object() = default;
+      Object(const Object &) = default;
+      Object &operator=(const Object &) = default;
       virtual ~Object() {};
+      // stamped when it's pushed, otherwise looked up
+      TypeTag tag() const { return (_tag != tt_untagged) ? _tag : lookup_tag(); }
       virtual bool operator==(const Object &rhs) const =0;
       virtual bool operator>(const Object &/*rhs*/) const {
         throw std::runtime_error("operator> invalid for type");
@@ -45,13 +101,23 @@ namespace rpn {
       virtual operator double() const { return std::nan(""); };
       //      virtual operator int64_t() const =0;
       virtual std::string deparse() const =0;
+      // binary image of the object, see rpn-image.cpp.  false if the type can't be imaged
+      virtual bool image(ImageWriter &/*w*/) const { return false; }
       std::string to_string() const { return static_cast<std::string>(*this); }
+    protected:
+      Object(TypeTag tag) : _tag(tag) {} // a type that knows its tag up front
+    private:
+      friend class Stack;
+      TypeTag lookup_tag() const;
+      TypeTag _tag = tt_untagged;
     };
 
     Stack() {};
     ~Stack() {};
 
     void push(const Object &ob);
+    void push(std::unique_ptr<Object> ob);
+    void pushn(std::vector<std::unique_ptr<Object>> &&obs); // obs[0] ends up deepest
     void push_boolean(const bool &val);
     void push_string(const std::string &val);
     void push_integer(const int64_t &val);
@@ -65,8 +131,10 @@ namespace rpn {
     bool pop_as_boolean(); // auto-converts boolean, integer, double, and string, returns false if it couldn't convert
 
     std::unique_ptr<Object> pop();
+    std::vector<std::unique_ptr<Object>> popn(size_t n); // deepest first
 
-    Object &peek(int n);
+    Object &peek(int n); // counts as a change to level n
+    const Object &peek_const(int n); // read-only, leaves the change journal alone
     bool peek_boolean(int n);
     std::string peek_string(int n);
     std::string peek_as_string(int n); // auto-converts to string if the type is not string
@@ -77,6 +145,7 @@ namespace rpn {
     // basic stack operations
 
     void clear(); // [prim]
+    void swap(Stack &other); // exchanges contents, each keeps its format
     size_t depth(); // [prim]
     void dropn(int n); // [prim]
     void dupn(int n); // [prim]
@@ -101,10 +170,75 @@ namespace rpn {
     void print(const std::string &msg="");
 
     std::vector<size_t> types() const;
+
+    // ->PRECISION
+    int precision() const { return _format.decimals; }
+    void setPrecision(int decimals);
+    const NumberFormat &format() const { return _format; }
+
+    /*
+     * change journal, so front ends only re-render what changed.  Every
+     * change bumps the generation and stamps the slots it touched; slots
+     * count from the bottom so they stay put while things above them come
+     * and go.  Rendered strings are cached per entry.
+     */
+    struct Change {
+      size_t slot; // 0 is the bottom of the stack
+      std::string text;
+    };
+    uint64_t generation() const { return _generation; }
+    // changed entries among the top n since generation 'since', returns the generation to pass next time
+    uint64_t changes(uint64_t since, int n, std::vector<Change> &out);
+
   private:
-    std::deque<std::unique_ptr<Object>> _stack;
+    struct Entry {
+      Entry(std::unique_ptr<Object> o, uint64_t g = 0) : ob(std::move(o)), changed(g) {}
+      std::unique_ptr<Object> ob;
+      uint64_t changed = 0; // generation of the last change to this slot
+      std::string text;     // rendered, valid when textDecimals matches the format
+      int textDecimals = -1;
+    };
+    Entry &entry(int n);
+    const std::string &text(Entry &e);
+    void touch(size_t n); // stamp the top n slots
+    static void stamp(Object &ob); // its tag, on the way in
+
+    std::deque<Entry> _stack;
+    NumberFormat _format;
+    uint64_t _generation = 0;
   };
 
+  /*
+   * dense tags for the Stack::Object types.  A type gets one the first
+   * time it's asked about; add() names it (for .S and friends) and can
+   * give it operators that skip the virtual ones when both sides are
+   * that type.  Register before the type is in use, tags are read
+   * without a lock.
+   */
+  class TypeRegistry {
+  public:
+    struct Ops {
+      bool (*equal)(const Stack::Object &a, const Stack::Object &b) = nullptr;
+      bool (*less)(const Stack::Object &a, const Stack::Object &b) = nullptr;
+    };
+    static const size_t k_maxTypes = 1024;
+
+    static TypeTag tag(const std::type_info &t); // registers t if it's new
+    template<typename T> static TypeTag add(const std::string &name, const Ops &ops = Ops()) {
+      return add(typeid(T), name, ops);
+    }
+    static TypeTag add(const std::type_info &t, const std::string &name, const Ops &ops);
+
+    static const std::string &name(TypeTag tag);
+    static const Ops &ops(TypeTag tag);
+    static size_t size(); // tags handed out so far
+  };
+
+  template<typename T> TypeTag type_tag() {
+    static const TypeTag sk_tag = TypeRegistry::tag(typeid(T));
+    return sk_tag;
+  }
+
   class Interp;
 
   // base class to give a word definition context
@@ -115,6 +249,80 @@ namespace rpn {
   protected:
   };
 
+  /*
+   * binary images (SAVE-IMAGE/LOAD-IMAGE)
+   *
+   * An image is a small header followed by sections.  Each object is written
+   * as a record: its type name, the payload length and the payload, so a
+   * reader can skip what it doesn't know.  Types register a loader by name
+   * with ImageReader::addType().
+   */
+  class ImageWriter {
+  public:
+    static const uint32_t version;
+    static uint64_t hash(const std::string &bytes, uint64_t h=14695981039346656037ull); // FNV-1a
+
+    void header();
+    void record(const std::string &type); // first thing an image() implementation calls
+    void object(const Stack::Object &ob); // throws if the type can't be imaged
+
+    void u8(uint8_t v) { _buf.push_back(char(v)); }
+    void u32(uint32_t v) { raw(&v, sizeof(v)); }
+    void i64(int64_t v) { raw(&v, sizeof(v)); }
+    void f64(double v) { raw(&v, sizeof(v)); }
+    void str(const std::string &v) { u32(uint32_t(v.size())); _buf.append(v); }
+
+    const std::string &bytes() const { return _buf; }
+    bool write(const std::string &path) const;
+
+  private:
+    void raw(const void *p, size_t n) { _buf.append(static_cast<const char*>(p), n); }
+    std::string _buf;
+    std::vector<size_t> _open; // offsets of the length fields of open records
+  };
+
+  class ImageReader {
+  public:
+    using Loader = std::function<std::unique_ptr<Stack::Object>(ImageReader &r)>;
+    static bool addType(const std::string &type, const Loader &loader);
+
+    ImageReader(const char *data, size_t size, WordContext *ctx=nullptr) : _p(data), _end(data+size), _ctx(ctx) {}
+
+    bool header();
+    std::unique_ptr<Stack::Object> object();
+
+    uint8_t u8() { uint8_t v; raw(&v, sizeof(v)); return v; }
+    uint32_t u32() { uint32_t v; raw(&v, sizeof(v)); return v; }
+    int64_t i64() { int64_t v; raw(&v, sizeof(v)); return v; }
+    double f64() { double v; raw(&v, sizeof(v)); return v; }
+    std::string str();
+
+    bool at_end() const { return _p == _end; }
+    WordContext *context() const { return _ctx; }
+
+  private:
+    void raw(void *p, size_t n);
+    const char *_p;
+    const char *_end;
+    WordContext *_ctx;
+  };
+
+  // read-only view of an image file, mmap()ed where we can
+  class ImageMap {
+  public:
+    ImageMap(const std::string &path);
+    ~ImageMap();
+    ImageMap(const ImageMap &) = delete;
+    ImageMap &operator=(const ImageMap &) = delete;
+    bool ok() const { return _data != nullptr; }
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+  private:
+    const char *_data = nullptr;
+    size_t _size = 0;
+    std::string _buf; // fallback when we can't map
+  };
+
   // Class family for validating word definitions against stack type and depth
   class StackValidator {
   public:
@@ -149,6 +357,9 @@ namespace rpn {
 
     static const StrictTypeValidator d2_array_any;
     static const StrictTypeValidator d2_any_array;
+    static const StrictTypeValidator d2_array_array;
+    static const StrictTypeValidator d2_integer_array;
+    static const StrictTypeValidator d2_string_array;
 
     static const StrictTypeValidator d2_string_any;
     static const StrictTypeValidator d2_any_string;
@@ -169,6 +380,9 @@ namespace rpn {
     static const StrictTypeValidator d3_boolean_any_any;
     static const StrictTypeValidator d3_object_string_any;
     static const StrictTypeValidator d3_string_any_object;
+    static const StrictTypeValidator d3_integer_any_array;
+    static const StrictTypeValidator d3_any_integer_array;
+    static const StrictTypeValidator d3_integer_integer_array;
 
     static const StrictTypeValidator d4_double_double_double_integer;
     static const StrictTypeValidator d4_integer_double_double_double;
@@ -228,12 +442,36 @@ namespace rpn {
     void eval(std::string line, std::function<void(rpn::WordDefinition::Result)>completionHandler=nullCompletionHandler);
     void parseFile(const std::string &path, std::function<void(rpn::WordDefinition::Result)>completionHandler=nullCompletionHandler);
 
+    // binary snapshot of the stack and user defined words, queued like eval()
+    void saveImage(const std::string &path, std::function<void(rpn::WordDefinition::Result)>completionHandler);
+    void loadImage(const std::string &path, std::function<void(rpn::WordDefinition::Result)>completionHandler);
+    // mainly for test cases, nothing else may be running
+    bool saveImage(const std::string &path);
+    bool loadImage(const std::string &path);
+
+    // a shared object's words, see RPN_DICTIONARY()
+    bool loadDictionary(const std::string &path);
+
+    // parseFile() keeps a compiled cache next to the source (path + "c")
+    void setParseCache(bool enable);
+
+    // the rate timecode literals are read at, 24 fps to start
+    void setFrameRate(const q::FrameRate &rate);
+    const q::FrameRate &frameRate() const;
+
+    // each Interp has its own generator, SEED makes it repeatable
+    q::Random &random();
+
     bool addDefinition(const std::string &word, const WordDefinition &def);
+    // a native word from a plain function, see native::Overloads below
+    template<typename Sig, typename F = Sig*> bool def(const std::string &word, F fn);
     bool removeDefinition(const std::string &word);
     bool addCompiledWord(const std::string &word, const std::string &def, const StackValidator &v = StackSizeValidator::zero);
 
     bool validateWord(const std::string &word);
     bool wordExists(const std::string &word);
+    // defined words starting with prefix, sorted, at most limit of them (0 for all)
+    std::vector<std::string> complete(const std::string &prefix, size_t limit = 0);
 
     /*
      * XXX-ELH- should the stack be public or private?
@@ -248,13 +486,21 @@ namespace rpn {
 
     struct Privates;
   private:
+    explicit Interp(Privates *shared); // runs shared's lambdas, see Privates::pool(), or with nothing, see module_index()
     rpn::WordDefinition::Result parse(std::string &line);
+    bool addNative(const std::string &word, const WordDefinition &def);
     void addStackWords();
     void addMathWords();
     void addLogicWords();
     void addTypeWords();
+    void addArrayWords();
     void addFractionWords();
     void addTimecodeWords();
+    void addFftWords();
+    void addVec3Words();
+    void addMatrixWords();
+    void addBignumWords();
+    void addRandomWords();
     Privates *m_p;
   };
 
@@ -309,10 +555,11 @@ class TStackObject : public rpn::Stack::Object {
 namespace stack {
 class Double : public rpn::Stack::Object {
  public:
- Double(const double &v) : _v(v) {}
+ Double(const double &v) : rpn::Stack::Object(rpn::tt_double), _v(v) {}
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Double>(*this); };
   virtual operator std::string() const override { return rpn::to_string(_v); };
   operator double() const override { return _v; };
+  double val() const { return _v; };
   virtual bool operator==(const Object &orhs) const override {
     const auto &rhs = PEEK_CAST(const Double,orhs);
     return (_v == rhs._v);
@@ -328,13 +575,18 @@ class Double : public rpn::Stack::Object {
   virtual std::string deparse() const override {
     return std::to_string(_v);
   }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Double");
+    w.f64(_v);
+    return true;
+  }
  private:
   double _v;
 };
 
 class Integer : public rpn::Stack::Object {
 public:
-Integer(const int64_t &v) : _v(v) {}
+Integer(const int64_t &v) : rpn::Stack::Object(rpn::tt_integer), _v(v) {}
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Integer>(*this); };
   virtual operator std::string() const override { return std::to_string(_v); };
   virtual operator double() const override { return double(_v); };
@@ -344,27 +596,40 @@ Integer(const int64_t &v) : _v(v) {}
   }
   operator int64_t() const { return _v; };
   operator uint64_t() const { return _v; };
+  int64_t val() const { return _v; };
   virtual bool operator>(const Object &orhs) const override {
+    if (orhs.tag() != rpn::tt_integer) {
+      return orhs < *this; // a BigInt knows how to compare with us
+    }
     const auto &rhs = PEEK_CAST(const Integer,orhs);
     return (_v > rhs._v);
   }
   virtual bool operator<(const Object &orhs) const override {
+    if (orhs.tag() != rpn::tt_integer) {
+      return orhs > *this;
+    }
     const auto &rhs = PEEK_CAST(const Integer,orhs);
     return (_v < rhs._v);
   }
   virtual std::string deparse() const override {
     return std::to_string(_v);
   }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Integer");
+    w.i64(_v);
+    return true;
+  }
  private:
   int64_t _v;
 };
 
 class Boolean : public rpn::Stack::Object {
  public:
-  Boolean(const bool &v) : _v(v) {}
+  Boolean(const bool &v) : rpn::Stack::Object(rpn::tt_boolean), _v(v) {}
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Boolean>(_v); };
   virtual operator std::string() const override { return _v ? "<true>" : "<false>"; };
   operator bool() const { return _v; };
+  bool val() const { return _v; };
   virtual operator double() const override { return double(_v); };
   virtual bool operator==(const Object &orhs) const override {
     const auto &rhs = PEEK_CAST(const Boolean,orhs);
@@ -379,7 +644,12 @@ class Boolean : public rpn::Stack::Object {
     return (_v < rhs._v);
   }
   virtual std::string deparse() const override {
-    return std::string(*this);
+    return _v ? "TRUE" : "FALSE";
+  }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Boolean");
+    w.u8(_v);
+    return true;
   }
  private:
   bool _v;
@@ -387,8 +657,9 @@ class Boolean : public rpn::Stack::Object {
 
 class String : public rpn::Stack::Object {
  public:
-  String(const std::string &v) : _v(v) {}
+  String(const std::string &v) : rpn::Stack::Object(rpn::tt_string), _v(v) {}
   virtual operator std::string() const override { return _v; };
+  const std::string &val() const { return _v; };
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<String>(_v); };
   virtual bool operator==(const Object &orhs) const override {
     const auto &rhs = PEEK_CAST(const String,orhs);
@@ -407,129 +678,270 @@ class String : public rpn::Stack::Object {
     rv += _v + "\"";
     return rv;
   }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("String");
+    w.str(_v);
+    return true;
+  }
  private:
   std::string _v;
 };
 
+/*
+ * Object and Array share their members between copies; deep_copy() is
+ * O(1) and the first mutation of a shared payload detaches it
+ * (copy-on-write).  Members are copied with deep_copy() on detach, so
+ * nested compounds stay shared until they are written themselves.
+ *
+ * Object keys are interned, and the sorted key list lives in a Shape
+ * shared by every object built with the same keys; an object itself is
+ * just its shape and a flat vector of values in key order.
+ */
 class Object : public rpn::Stack::Object {
 public:
-  Object() = default;
-  Object(const Object &v)  {
-    for(auto const &m : v._v) {
-      _v.emplace(m.first, m.second->deep_copy());
-    }
-  }
+  using Key = const std::string *; // interned, compare by address
+  using Values = std::vector<std::unique_ptr<rpn::Stack::Object>>;
+  static Key intern(const std::string &name);
+
+  class Shape {
+  public:
+    static const Shape *empty();
+    static constexpr size_t npos = size_t(-1);
+    size_t find(const std::string &name) const; // index of name, or npos
+    const Shape *with(Key key) const; // this shape plus key
+    size_t size() const { return _keys.size(); }
+    Key key(size_t i) const { return _keys[i]; }
+  private:
+    std::vector<Key> _keys; // sorted by name
+    mutable std::map<Key,const Shape*> _next;
+  };
+
+  Object() : rpn::Stack::Object(rpn::tt_object), _shape(Shape::empty()), _v(std::make_shared<Values>()) {}
+  Object(const Object &v) = default;
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override {
     return std::make_unique<stack::Object>(*this);
   }
   virtual bool operator==(const rpn::Stack::Object &orhs) const override {
     const auto &rhs = PEEK_CAST(const Object,orhs);
-    bool rv = _v.size() == rhs._v.size();
-    for(auto i=_v.cbegin(), j=rhs._v.cbegin(); rv && i!= _v.cend(); i++,j++) {
-      rv &= (i->first == j->first) && (*(i->second) == *(j->second));
+    bool rv = _shape == rhs._shape;
+    for(size_t i=0; rv && i<size(); i++) {
+      rv &= (value(i) == rhs.value(i));
     }
     return rv;
   }
   virtual bool operator>(const rpn::Stack::Object &orhs) const override {
-    auto &rhs = PEEK_CAST(const stack::Object,orhs);
+    [[maybe_unused]] auto &rhs = PEEK_CAST(const stack::Object,orhs);
     // XXX-ELH: todo
     return false;
   }
   virtual bool operator<(const rpn::Stack::Object &orhs) const override {
-    auto &rhs = PEEK_CAST(const stack::Object,orhs);
+    [[maybe_unused]] auto &rhs = PEEK_CAST(const stack::Object,orhs);
     // XXX-ELH: todo
     return false;
   }
+  // the first value added for a name is kept
   void add_value(const std::string &name, const rpn::Stack::Object &val) {
-    _v.emplace(name, val.deep_copy());
+    if (_shape->find(name) == Shape::npos) {
+      const Shape *next = _shape->with(intern(name));
+      auto &v = mut();
+      v.insert(v.begin()+next->find(name), val.deep_copy());
+      _shape = next;
+    }
   }
-  bool has_member(const std::string &name) {
-    return (_v.find(name) != _v.end());
+  bool has_member(const std::string &name) const {
+    return _shape->find(name) != Shape::npos;
   }
-  rpn::Stack::Object &member(const std::string &name) {
-    auto v = _v.find(name);
-    if (v != _v.end()) {
-      return *v->second;
+  const rpn::Stack::Object &member(const std::string &name) const {
+    size_t i = _shape->find(name);
+    if (i != Shape::npos) {
+      return value(i);
     } else {
       std::string err = "XObject: no such member (";
       throw std::runtime_error(err + name + ")");
     }
   }
+  rpn::Stack::Object &member(const std::string &name) {
+    mut();
+    return const_cast<rpn::Stack::Object&>(std::as_const(*this).member(name));
+  }
+  bool shared() const { return _v.use_count() > 1; }
+  const Shape *shape() const { return _shape; }
+  size_t size() const { return _v->size(); }
+  const std::string &key(size_t i) const { return *_shape->key(i); }
+  const rpn::Stack::Object &value(size_t i) const { return *(*_v)[i]; }
   virtual operator std::string() const override {
     std::string rv = "{";
-    for(auto const &m : _v) {
-      rv += m.first;
+    for(size_t i=0; i<size(); i++) {
+      rv += key(i);
       rv += ":";
-      rv += m.second->to_string();
+      rv += value(i).to_string();
       rv += ", ";
     }
     rv += "}";
     return rv;
   };
   virtual std::string deparse() const override {
-    // XXX-ELH: todo
-    return "n/a";
+    if (size() == 0) {
+      return "n/a"; // no word makes an empty object
+    }
+    std::string rv;
+    const char *op = "->OBJ";
+    for(size_t i=0; i<size(); i++) {
+      rv += value(i).deparse() + " .\" " + key(i) + "\" " + op + " ";
+      op = "+";
+    }
+    rv.pop_back();
+    return rv;
+  }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Object");
+    w.u32(uint32_t(size()));
+    for(size_t i=0; i<size(); i++) {
+      w.str(key(i));
+      w.object(value(i));
+    }
+    return true;
   }
-  const auto &val() const { return _v; };
 protected:
-  std::map<std::string,std::unique_ptr<rpn::Stack::Object>> _v;
+  Values &mut() {
+    if (shared()) {
+      auto v = std::make_shared<Values>();
+      v->reserve(_v->size());
+      for(auto const &e : *_v) {
+	v->push_back(e->deep_copy());
+      }
+      _v = std::move(v);
+    }
+    return *_v;
+  }
+  const Shape *_shape;
+  std::shared_ptr<Values> _v; // parallel to _shape's keys
 };
 
 class Array : public rpn::Stack::Object {
 public:
-  Array() = default;
-  Array(const Array &a)  {
-    for(auto const &e : a._v) {
-      _v.push_back(e->deep_copy());
-    }
-  }
+  using Elements = std::vector<std::unique_ptr<rpn::Stack::Object>>;
+  Array() : rpn::Stack::Object(rpn::tt_array), _v(std::make_shared<Elements>()) {}
+  Array(Elements &&v) : rpn::Stack::Object(rpn::tt_array), _v(std::make_shared<Elements>(std::move(v))) {}
+  Array(const Array &a) = default;
   virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override {
     return std::make_unique<Array>(*this);
   }
   virtual bool operator==(const rpn::Stack::Object &orhs) const override {
     const auto &rhs = PEEK_CAST(const Array,orhs);
-    bool rv = _v.size() == rhs._v.size();
-    for(auto i=_v.cbegin(), j=rhs._v.cbegin(); rv && i!= _v.cend(); i++,j++) {
-      rv &= (*i == *j);
+    const Elements &l = *_v, &r = *rhs._v;
+    bool rv = l.size() == r.size();
+    for(auto i=l.cbegin(), j=r.cbegin(); rv && i!= l.cend(); i++,j++) {
+      rv &= (**i == **j);
     }
     return rv;
   }
   virtual bool operator>(const rpn::Stack::Object &orhs) const override {
-    const auto &rhs = PEEK_CAST(const Array,orhs);
+    [[maybe_unused]] const auto &rhs = PEEK_CAST(const Array,orhs);
     // XXX-ELH: todo
     return false;
   }
   virtual bool operator<(const rpn::Stack::Object &orhs) const override {
-    const auto &rhs = PEEK_CAST(const Array,orhs);
+    [[maybe_unused]] const auto &rhs = PEEK_CAST(const Array,orhs);
     // XXX-ELH: todo
     return false;
   }
   virtual std::string deparse() const override {
     std::string rv;
-    for(const auto &e : _v) {
+    for(const auto &e : *_v) {
       rv += e->deparse() + " ";
     }
-    rv += std::to_string(_v.size()) + " ->ARRAY";
+    rv += std::to_string(_v->size()) + " ->ARRAY";
     return rv;
   }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Array");
+    w.u32(uint32_t(_v->size()));
+    for(auto const &e : *_v) {
+      w.object(*e);
+    }
+    return true;
+  }
   void add_value(const rpn::Stack::Object &val) {
-    _v.push_back(val.deep_copy());
+    mut().push_back(val.deep_copy());
+  }
+  void add_value(std::unique_ptr<rpn::Stack::Object> val) {
+    mut().push_back(std::move(val));
+  }
+  void insert_value(size_t at, std::unique_ptr<rpn::Stack::Object> val) {
+    auto &v = mut();
+    v.insert(v.begin()+at, std::move(val));
+  }
+  void put_value(size_t at, std::unique_ptr<rpn::Stack::Object> val) {
+    mut()[at] = std::move(val);
+  }
+  // appends a's elements, taking them over when a is not shared
+  void append(Array &&a) {
+    if (a.shared() || a._v == _v) {
+      const Elements &src = *a._v;
+      size_t n = src.size();
+      auto &v = mut();
+      v.reserve(v.size()+n);
+      for(size_t i=0; i<n; i++) {
+	v.push_back(src[i]->deep_copy());
+      }
+    } else {
+      auto &v = mut();
+      v.reserve(v.size()+a._v->size());
+      std::move(a._v->begin(), a._v->end(), std::back_inserter(v));
+      a._v->clear();
+    }
+  }
+  // keep [b,e)
+  void slice(size_t b, size_t e) {
+    if (shared()) {
+      auto v = std::make_shared<Elements>();
+      v->reserve(e-b);
+      for(size_t i=b; i<e; i++) {
+	v->push_back((*_v)[i]->deep_copy());
+      }
+      _v = std::move(v);
+    } else {
+      _v->erase(_v->begin()+e, _v->end());
+      _v->erase(_v->begin(), _v->begin()+b);
+    }
   }
   void reverse() {
-    std::reverse(_v.begin(), _v.end());
+    auto &v = mut();
+    std::reverse(v.begin(), v.end());
+  }
+  // hands over the elements (copies if shared), leaving this empty
+  Elements release() {
+    Elements rv = std::move(mut());
+    _v = std::make_shared<Elements>();
+    return rv;
   }
+  size_t size() const { return _v->size(); }
+  const rpn::Stack::Object &value(size_t i) const { return *(*_v)[i]; }
+  bool shared() const { return _v.use_count() > 1; }
   virtual operator std::string() const override {
     std::string rv = "[";
-    for(auto const &e : _v) {
+    for(auto const &e : *_v) {
       rv += e->to_string();
       rv += ", ";
     }
     rv += "]";
     return rv;
   };
-  const auto &val() const { return _v; };
+  const Elements &val() const { return *_v; };
  protected:
-  std::vector<std::unique_ptr<rpn::Stack::Object>> _v;
+  Elements &mut() {
+    if (shared()) {
+      auto v = std::make_shared<Elements>();
+      v->reserve(_v->size());
+      for(auto const &e : *_v) {
+	v->push_back(e->deep_copy());
+      }
+      _v = std::move(v);
+    }
+    return *_v;
+  }
+  std::shared_ptr<Elements> _v;
 };
 } // namespace stack
 
@@ -542,8 +954,8 @@ using StArray = stack::Array;
 
 class StVec3 : public rpn::Stack::Object {
 public:
-  StVec3(const StVec3 &other) : _x(other._x), _y(other._y), _z(other._z) {};
-  StVec3(const double &x=std::nan(""), const double &y=std::nan(""), const double &z=std::nan("")) : _x(x), _y(y), _z(z) {};
+  StVec3(const StVec3 &other) : rpn::Stack::Object(rpn::tt_vec3), _x(other._x), _y(other._y), _z(other._z) {};
+  StVec3(const double &x=std::nan(""), const double &y=std::nan(""), const double &z=std::nan("")) : rpn::Stack::Object(rpn::tt_vec3), _x(x), _y(y), _z(z) {};
   virtual ~StVec3() {};
   virtual bool operator==(const Object &orhs) const override {
     const StVec3 &rhs = PEEK_CAST(const StVec3,orhs);
@@ -578,6 +990,13 @@ public:
     rv += std::to_string(_z) + " ->VEC3";
     return rv;
   }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Vec3");
+    w.f64(_x);
+    w.f64(_y);
+    w.f64(_z);
+    return true;
+  }
 
 public:
   // should these be public or private?
@@ -587,11 +1006,182 @@ public:
   double _z;
 };
 
+/*
+ * native words from plain functions.  The signature says what a word
+ * takes and leaves, parameters in stack order (the last is the top):
+ *
+ *   rpn.def<double(double,double)>("HYPOT", hypot);
+ *   rpn.def<int64_t(int64_t,int64_t)>("XOR", [](int64_t a, int64_t b) { return a ^ b; });
+ *
+ * A parameter is a double (an Integer is promoted), an int64_t, a bool,
+ * a std::string, or a const reference to a stack type (rpn::Stack::Object
+ * takes anything).  Every mix of
+ * Double and Integer gets its own validator and its own thunk, so the
+ * thunk already knows each type it pops and never has to ask.  A
+ * leading rpn::Interp& doesn't come from the stack, it's for words that
+ * push something of their own choosing.  A word that returns a Result
+ * can refuse, anything but ok puts its arguments back.
+ *
+ * The dictionary takes the first match, and a mix an earlier def<> of
+ * the word already covers is left to it - register an Integer only
+ * version before the promoted one.
+ */
+namespace rpn {
+  namespace native {
+    template<typename... T> struct List {};
+
+    // where a parameter comes from
+    template<typename T> struct Param {
+      static_assert(std::is_base_of<rpn::Stack::Object, T>::value, "def<>: not a stack type");
+      using Accepts = List<T>;
+      template<typename St> static const T &get(const rpn::Stack::Object &o) { return static_cast<const T&>(o); }
+    };
+    template<> struct Param<double> {
+      using Accepts = List<StDouble, StInteger>;
+      template<typename St> static double get(const rpn::Stack::Object &o) { return double(static_cast<const St&>(o).val()); }
+    };
+    template<> struct Param<int64_t> {
+      using Accepts = List<StInteger>;
+      template<typename St> static int64_t get(const rpn::Stack::Object &o) { return static_cast<const StInteger&>(o).val(); }
+    };
+    template<> struct Param<bool> {
+      using Accepts = List<StBoolean>;
+      template<typename St> static bool get(const rpn::Stack::Object &o) { return static_cast<const StBoolean&>(o).val(); }
+    };
+    template<> struct Param<std::string> {
+      using Accepts = List<StString>;
+      template<typename St> static const std::string &get(const rpn::Stack::Object &o) { return static_cast<const StString&>(o).val(); }
+    };
+
+    // where a result goes
+    template<typename T> struct Push {
+      static_assert(std::is_base_of<rpn::Stack::Object, T>::value, "def<>: not a stack type");
+      static void push(rpn::Stack &s, T &&v) { s.push(std::make_unique<T>(std::move(v))); }
+    };
+    template<> struct Push<double> {
+      static void push(rpn::Stack &s, double v) { s.push_double(v); }
+    };
+    template<> struct Push<int64_t> {
+      static void push(rpn::Stack &s, int64_t v) { s.push_integer(v); }
+    };
+    template<> struct Push<bool> {
+      static void push(rpn::Stack &s, bool v) { s.push_boolean(v); }
+    };
+    template<> struct Push<std::string> {
+      static void push(rpn::Stack &s, const std::string &v) { s.push_string(v); }
+    };
+
+    template<typename St> inline std::string type_name() { return typeid(St).name(); }
+    template<> inline std::string type_name<StDouble>() { return "double"; }
+    template<> inline std::string type_name<StInteger>() { return "integer"; }
+    template<> inline std::string type_name<StBoolean>() { return "boolean"; }
+    template<> inline std::string type_name<StString>() { return "string"; }
+    template<> inline std::string type_name<StObject>() { return "object"; }
+    template<> inline std::string type_name<StArray>() { return "array"; }
+    template<> inline std::string type_name<StVec3>() { return "vec3"; }
+    template<> inline std::string type_name<rpn::Stack::Object>() { return "any"; }
+
+    // one per mix of types, named like the hand written ones
+    template<typename... St> const rpn::StrictTypeValidator &validator() {
+      static const rpn::StrictTypeValidator v = [] {
+	std::vector<size_t> types = { rpn::type_tag<St>()... };
+	std::vector<std::string> names = { type_name<St>()... };
+	std::reverse(types.begin(), types.end()); // top of stack first
+	std::reverse(names.begin(), names.end());
+	std::string name = "d" + std::to_string(sizeof...(St));
+	for(const auto &n : names) {
+	  name += "_" + n;
+	}
+	return rpn::StrictTypeValidator(types, name);
+      }();
+      return v;
+    }
+
+    template<typename R, typename G>
+    rpn::WordDefinition::Result finish(rpn::Stack &s, const G &call) {
+      if constexpr (std::is_void<R>::value) {
+	call();
+	return rpn::WordDefinition::Result::ok;
+      } else if constexpr (std::is_same<R, rpn::WordDefinition::Result>::value) {
+	return call();
+      } else {
+	Push<std::decay_t<R>>::push(s, call());
+	return rpn::WordDefinition::Result::ok;
+      }
+    }
+
+    template<typename Sig> struct Call;
+    template<typename R, typename... A> struct Call<R(A...)> {
+      using Params = List<A...>;
+      template<typename... St, typename F, size_t... I>
+      static rpn::WordDefinition::Result run(rpn::Interp &rpn, const F &fn, std::unique_ptr<rpn::Stack::Object> *held, std::index_sequence<I...>) {
+	return finish<R>(rpn.stack, [&]() -> R { return fn(Param<std::decay_t<A>>::template get<St>(*held[I])...); });
+      }
+    };
+    template<typename R, typename... A> struct Call<R(rpn::Interp&, A...)> {
+      using Params = List<A...>;
+      template<typename... St, typename F, size_t... I>
+      static rpn::WordDefinition::Result run(rpn::Interp &rpn, const F &fn, std::unique_ptr<rpn::Stack::Object> *held, std::index_sequence<I...>) {
+	return finish<R>(rpn.stack, [&]() -> R { return fn(rpn, Param<std::decay_t<A>>::template get<St>(*held[I])...); });
+      }
+    };
+
+    // the validator has already said what St... are
+    template<typename Sig, typename F, typename... St>
+    rpn::WordDefinition::Result thunk(rpn::Interp &rpn, const F &fn) {
+      const size_t n = sizeof...(St);
+      std::unique_ptr<rpn::Stack::Object> held[n + 1]; // never zero sized
+      for(size_t i=n; i>0; i--) {
+	held[i-1] = rpn.stack.pop();
+      }
+      rpn::WordDefinition::Result rv = Call<Sig>::template run<St...>(rpn, fn, held, std::index_sequence_for<St...>());
+      if (rv != rpn::WordDefinition::Result::ok) {
+	for(size_t i=0; i<n; i++) {
+	  rpn.stack.push(std::move(held[i]));
+	}
+      }
+      return rv;
+    }
+
+    // a definition for each mix of the types the parameters accept
+    template<typename Sig, typename F, typename Params, typename Chosen> struct Overloads;
+    template<typename Sig, typename F, typename... St>
+    struct Overloads<Sig, F, List<>, List<St...>> {
+      static void add(std::vector<rpn::WordDefinition> &defs, const F &fn) {
+	defs.push_back({ validator<St...>(), [fn](rpn::Interp &rpn, rpn::WordContext *, std::string &) {
+	      return thunk<Sig, F, St...>(rpn, fn);
+	    }, nullptr });
+      }
+    };
+    template<typename Sig, typename F, typename P, typename... Ps, typename... St>
+    struct Overloads<Sig, F, List<P, Ps...>, List<St...>> {
+      template<typename... A>
+      static void each(std::vector<rpn::WordDefinition> &defs, const F &fn, List<A...>) {
+	(Overloads<Sig, F, List<Ps...>, List<St..., A>>::add(defs, fn), ...);
+      }
+      static void add(std::vector<rpn::WordDefinition> &defs, const F &fn) {
+	each(defs, fn, typename Param<std::decay_t<P>>::Accepts());
+      }
+    };
+  }
+}
+
+template<typename Sig, typename F>
+bool
+rpn::Interp::def(const std::string &word, F fn) {
+  std::vector<rpn::WordDefinition> defs;
+  native::Overloads<Sig, F, typename native::Call<Sig>::Params, native::List<>>::add(defs, fn);
+  for(const auto &d : defs) {
+    addNative(word, d);
+  }
+  return true;
+}
+
 // convenience macros for adding native methods
 #define NATIVE_WORD_FN(mangler, op) mangler##_func_##op
 
 #define NATIVE_WORD_DECL(mangler, fn) \
-  static rpn::WordDefinition::Result NATIVE_WORD_FN(mangler, fn)(rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  static rpn::WordDefinition::Result NATIVE_WORD_FN(mangler, fn)([[maybe_unused]] rpn::Interp &rpn, [[maybe_unused]] rpn::WordContext *ctx, [[maybe_unused]] std::string &rest)
    
 #define NATIVE_WORD_FN_0_DOUBLE(mangler, fn, val) \
   NATIVE_WORD_DECL(mangler, fn) {					\
@@ -660,4 +1250,13 @@ public:
   r.addDefinition(symbol, NATIVE_WORD_WDEF(mangler, rpn::StrictTypeValidator::d3_integer_integer_double, double_func, ptr)); \
   r.addDefinition(symbol, NATIVE_WORD_WDEF(mangler, rpn::StrictTypeValidator::d3_integer_integer_integer, integer_func, ptr))
 
+// the entry point of a shared object dictionary, loaded with LOAD-DICT or
+// Interp::loadDictionary():
+//   RPN_DICTIONARY(rpn) { rpn.def<double(double)>("CUBE", cube); }
+#if defined(_MSC_VER)
+#define RPN_DICTIONARY(rpn) extern "C" __declspec(dllexport) void rpn_add_words(rpn::Interp &rpn)
+#else
+#define RPN_DICTIONARY(rpn) extern "C" __attribute__((visibility("default"))) void rpn_add_words(rpn::Interp &rpn)
+#endif
+
 /* end of qinc/rpn-lang/rpn.h */
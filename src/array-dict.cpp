@@ -0,0 +1,263 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/array-dict.cpp
+ *
+ * @file    array-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "timecode.h"
+
+#include <cmath>
+#include <thread>
+#include <typeinfo>
+#include <algorithm>
+#include <string_view>
+
+using StTimecode = stack::Timecode;
+using Elements = StArray::Elements;
+
+/***************************************************
+ * sorting
+ *
+ * the virtual Object::operator< is a dynamic_cast per compare, so
+ * homogeneous arrays are sorted on keys pulled out up front: integer,
+ * double (mixed numbers too), string, or frame count for timecodes at a
+ * single rate.  anything else falls back to operator<.
+ *
+ * keyed sorts go parallel above sk_parallelSort elements: each thread
+ * stable sorts a run, then the runs are merged pairwise.  all sorts are
+ * stable.
+ */
+static const size_t sk_parallelSort = 1 << 16;
+
+template<typename T, typename Less>
+static void
+parallel_sort(std::vector<T> &v, Less less) {
+  size_t n = v.size();
+  size_t runs = 1;
+  for(unsigned hw = std::thread::hardware_concurrency(); runs*2 <= hw; runs *= 2);
+  if (n < sk_parallelSort || runs < 2) {
+    std::stable_sort(v.begin(), v.end(), less);
+    return;
+  }
+
+  std::vector<size_t> bounds;
+  for(size_t i=0; i<=runs; i++) {
+    bounds.push_back(n * i / runs);
+  }
+  {
+    std::vector<std::thread> workers;
+    for(size_t i=0; i<runs; i++) {
+      workers.emplace_back([&v, &bounds, less, i]() {
+	std::stable_sort(v.begin()+bounds[i], v.begin()+bounds[i+1], less);
+      });
+    }
+    for(auto &w : workers) w.join();
+  }
+  for(size_t width=1; width<runs; width*=2) {
+    std::vector<std::thread> workers;
+    for(size_t i=0; i+width<runs; i+=2*width) {
+      auto b = v.begin()+bounds[i];
+      auto m = v.begin()+bounds[i+width];
+      auto e = v.begin()+bounds[std::min(i+2*width, runs)];
+      workers.emplace_back([b, m, e, less]() { std::inplace_merge(b, m, e, less); });
+    }
+    for(auto &w : workers) w.join();
+  }
+}
+
+// NaNs sort after every number
+static bool
+less_double(double a, double b) {
+  return std::isnan(b) ? !std::isnan(a) : a < b;
+}
+
+// reorders v by the (key, index) pairs
+template<typename K, typename Less>
+static void
+sort_keyed(Elements &v, std::vector<std::pair<K,size_t>> &keys, bool descending, Less less) {
+  if (descending) {
+    parallel_sort(keys, [less](const auto &a, const auto &b) { return less(b.first, a.first); });
+  } else {
+    parallel_sort(keys, [less](const auto &a, const auto &b) { return less(a.first, b.first); });
+  }
+  Elements sorted;
+  sorted.reserve(v.size());
+  for(auto const &k : keys) {
+    sorted.push_back(std::move(v[k.second]));
+  }
+  v = std::move(sorted);
+}
+
+enum class KeyKind { integer, real, string, frames, generic };
+
+// what keys the sort subjects can share
+static KeyKind
+key_kind(const std::vector<const rpn::Stack::Object*> &subjects) {
+  bool integer = true, real = true, string = true, frames = true;
+  const q::Fraction *rate = nullptr;
+  for(const auto *s : subjects) {
+    auto t = s->tag();
+    bool isInt = (t == rpn::tt_integer);
+    integer &= isInt;
+    real &= isInt || (t == rpn::tt_double);
+    string &= (t == rpn::tt_string);
+    if (frames && t == rpn::type_tag<StTimecode>()) {
+      const auto &tc = static_cast<const StTimecode&>(*s);
+      frames = (rate == nullptr || tc._frameRate == *rate);
+      rate = &tc._frameRate;
+    } else {
+      frames = false;
+    }
+  }
+  return (integer ? KeyKind::integer :
+	  real ? KeyKind::real :
+	  string ? KeyKind::string :
+	  frames ? KeyKind::frames : KeyKind::generic);
+}
+
+template<typename K, typename Get>
+static std::vector<std::pair<K,size_t>>
+extract(const std::vector<const rpn::Stack::Object*> &subjects, Get get) {
+  std::vector<std::pair<K,size_t>> keys;
+  keys.reserve(subjects.size());
+  for(size_t i=0; i<subjects.size(); i++) {
+    keys.emplace_back(get(*subjects[i]), i);
+  }
+  return keys;
+}
+
+// sorts v by subjects[i], which belong to v[i].  throws if the subjects
+// can't be compared
+static void
+sort_subjects(Elements &v, const std::vector<const rpn::Stack::Object*> &subjects, bool descending) {
+  switch(key_kind(subjects)) {
+  case KeyKind::integer: {
+    auto keys = extract<int64_t>(subjects, [](const rpn::Stack::Object &o) { return int64_t(static_cast<const StInteger&>(o)); });
+    sort_keyed(v, keys, descending, std::less<int64_t>());
+  } break;
+  case KeyKind::real: {
+    auto keys = extract<double>(subjects, [](const rpn::Stack::Object &o) { return double(o); });
+    sort_keyed(v, keys, descending, less_double);
+  } break;
+  case KeyKind::string: {
+    auto keys = extract<std::string_view>(subjects, [](const rpn::Stack::Object &o) { return std::string_view(static_cast<const StString&>(o).val()); });
+    sort_keyed(v, keys, descending, std::less<std::string_view>());
+  } break;
+  case KeyKind::frames: {
+    auto keys = extract<int64_t>(subjects, [](const rpn::Stack::Object &o) { return static_cast<const StTimecode&>(o).to_frames(); });
+    sort_keyed(v, keys, descending, std::less<int64_t>());
+  } break;
+  case KeyKind::generic: {
+    // operator< may throw, so this stays on one thread
+    auto keys = extract<const rpn::Stack::Object*>(subjects, [](const rpn::Stack::Object &o) { return &o; });
+    auto less = [](const rpn::Stack::Object *a, const rpn::Stack::Object *b) {
+      if (a->tag() != b->tag()) {
+	throw std::runtime_error("sort: mixed types");
+      }
+      return *a < *b;
+    };
+    if (descending) {
+      std::stable_sort(keys.begin(), keys.end(), [less](const auto &a, const auto &b) { return less(b.first, a.first); });
+    } else {
+      std::stable_sort(keys.begin(), keys.end(), [less](const auto &a, const auto &b) { return less(a.first, b.first); });
+    }
+    Elements sorted;
+    sorted.reserve(v.size());
+    for(auto const &k : keys) {
+      sorted.push_back(std::move(v[k.second]));
+    }
+    v = std::move(sorted);
+  } break;
+  }
+}
+
+static rpn::WordDefinition::Result
+sort_array(rpn::Interp &rpn, bool descending) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto arr = rpn.stack.pop();
+  auto v = PEEK_CAST(StArray,*arr).release();
+  std::vector<const rpn::Stack::Object*> subjects;
+  subjects.reserve(v.size());
+  for(auto const &e : v) {
+    subjects.push_back(e.get());
+  }
+  try {
+    sort_subjects(v, subjects, descending);
+  } catch (const std::exception &e) {
+    printf("%s\n", e.what());
+    rv = rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(v)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(array, sort) {
+  return sort_array(rpn, false);
+}
+
+NATIVE_WORD_DECL(array, sort_desc) {
+  return sort_array(rpn, true);
+}
+
+// ( [objects] "key" -- [objects'] ) every object needs the key
+NATIVE_WORD_DECL(array, sort_by) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  std::string key = rpn.stack.peek_string(1);
+  for(auto const &e : PEEK_CAST(const StArray,rpn.stack.peek_const(2)).val()) {
+    auto *obj = dynamic_cast<const StObject*>(e.get());
+    if (obj == nullptr || !obj->has_member(key)) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+  }
+  rpn.stack.pop();
+  auto arr = rpn.stack.pop();
+  auto v = PEEK_CAST(StArray,*arr).release();
+  std::vector<const rpn::Stack::Object*> subjects;
+  subjects.reserve(v.size());
+  for(auto const &e : v) {
+    subjects.push_back(&static_cast<const StObject&>(*e).member(key));
+  }
+  try {
+    sort_subjects(v, subjects, false);
+  } catch (const std::exception &e) {
+    printf("%s\n", e.what());
+    rv = rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(v)));
+  if (rv != rpn::WordDefinition::Result::ok) {
+    rpn.stack.push_string(key);
+  }
+  return rv;
+}
+
+// drops runs of equal elements, like uniq(1); SORT first for distinct values
+NATIVE_WORD_DECL(array, uniq) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto arr = rpn.stack.pop();
+  auto v = PEEK_CAST(StArray,*arr).release();
+  auto same = [](const std::unique_ptr<rpn::Stack::Object> &a, const std::unique_ptr<rpn::Stack::Object> &b) {
+    return a->tag() == b->tag() && *a == *b;
+  };
+  v.erase(std::unique(v.begin(), v.end(), same), v.end());
+  rpn.stack.push(std::make_unique<StArray>(std::move(v)));
+  return rv;
+}
+
+void
+rpn::Interp::addArrayWords() {
+  addDefinition("SORT", NATIVE_WORD_WDEF(array, rpn::StrictTypeValidator::d1_array, sort, nullptr));
+  addDefinition("SORT-DESC", NATIVE_WORD_WDEF(array, rpn::StrictTypeValidator::d1_array, sort_desc, nullptr));
+  addDefinition("SORT-BY", NATIVE_WORD_WDEF(array, rpn::StrictTypeValidator::d2_string_array, sort_by, nullptr));
+  addDefinition("UNIQ", NATIVE_WORD_WDEF(array, rpn::StrictTypeValidator::d1_array, uniq, nullptr));
+}
+
+/* end of qinc/rpn-lang/src/array-dict.cpp */
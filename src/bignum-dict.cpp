@@ -0,0 +1,288 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/bignum-dict.cpp
+ *
+ * @file    bignum-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "bignum.h"
+
+using StBigInt = stack::BigInt;
+using StBigFraction = stack::BigFraction;
+using StFraction = stack::Fraction;
+
+void
+stack::push_exact(rpn::Stack &s, q::BigInt &&v) {
+  if (v.fits_int64()) {
+    s.push_integer(v.to_int64());
+  } else {
+    s.push(std::make_unique<StBigInt>(std::move(v)));
+  }
+}
+
+void
+stack::push_exact(rpn::Stack &s, q::BigRational &&v) {
+  if (v.n.fits_int64() && v.d.fits_int64()) {
+    s.push(StFraction(v.n.to_int64(), v.d.to_int64()));
+  } else {
+    s.push(std::make_unique<StBigFraction>(std::move(v)));
+  }
+}
+
+// Integer, BigInt, Fraction or BigFraction
+static q::BigRational
+rational(const rpn::Stack::Object &o) {
+  if (o.tag() == rpn::type_tag<StBigFraction>()) {
+    return static_cast<const StBigFraction&>(o).val();
+  }
+  if (o.tag() == rpn::type_tag<StFraction>()) {
+    const auto &f = static_cast<const StFraction&>(o);
+    return q::BigRational(q::BigInt(f._numerator), q::BigInt(f._denominator));
+  }
+  return q::BigRational(StBigInt::val(o), q::BigInt(1));
+}
+
+/****************************************
+ * integers
+ */
+#define BIGNUM_BINARY_FUNC(name, op)					\
+  NATIVE_WORD_DECL(bignum, name) {					\
+    rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;	\
+    auto o2 = rpn.stack.pop();						\
+    auto o1 = rpn.stack.pop();						\
+    stack::push_exact(rpn.stack, StBigInt::val(*o1) op StBigInt::val(*o2)); \
+    return rv;								\
+  }
+
+BIGNUM_BINARY_FUNC(add, +);
+BIGNUM_BINARY_FUNC(subtract, -);
+BIGNUM_BINARY_FUNC(multiply, *);
+
+// truncates like Integer /
+NATIVE_WORD_DECL(bignum, divide) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::BigInt d = StBigInt::val(rpn.stack.peek_const(1));
+  if (d.is_zero()) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  auto o1 = rpn.stack.pop();
+  stack::push_exact(rpn.stack, StBigInt::val(*o1) / d);
+  return rv;
+}
+
+// anything with a Double in it is a Double
+#define BIGNUM_DOUBLE_FUNC(name, op)					\
+  NATIVE_WORD_DECL(bignum, name##_d) {					\
+    rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;	\
+    double d2 = rpn.stack.pop_as_double();				\
+    double d1 = rpn.stack.pop_as_double();				\
+    rpn.stack.push_double(d1 op d2);					\
+    return rv;								\
+  }
+
+BIGNUM_DOUBLE_FUNC(add, +);
+BIGNUM_DOUBLE_FUNC(subtract, -);
+BIGNUM_DOUBLE_FUNC(multiply, *);
+BIGNUM_DOUBLE_FUNC(divide, /);
+
+// ( b e -- b^e ) e not negative
+NATIVE_WORD_DECL(bignum, pow) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  int64_t e = rpn.stack.peek_integer(1);
+  const auto &b = PEEK_CAST(const StBigInt,rpn.stack.peek_const(2)).val();
+  if (e < 0 || double(b.bits()) * double(e) > double(q::BigInt::k_maxPowBits)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  q::BigInt p = b.pow(uint64_t(e));
+  rpn.stack.pop();
+  rpn.stack.pop();
+  stack::push_exact(rpn.stack, std::move(p));
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, sq) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ob = rpn.stack.pop();
+  const auto &b = POP_CAST(StBigInt,ob).val();
+  stack::push_exact(rpn.stack, b * b);
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, chs) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ob = rpn.stack.pop();
+  stack::push_exact(rpn.stack, -POP_CAST(StBigInt,ob).val());
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, to_float) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn.stack.push_double(rpn.stack.pop_as_double());
+  return rv;
+}
+
+/****************************************
+ * fractions
+ */
+// ( n d -- n/d ) either or both a BigInt
+NATIVE_WORD_DECL(bignum, to_frac) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::BigInt d = StBigInt::val(rpn.stack.peek_const(1));
+  if (d.is_zero()) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  auto on = rpn.stack.pop();
+  stack::push_exact(rpn.stack, q::BigRational(StBigInt::val(*on), d));
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, frac_to) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto of = rpn.stack.pop();
+  q::BigRational f = POP_CAST(StBigFraction,of).val();
+  stack::push_exact(rpn.stack, std::move(f.n));
+  stack::push_exact(rpn.stack, std::move(f.d));
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, frac_neg) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto of = rpn.stack.pop();
+  const auto &f = POP_CAST(StBigFraction,of).val();
+  stack::push_exact(rpn.stack, q::BigRational(-f.n, f.d));
+  return rv;
+}
+
+NATIVE_WORD_DECL(bignum, frac_inv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto of = rpn.stack.pop();
+  const auto &f = POP_CAST(StBigFraction,of).val();
+  stack::push_exact(rpn.stack, q::BigRational(f.d, f.n));
+  return rv;
+}
+
+#define BIGNUM_RATIONAL_FUNC(name, op)					\
+  NATIVE_WORD_DECL(bignum, name##_q) {					\
+    rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;	\
+    auto o2 = rpn.stack.pop();						\
+    auto o1 = rpn.stack.pop();						\
+    stack::push_exact(rpn.stack, rational(*o1) op rational(*o2));	\
+    return rv;								\
+  }
+
+BIGNUM_RATIONAL_FUNC(add, +);
+BIGNUM_RATIONAL_FUNC(subtract, -);
+BIGNUM_RATIONAL_FUNC(multiply, *);
+
+NATIVE_WORD_DECL(bignum, divide_q) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::BigRational d = rational(rpn.stack.peek_const(1));
+  if (d.n.is_zero()) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  auto o1 = rpn.stack.pop();
+  stack::push_exact(rpn.stack, rational(*o1) / d);
+  return rv;
+}
+
+void
+rpn::Interp::addBignumWords() {
+  rpn::Interp &rpn = *this; // in case we want to move this out someday
+
+  for(auto v : { &bignum_validator::d2_bigint_bigint, &bignum_validator::d2_bigint_integer, &bignum_validator::d2_integer_bigint }) {
+    rpn.addDefinition("+", NATIVE_WORD_WDEF(bignum, *v, add, nullptr));
+    rpn.addDefinition("-", NATIVE_WORD_WDEF(bignum, *v, subtract, nullptr));
+    rpn.addDefinition("*", NATIVE_WORD_WDEF(bignum, *v, multiply, nullptr));
+    rpn.addDefinition("/", NATIVE_WORD_WDEF(bignum, *v, divide, nullptr));
+    rpn.addDefinition("->FRAC", NATIVE_WORD_WDEF(bignum, *v, to_frac, nullptr));
+  }
+  for(auto v : { &bignum_validator::d2_bigint_double, &bignum_validator::d2_double_bigint }) {
+    rpn.addDefinition("+", NATIVE_WORD_WDEF(bignum, *v, add_d, nullptr));
+    rpn.addDefinition("-", NATIVE_WORD_WDEF(bignum, *v, subtract_d, nullptr));
+    rpn.addDefinition("*", NATIVE_WORD_WDEF(bignum, *v, multiply_d, nullptr));
+    rpn.addDefinition("/", NATIVE_WORD_WDEF(bignum, *v, divide_d, nullptr));
+  }
+  rpn.addDefinition("^", NATIVE_WORD_WDEF(bignum, bignum_validator::d2_integer_bigint, pow, nullptr));
+  rpn.addDefinition("SQ", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigint, sq, nullptr));
+  rpn.addDefinition("CHS", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigint, chs, nullptr));
+  rpn.addDefinition("->FLOAT", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigint, to_float, nullptr));
+
+  rpn.addDefinition("->FLOAT", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigfrac, to_float, nullptr));
+  rpn.addDefinition("OBJ->", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigfrac, frac_to, nullptr));
+  rpn.addDefinition("NEG", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigfrac, frac_neg, nullptr));
+  rpn.addDefinition("INV", NATIVE_WORD_WDEF(bignum, bignum_validator::d1_bigfrac, frac_inv, nullptr));
+  for(auto v : { &bignum_validator::d2_integer_bigfrac, &bignum_validator::d2_bigfrac_integer,
+	&bignum_validator::d2_bigint_bigfrac, &bignum_validator::d2_bigfrac_bigint,
+	&bignum_validator::d2_frac_bigfrac, &bignum_validator::d2_bigfrac_frac,
+	&bignum_validator::d2_bigfrac_bigfrac,
+	&bignum_validator::d2_frac_bigint, &bignum_validator::d2_bigint_frac }) {
+    rpn.addDefinition("+", NATIVE_WORD_WDEF(bignum, *v, add_q, nullptr));
+    rpn.addDefinition("-", NATIVE_WORD_WDEF(bignum, *v, subtract_q, nullptr));
+    rpn.addDefinition("*", NATIVE_WORD_WDEF(bignum, *v, multiply_q, nullptr));
+    rpn.addDefinition("/", NATIVE_WORD_WDEF(bignum, *v, divide_q, nullptr));
+  }
+}
+
+// two BigInts compare without going through the virtuals
+static bool
+bigint_equal(const rpn::Stack::Object &a, const rpn::Stack::Object &b) {
+  return static_cast<const StBigInt&>(a).val() == static_cast<const StBigInt&>(b).val();
+}
+
+static bool
+bigint_less(const rpn::Stack::Object &a, const rpn::Stack::Object &b) {
+  return static_cast<const StBigInt&>(a).val() < static_cast<const StBigInt&>(b).val();
+}
+
+static const size_t sk_bigint = rpn::TypeRegistry::add<StBigInt>("BigInt", { bigint_equal, bigint_less });
+static const size_t sk_bigfrac = rpn::TypeRegistry::add<StBigFraction>("BigFraction");
+
+const rpn::StrictTypeValidator bignum_validator::d1_bigint({sk_bigint}, "d1_bigint");
+const rpn::StrictTypeValidator bignum_validator::d1_bigfrac({sk_bigfrac}, "d1_bigfrac");
+const rpn::StrictTypeValidator bignum_validator::d2_bigint_bigint({sk_bigint,sk_bigint}, "d2_bigint_bigint");
+const rpn::StrictTypeValidator bignum_validator::d2_bigint_integer({sk_bigint,rpn::type_tag<StInteger>()}, "d2_bigint_integer");
+const rpn::StrictTypeValidator bignum_validator::d2_integer_bigint({rpn::type_tag<StInteger>(),sk_bigint}, "d2_integer_bigint");
+const rpn::StrictTypeValidator bignum_validator::d2_bigint_double({sk_bigint,rpn::type_tag<StDouble>()}, "d2_bigint_double");
+const rpn::StrictTypeValidator bignum_validator::d2_double_bigint({rpn::type_tag<StDouble>(),sk_bigint}, "d2_double_bigint");
+const rpn::StrictTypeValidator bignum_validator::d2_integer_bigfrac({rpn::type_tag<StInteger>(),sk_bigfrac}, "d2_integer_bigfrac");
+const rpn::StrictTypeValidator bignum_validator::d2_bigfrac_integer({sk_bigfrac,rpn::type_tag<StInteger>()}, "d2_bigfrac_integer");
+const rpn::StrictTypeValidator bignum_validator::d2_bigint_bigfrac({sk_bigint,sk_bigfrac}, "d2_bigint_bigfrac");
+const rpn::StrictTypeValidator bignum_validator::d2_bigfrac_bigint({sk_bigfrac,sk_bigint}, "d2_bigfrac_bigint");
+const rpn::StrictTypeValidator bignum_validator::d2_frac_bigfrac({rpn::type_tag<StFraction>(),sk_bigfrac}, "d2_frac_bigfrac");
+const rpn::StrictTypeValidator bignum_validator::d2_bigfrac_frac({sk_bigfrac,rpn::type_tag<StFraction>()}, "d2_bigfrac_frac");
+const rpn::StrictTypeValidator bignum_validator::d2_bigfrac_bigfrac({sk_bigfrac,sk_bigfrac}, "d2_bigfrac_bigfrac");
+const rpn::StrictTypeValidator bignum_validator::d2_frac_bigint({rpn::type_tag<StFraction>(),sk_bigint}, "d2_frac_bigint");
+const rpn::StrictTypeValidator bignum_validator::d2_bigint_frac({sk_bigint,rpn::type_tag<StFraction>()}, "d2_bigint_frac");
+
+static q::BigInt
+read_bigint(rpn::ImageReader &r) {
+  bool neg = r.u8() != 0;
+  q::BigInt::Limbs mag(r.u32());
+  for(auto &l : mag) {
+    l = r.u32();
+  }
+  return q::BigInt(neg, std::move(mag));
+}
+
+static const bool sk_bigintImage = rpn::ImageReader::addType("BigInt", [](rpn::ImageReader &r) {
+    return std::make_unique<StBigInt>(read_bigint(r));
+  });
+
+static const bool sk_bigfracImage = rpn::ImageReader::addType("BigFraction", [](rpn::ImageReader &r) {
+    q::BigInt n = read_bigint(r);
+    q::BigInt d = read_bigint(r);
+    return std::make_unique<StBigFraction>(q::BigRational(n, d));
+  });
+
+/* end of qinc/rpn-lang/src/bignum-dict.cpp */
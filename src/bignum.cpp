@@ -0,0 +1,691 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/bignum.cpp
+ *
+ * @file    bignum.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "bignum.h"
+
+#include <cmath>
+#include <algorithm>
+
+using Limb = q::BigInt::Limb;
+using Limbs = q::BigInt::Limbs;
+
+/****************************************
+ * magnitudes
+ *
+ * unsigned, least significant limb first.  everything is done a limb
+ * at a time with 64 bit intermediates so there's no need for a 128 bit
+ * type
+ */
+static void
+trim(Limbs &a) {
+  while (!a.empty() && a.back() == 0) {
+    a.pop_back();
+  }
+}
+
+static int
+compare(const Limb *a, size_t na, const Limb *b, size_t nb) {
+  if (na != nb) {
+    return (na < nb) ? -1 : 1;
+  }
+  for(size_t i=na; i-- > 0; ) {
+    if (a[i] != b[i]) {
+      return (a[i] < b[i]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+static int
+compare(const Limbs &a, const Limbs &b) {
+  return compare(a.data(), a.size(), b.data(), b.size());
+}
+
+static Limbs
+add(const Limb *a, size_t na, const Limb *b, size_t nb) {
+  if (na < nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  Limbs rv(na+1);
+  uint64_t carry = 0;
+  for(size_t i=0; i<na; i++) {
+    carry += uint64_t(a[i]) + ((i < nb) ? b[i] : 0);
+    rv[i] = Limb(carry);
+    carry >>= 32;
+  }
+  rv[na] = Limb(carry);
+  trim(rv);
+  return rv;
+}
+
+static Limbs
+add(const Limbs &a, const Limbs &b) {
+  return add(a.data(), a.size(), b.data(), b.size());
+}
+
+// a -= b in place, a has to be at least b
+static void
+subtract_in(Limb *a, size_t na, const Limb *b, size_t nb) {
+  int64_t borrow = 0;
+  for(size_t i=0; i<na; i++) {
+    int64_t t = int64_t(a[i]) - ((i < nb) ? b[i] : 0) - borrow;
+    borrow = (t < 0) ? 1 : 0;
+    a[i] = Limb(t);
+    if (i >= nb && borrow == 0) {
+      break;
+    }
+  }
+}
+
+static Limbs
+subtract(const Limbs &a, const Limbs &b) {
+  Limbs rv(a);
+  subtract_in(rv.data(), rv.size(), b.data(), b.size());
+  trim(rv);
+  return rv;
+}
+
+// out += a*b, out has na+nb limbs
+static void
+multiply_school(const Limb *a, size_t na, const Limb *b, size_t nb, Limb *out) {
+  for(size_t i=0; i<na; i++) {
+    uint64_t carry = 0;
+    uint64_t ai = a[i];
+    for(size_t j=0; j<nb; j++) {
+      carry += ai * b[j] + out[i+j];
+      out[i+j] = Limb(carry);
+      carry >>= 32;
+    }
+    for(size_t k=i+nb; carry != 0; k++) {
+      carry += out[k];
+      out[k] = Limb(carry);
+      carry >>= 32;
+    }
+  }
+}
+
+/*
+ * Karatsuba: with a = a1*B^m + a0 and b likewise,
+ *   a*b = z2*B^2m + (z1 - z2 - z0)*B^m + z0
+ * where z0 = a0*b0, z2 = a1*b1, and z1 = (a0+a1)(b0+b1), three half
+ * size products instead of four.  below the threshold the schoolbook
+ * loop is quicker
+ */
+static const size_t sk_karatsuba = 32;
+
+static void multiply(const Limb *a, size_t na, const Limb *b, size_t nb, Limb *out);
+
+static Limbs
+product(const Limb *a, size_t na, const Limb *b, size_t nb) {
+  Limbs rv(na+nb, 0);
+  if (na != 0 && nb != 0) {
+    multiply(a, na, b, nb, rv.data());
+  }
+  trim(rv);
+  return rv;
+}
+
+// out += a*b
+static void
+accumulate(Limb *out, size_t nout, const Limbs &v) {
+  uint64_t carry = 0;
+  size_t i = 0;
+  for(; i<v.size(); i++) {
+    carry += uint64_t(out[i]) + v[i];
+    out[i] = Limb(carry);
+    carry >>= 32;
+  }
+  for(; carry != 0 && i<nout; i++) {
+    carry += out[i];
+    out[i] = Limb(carry);
+    carry >>= 32;
+  }
+}
+
+static void
+multiply(const Limb *a, size_t na, const Limb *b, size_t nb, Limb *out) {
+  if (na < nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  size_t nout = na + nb;
+  if (nb < sk_karatsuba) {
+    multiply_school(a, na, b, nb, out);
+
+  } else if (na >= 2*nb) {
+    // lopsided, go through a in nb size pieces
+    for(size_t i=0; i<na; i+=nb) {
+      size_t n = std::min(nb, na-i);
+      accumulate(out+i, nout-i, product(a+i, n, b, nb));
+    }
+
+  } else {
+    size_t m = na / 2;
+    size_t nb0 = std::min(m, nb);
+    Limbs z0 = product(a, m, b, nb0);
+    Limbs z2 = product(a+m, na-m, b+nb0, nb-nb0);
+    Limbs sa = add(a, m, a+m, na-m);
+    Limbs sb = add(b, nb0, b+nb0, nb-nb0);
+    Limbs z1 = product(sa.data(), sa.size(), sb.data(), sb.size());
+    subtract_in(z1.data(), z1.size(), z0.data(), z0.size());
+    subtract_in(z1.data(), z1.size(), z2.data(), z2.size());
+    trim(z1);
+    accumulate(out, nout, z0);
+    accumulate(out+m, nout-m, z1);
+    accumulate(out+2*m, nout-2*m, z2);
+  }
+}
+
+static Limbs
+multiply(const Limbs &a, const Limbs &b) {
+  return product(a.data(), a.size(), b.data(), b.size());
+}
+
+// a / d, the remainder in r
+static Limbs
+divide_small(const Limbs &a, Limb d, Limb &r) {
+  Limbs rv(a.size());
+  uint64_t rem = 0;
+  for(size_t i=a.size(); i-- > 0; ) {
+    uint64_t cur = (rem << 32) | a[i];
+    rv[i] = Limb(cur / d);
+    rem = cur % d;
+  }
+  r = Limb(rem);
+  trim(rv);
+  return rv;
+}
+
+static int
+leading_zeros(Limb v) {
+  int rv = 0;
+  for(Limb bit=0x80000000u; bit != 0 && (v & bit) == 0; bit >>= 1) {
+    rv++;
+  }
+  return rv;
+}
+
+// a << s for s in [0,32), one limb longer
+static Limbs
+shift_left(const Limbs &a, int s) {
+  Limbs rv(a.size()+1, 0);
+  for(size_t i=0; i<a.size(); i++) {
+    uint64_t v = uint64_t(a[i]) << s;
+    rv[i] |= Limb(v);
+    rv[i+1] = Limb(v >> 32);
+  }
+  return rv;
+}
+
+/*
+ * Knuth's algorithm D (TAOCP 4.3.1), normalized so the divisor's top
+ * bit is set and each quotient digit guess is off by at most 2
+ */
+static void
+divide(const Limbs &a, const Limbs &b, Limbs &quotient, Limbs &remainder) {
+  if (compare(a, b) < 0) {
+    quotient.clear();
+    remainder = a;
+    return;
+  }
+  if (b.size() == 1) {
+    Limb r;
+    quotient = divide_small(a, b[0], r);
+    remainder.assign(1, r);
+    trim(remainder);
+    return;
+  }
+  int s = leading_zeros(b.back());
+  Limbs v = shift_left(b, s);
+  v.pop_back();
+  Limbs u = shift_left(a, s);
+  size_t n = v.size();
+  size_t m = u.size() - n;
+  quotient.assign(m, 0);
+  const uint64_t base = uint64_t(1) << 32;
+  for(size_t j=m; j-- > 0; ) {
+    uint64_t num = (uint64_t(u[j+n]) << 32) | u[j+n-1];
+    uint64_t qhat = num / v[n-1];
+    uint64_t rhat = num % v[n-1];
+    while (qhat >= base || qhat*v[n-2] > ((rhat << 32) | u[j+n-2])) {
+      qhat--;
+      rhat += v[n-1];
+      if (rhat >= base) {
+	break;
+      }
+    }
+    // u[j..j+n] -= qhat*v
+    int64_t k = 0;
+    int64_t t;
+    for(size_t i=0; i<n; i++) {
+      uint64_t p = qhat * v[i];
+      t = int64_t(u[i+j]) - k - int64_t(p & 0xffffffffu);
+      u[i+j] = Limb(t);
+      k = int64_t(p >> 32) - (t >> 32);
+    }
+    t = int64_t(u[j+n]) - k;
+    u[j+n] = Limb(t);
+    if (t < 0) {
+      // went one too far, add v back
+      qhat--;
+      uint64_t c = 0;
+      for(size_t i=0; i<n; i++) {
+	c += uint64_t(u[i+j]) + v[i];
+	u[i+j] = Limb(c);
+	c >>= 32;
+      }
+      u[j+n] += Limb(c);
+    }
+    quotient[j] = Limb(qhat);
+  }
+  trim(quotient);
+  remainder.assign(n, 0);
+  for(size_t i=0; i<n; i++) {
+    remainder[i] = (s == 0) ? u[i] : Limb((u[i] >> s) | (uint64_t(u[i+1]) << (32-s)));
+  }
+  trim(remainder);
+}
+
+/****************************************
+ * division by a reciprocal
+ *
+ * Knuth is quadratic, fine for one division but not for the big ones
+ * at the top of a decimal conversion.  instead, Newton's iteration
+ * builds floor(B^2n / p) out of the reciprocal of p's top half (one
+ * step doubles the good limbs, a couple of guard limbs cover the
+ * truncation) and a division becomes two Karatsuba multiplies and a
+ * correction or two (Barrett)
+ */
+static const size_t sk_newton = 48; // below this Knuth's quicker
+
+// a / B^k
+static Limbs
+shifted(const Limbs &a, size_t k) {
+  return (k >= a.size()) ? Limbs() : Limbs(a.begin()+k, a.end());
+}
+
+// B^k
+static Limbs
+unit(size_t k) {
+  Limbs rv(k+1, 0);
+  rv[k] = 1;
+  return rv;
+}
+
+static Limbs
+reciprocal(const Limbs &p) {
+  size_t n = p.size();
+  Limbs one = unit(2*n);
+  Limbs x;
+  if (n < sk_newton) {
+    Limbs r;
+    divide(one, p, x, r);
+    return x;
+  }
+  size_t h = (n+1)/2 + 2;
+  size_t drop = n - h;
+  x = reciprocal(Limbs(p.begin()+drop, p.end()));
+  x.insert(x.begin(), drop, 0);
+  // x += x*(B^2n - p*x) / B^2n
+  Limbs px = multiply(p, x);
+  if (compare(px, one) <= 0) {
+    x = add(x, shifted(multiply(x, subtract(one, px)), 2*n));
+  } else {
+    x = subtract(x, shifted(multiply(x, subtract(px, one)), 2*n));
+  }
+  // now it's only a unit or two off
+  const Limbs unity(1, 1);
+  px = multiply(p, x);
+  while (compare(px, one) > 0) {
+    x = subtract(x, unity);
+    px = subtract(px, p);
+  }
+  Limbs r = subtract(one, px);
+  while (compare(r, p) >= 0) {
+    x = add(x, unity);
+    r = subtract(r, p);
+  }
+  return x;
+}
+
+// a / p with mu = reciprocal(p), a has to be under B^2n
+static void
+divide(const Limbs &a, const Limbs &p, const Limbs &mu, Limbs &quotient, Limbs &remainder) {
+  size_t n = p.size();
+  // never too big, at most two short
+  quotient = shifted(multiply(a, mu), 2*n);
+  remainder = subtract(a, multiply(quotient, p));
+  while (compare(remainder, p) >= 0) {
+    remainder = subtract(remainder, p);
+    quotient = add(quotient, Limbs(1, 1));
+  }
+}
+
+/****************************************
+ * decimal conversion
+ *
+ * divide and conquer on powers 10^(9*2^k): a number is split in half
+ * around one of the powers, each half is converted on its own, and
+ * only the small pieces at the bottom go nine digits at a time.
+ * parsing runs the same tree the other way.  with Karatsuba doing the
+ * multiplies and the reciprocals above doing the divides both ways
+ * are well under quadratic.  the powers are kept per thread so PARFOR
+ * bodies don't share them
+ */
+static const Limb sk_chunk = 1000000000u; // 10^9
+static const size_t sk_chunkDigits = 9;
+static const size_t sk_directLimbs = 16;  // below this just divide by 10^9
+
+struct Power {
+  Limbs p;
+  Limbs mu; // reciprocal(p), made the first time it's needed
+};
+
+static Power &
+power(size_t k) {
+  thread_local std::vector<Power> s_powers;
+  if (s_powers.empty()) {
+    s_powers.push_back({ Limbs(1, sk_chunk), Limbs() });
+  }
+  while (s_powers.size() <= k) {
+    const Limbs &p = s_powers.back().p;
+    Limbs sq = multiply(p, p);
+    s_powers.push_back({ std::move(sq), Limbs() });
+  }
+  return s_powers[k];
+}
+
+static void
+to_digits(const Limbs &a, size_t width, std::string &out) {
+  if (a.size() < sk_directLimbs) {
+    std::string digits;
+    Limbs v = a;
+    while (!v.empty()) {
+      Limb r;
+      v = divide_small(v, sk_chunk, r);
+      std::string c = std::to_string(r);
+      if (!v.empty()) {
+	c.insert(0, sk_chunkDigits - c.size(), '0');
+      }
+      digits.insert(0, c);
+    }
+    if (width > digits.size()) {
+      out.append(width - digits.size(), '0');
+    }
+    out += digits;
+    return;
+  }
+  // the smallest power with a under its square
+  size_t k = 0;
+  while (power(k).p.size()*2 < a.size()) {
+    k++;
+  }
+  Power &pk = power(k);
+  if (pk.mu.empty()) {
+    pk.mu = reciprocal(pk.p);
+  }
+  Limbs hi, lo;
+  divide(a, pk.p, pk.mu, hi, lo);
+  size_t lowWidth = sk_chunkDigits << k;
+  to_digits(hi, (width > lowWidth) ? width - lowWidth : 0, out);
+  to_digits(lo, lowWidth, out);
+}
+
+static Limbs
+from_digits(const char *s, size_t n) {
+  if (n <= sk_chunkDigits * sk_directLimbs) {
+    Limbs rv;
+    for(size_t i=0; i<n; ) {
+      size_t take = std::min(sk_chunkDigits, n-i);
+      Limb mul = 1;
+      Limb chunk = 0;
+      for(size_t j=0; j<take; j++) {
+	mul *= 10;
+	chunk = chunk*10 + Limb(s[i+j]-'0');
+      }
+      uint64_t carry = chunk;
+      for(auto &l : rv) {
+	carry += uint64_t(l) * mul;
+	l = Limb(carry);
+	carry >>= 32;
+      }
+      if (carry != 0) {
+	rv.push_back(Limb(carry));
+      }
+      i += take;
+    }
+    trim(rv);
+    return rv;
+  }
+  size_t k = 0;
+  while ((sk_chunkDigits << (k+1)) < n) {
+    k++;
+  }
+  size_t lowWidth = sk_chunkDigits << k;
+  Limbs hi = from_digits(s, n - lowWidth);
+  Limbs lo = from_digits(s + n - lowWidth, lowWidth);
+  return add(multiply(hi, power(k).p), lo);
+}
+
+/****************************************
+ * BigInt
+ */
+q::BigInt::BigInt(int64_t v) : _neg(v < 0) {
+  uint64_t m = _neg ? (~uint64_t(v) + 1) : uint64_t(v);
+  while (m != 0) {
+    _mag.push_back(Limb(m));
+    m >>= 32;
+  }
+}
+
+q::BigInt::BigInt(bool negative, Limbs &&mag) : _mag(std::move(mag)) {
+  trim(_mag);
+  _neg = negative && !_mag.empty();
+}
+
+bool
+q::BigInt::parse(const std::string &s, q::BigInt &out) {
+  size_t start = (!s.empty() && s[0] == '-') ? 1 : 0;
+  if (s.size() == start) {
+    return false;
+  }
+  for(size_t i=start; i<s.size(); i++) {
+    if (s[i] < '0' || s[i] > '9') {
+      return false;
+    }
+  }
+  out = q::BigInt(start == 1, from_digits(s.data()+start, s.size()-start));
+  return true;
+}
+
+std::string
+q::BigInt::to_string() const {
+  if (_mag.empty()) {
+    return "0";
+  }
+  std::string rv = _neg ? "-" : "";
+  to_digits(_mag, 0, rv);
+  return rv;
+}
+
+size_t
+q::BigInt::bits() const {
+  return _mag.empty() ? 0 : 32*_mag.size() - size_t(leading_zeros(_mag.back()));
+}
+
+bool
+q::BigInt::fits_int64() const {
+  if (_mag.size() <= 1) {
+    return true;
+  }
+  if (_mag.size() > 2) {
+    return false;
+  }
+  uint64_t m = (uint64_t(_mag[1]) << 32) | _mag[0];
+  return m <= (_neg ? (uint64_t(1) << 63) : uint64_t(std::numeric_limits<int64_t>::max()));
+}
+
+int64_t
+q::BigInt::to_int64() const {
+  uint64_t m = 0;
+  for(size_t i=std::min<size_t>(_mag.size(), 2); i-- > 0; ) {
+    m = (m << 32) | _mag[i];
+  }
+  return _neg ? int64_t(~m + 1) : int64_t(m);
+}
+
+// the top three limbs have more bits than a double keeps, the rest go in e
+static double
+scaled(const q::BigInt &v, int &e) {
+  const Limbs &l = v.limbs();
+  size_t low = (l.size() > 3) ? l.size()-3 : 0;
+  double rv = 0.;
+  for(size_t i=l.size(); i-- > low; ) {
+    rv = rv * 4294967296. + l[i];
+  }
+  e = int(32*low);
+  return v.negative() ? -rv : rv;
+}
+
+q::BigInt::operator double() const {
+  int e;
+  double m = scaled(*this, e);
+  return std::ldexp(m, e);
+}
+
+int
+q::BigInt::compare(const q::BigInt &rhs) const {
+  if (_neg != rhs._neg) {
+    return _neg ? -1 : 1;
+  }
+  int c = ::compare(_mag, rhs._mag);
+  return _neg ? -c : c;
+}
+
+q::BigInt
+q::BigInt::operator-() const {
+  return q::BigInt(!_neg, Limbs(_mag));
+}
+
+q::BigInt
+q::BigInt::operator+(const q::BigInt &rhs) const {
+  if (_neg == rhs._neg) {
+    return q::BigInt(_neg, add(_mag, rhs._mag));
+  }
+  // different signs, the bigger magnitude wins
+  if (::compare(_mag, rhs._mag) >= 0) {
+    return q::BigInt(_neg, subtract(_mag, rhs._mag));
+  }
+  return q::BigInt(rhs._neg, subtract(rhs._mag, _mag));
+}
+
+q::BigInt
+q::BigInt::operator-(const q::BigInt &rhs) const {
+  return *this + (-rhs);
+}
+
+q::BigInt
+q::BigInt::operator*(const q::BigInt &rhs) const {
+  return q::BigInt(_neg != rhs._neg, multiply(_mag, rhs._mag));
+}
+
+void
+q::BigInt::divide(const q::BigInt &n, const q::BigInt &d, q::BigInt &quotient, q::BigInt &remainder) {
+  Limbs qm, rm;
+  ::divide(n._mag, d._mag, qm, rm);
+  quotient = q::BigInt(n._neg != d._neg, std::move(qm));
+  remainder = q::BigInt(n._neg, std::move(rm));
+}
+
+q::BigInt
+q::BigInt::operator/(const q::BigInt &rhs) const {
+  q::BigInt quotient, remainder;
+  divide(*this, rhs, quotient, remainder);
+  return quotient;
+}
+
+q::BigInt
+q::BigInt::pow(uint64_t e) const {
+  q::BigInt rv(1);
+  q::BigInt b(*this);
+  while (e != 0) {
+    if (e & 1) {
+      rv = rv * b;
+    }
+    e >>= 1;
+    if (e != 0) {
+      b = b * b;
+    }
+  }
+  return rv;
+}
+
+q::BigInt
+q::BigInt::gcd(const q::BigInt &a, const q::BigInt &b) {
+  Limbs x = a._mag;
+  Limbs y = b._mag;
+  while (!y.empty()) {
+    Limbs qm, rm;
+    ::divide(x, y, qm, rm);
+    x = std::move(y);
+    y = std::move(rm);
+  }
+  return q::BigInt(false, std::move(x));
+}
+
+/****************************************
+ * BigRational
+ */
+q::BigRational::BigRational(const q::BigInt &num, const q::BigInt &den) : n(num), d(den) {
+  if (d.negative()) {
+    n = -n;
+    d = -d;
+  }
+  q::BigInt g = q::BigInt::gcd(n, d);
+  if (g != q::BigInt(1) && !g.is_zero()) {
+    n = n / g;
+    d = d / g;
+  }
+}
+
+q::BigRational
+q::BigRational::operator+(const q::BigRational &rhs) const {
+  return q::BigRational(n*rhs.d + rhs.n*d, d*rhs.d);
+}
+
+q::BigRational
+q::BigRational::operator-(const q::BigRational &rhs) const {
+  return q::BigRational(n*rhs.d - rhs.n*d, d*rhs.d);
+}
+
+q::BigRational
+q::BigRational::operator*(const q::BigRational &rhs) const {
+  return q::BigRational(n*rhs.n, d*rhs.d);
+}
+
+q::BigRational
+q::BigRational::operator/(const q::BigRational &rhs) const {
+  return q::BigRational(n*rhs.d, d*rhs.n);
+}
+
+q::BigRational::operator double() const {
+  // both halves can be past a double's range when the ratio isn't
+  int en, ed;
+  double mn = scaled(n, en);
+  double md = scaled(d, ed);
+  return std::ldexp(mn / md, en - ed);
+}
+
+/* end of qinc/rpn-lang/src/bignum.cpp */
@@ -0,0 +1,241 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/bignum.h
+ *
+ * @file    bignum.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace q {
+  /*
+   * int64_t arithmetic that says when it wrapped, false if r is garbage
+   */
+  inline bool checked_add(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &r);
+#else
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+	(b < 0 && a < std::numeric_limits<int64_t>::min() - b)) {
+      return false;
+    }
+    r = a + b;
+    return true;
+#endif
+  }
+
+  inline bool checked_subtract(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_sub_overflow(a, b, &r);
+#else
+    if ((b < 0 && a > std::numeric_limits<int64_t>::max() + b) ||
+	(b > 0 && a < std::numeric_limits<int64_t>::min() + b)) {
+      return false;
+    }
+    r = a - b;
+    return true;
+#endif
+  }
+
+  inline bool checked_multiply(int64_t a, int64_t b, int64_t &r) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &r);
+#else
+    if (a != 0 && b != 0) {
+      if ((a == -1 && b == std::numeric_limits<int64_t>::min()) ||
+	  (b == -1 && a == std::numeric_limits<int64_t>::min())) {
+	return false;
+      }
+      int64_t p = int64_t(uint64_t(a) * uint64_t(b));
+      if (p / b != a) {
+	return false;
+      }
+    }
+    r = int64_t(uint64_t(a) * uint64_t(b));
+    return true;
+#endif
+  }
+
+  /*
+   * a signed integer of any size, a magnitude of 32 bit limbs (least
+   * significant first, never a leading zero) and a sign.  zero is
+   * empty and never negative
+   */
+  class BigInt {
+  public:
+    using Limb = uint32_t;
+    using Limbs = std::vector<Limb>;
+
+    BigInt() = default;
+    BigInt(int64_t v);
+    BigInt(bool negative, Limbs &&mag);
+
+    // an optional '-' and decimal digits
+    static bool parse(const std::string &s, BigInt &out);
+    std::string to_string() const;
+
+    bool is_zero() const { return _mag.empty(); }
+    bool negative() const { return _neg; }
+    const Limbs &limbs() const { return _mag; }
+    size_t bits() const; // of the magnitude
+    bool fits_int64() const;
+    int64_t to_int64() const; // only when it fits
+    explicit operator double() const;
+
+    int compare(const BigInt &rhs) const;
+    bool operator==(const BigInt &rhs) const { return _neg == rhs._neg && _mag == rhs._mag; }
+    bool operator!=(const BigInt &rhs) const { return !(*this == rhs); }
+    bool operator<(const BigInt &rhs) const { return compare(rhs) < 0; }
+
+    BigInt operator-() const;
+    BigInt abs() const { return BigInt(false, Limbs(_mag)); }
+    BigInt operator+(const BigInt &rhs) const;
+    BigInt operator-(const BigInt &rhs) const;
+    BigInt operator*(const BigInt &rhs) const;
+    // truncates toward zero, the same as int64_t.  d can't be zero
+    static void divide(const BigInt &n, const BigInt &d, BigInt &quotient, BigInt &remainder);
+    BigInt operator/(const BigInt &rhs) const;
+    BigInt pow(uint64_t e) const;
+    // a power that would be bigger than this is an error rather than all the memory
+    static const size_t k_maxPowBits = size_t(1) << 26;
+    static BigInt gcd(const BigInt &a, const BigInt &b);
+
+  private:
+    bool _neg = false;
+    Limbs _mag;
+  };
+
+  /*
+   * n/d in lowest terms with d positive, for when a Fraction's
+   * numerator or denominator doesn't fit
+   */
+  struct BigRational {
+    BigRational(const BigInt &num, const BigInt &den); // den can't be zero
+    BigRational operator+(const BigRational &rhs) const;
+    BigRational operator-(const BigRational &rhs) const;
+    BigRational operator*(const BigRational &rhs) const;
+    BigRational operator/(const BigRational &rhs) const; // rhs can't be zero
+    bool operator==(const BigRational &rhs) const { return n == rhs.n && d == rhs.d; }
+    explicit operator double() const;
+
+    BigInt n;
+    BigInt d;
+  };
+}
+
+#ifdef _RPN_LANG_RPN_H_
+#include "fraction.h"
+
+namespace stack {
+  /*
+   * only ever holds a value that doesn't fit an Integer, push_exact()
+   * makes sure of that
+   */
+  class BigInt : public rpn::Stack::Object {
+  public:
+    BigInt(const q::BigInt &v) : _v(v) {}
+    BigInt(q::BigInt &&v) : _v(std::move(v)) {}
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const BigInt, orhs);
+      return _v == rhs._v;
+    }
+    virtual bool operator>(const rpn::Stack::Object &orhs) const override {
+      return val(orhs).compare(_v) < 0;
+    }
+    virtual bool operator<(const rpn::Stack::Object &orhs) const override {
+      return _v.compare(val(orhs)) < 0;
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<BigInt>(*this); };
+    virtual operator std::string() const override { return _v.to_string(); }
+    virtual operator double() const override { return double(_v); }
+    // a literal too long for an Integer reads back as a BigInt
+    virtual std::string deparse() const override { return _v.to_string(); }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("BigInt");
+      put(w, _v);
+      return true;
+    }
+    static void put(rpn::ImageWriter &w, const q::BigInt &v) {
+      w.u8(v.negative() ? 1 : 0);
+      w.u32(uint32_t(v.limbs().size()));
+      for(auto l : v.limbs()) {
+	w.u32(l);
+      }
+    }
+    const q::BigInt &val() const { return _v; }
+    // an Integer or a BigInt
+    static q::BigInt val(const rpn::Stack::Object &o) {
+      if (o.tag() == rpn::type_tag<BigInt>()) {
+	return static_cast<const BigInt&>(o)._v;
+      }
+      return q::BigInt(int64_t(PEEK_CAST(const StInteger, o)));
+    }
+  private:
+    q::BigInt _v;
+  };
+
+  /*
+   * a Fraction whose numerator or denominator doesn't fit
+   */
+  class BigFraction : public rpn::Stack::Object {
+  public:
+    BigFraction(const q::BigRational &v) : _v(v) {}
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const BigFraction, orhs);
+      return _v == rhs._v;
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<BigFraction>(*this); };
+    virtual operator std::string() const override { return _v.n.to_string() + "/" + _v.d.to_string(); }
+    virtual operator double() const override { return double(_v); }
+    virtual std::string deparse() const override { return _v.n.to_string() + " " + _v.d.to_string() + " ->FRAC"; }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("BigFraction");
+      BigInt::put(w, _v.n);
+      BigInt::put(w, _v.d);
+      return true;
+    }
+    const q::BigRational &val() const { return _v; }
+  private:
+    q::BigRational _v;
+  };
+
+  /*
+   * the smallest type that holds v exactly, an Integer if it fits
+   */
+  void push_exact(rpn::Stack &s, q::BigInt &&v);
+  // a Fraction if both halves fit
+  void push_exact(rpn::Stack &s, q::BigRational &&v);
+} // namespace stack
+
+namespace bignum_validator {
+  extern const rpn::StrictTypeValidator d1_bigint;
+  extern const rpn::StrictTypeValidator d1_bigfrac;
+  extern const rpn::StrictTypeValidator d2_bigint_bigint;
+  extern const rpn::StrictTypeValidator d2_bigint_integer;
+  extern const rpn::StrictTypeValidator d2_integer_bigint;
+  extern const rpn::StrictTypeValidator d2_bigint_double;
+  extern const rpn::StrictTypeValidator d2_double_bigint;
+  extern const rpn::StrictTypeValidator d2_integer_bigfrac;
+  extern const rpn::StrictTypeValidator d2_bigfrac_integer;
+  extern const rpn::StrictTypeValidator d2_bigint_bigfrac;
+  extern const rpn::StrictTypeValidator d2_bigfrac_bigint;
+  extern const rpn::StrictTypeValidator d2_frac_bigfrac;
+  extern const rpn::StrictTypeValidator d2_bigfrac_frac;
+  extern const rpn::StrictTypeValidator d2_bigfrac_bigfrac;
+  extern const rpn::StrictTypeValidator d2_frac_bigint;
+  extern const rpn::StrictTypeValidator d2_bigint_frac;
+}
+#endif
+
+/* end of qinc/rpn-lang/src/bignum.h */
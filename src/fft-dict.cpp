@@ -0,0 +1,227 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/fft-dict.cpp
+ *
+ * @file    fft-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#define _USE_MATH_DEFINES // for MSVC
+
+#include "../rpn.h"
+#include "fft.h"
+
+#include <cmath>
+
+using StComplexArray = stack::ComplexArray;
+
+/*
+ * arrays of numbers and ->COMPLEX values convert to signals; anything
+ * else in the array is a param_error and leaves the stack alone
+ */
+static bool
+to_signal(const StArray &a, q::Signal &s) {
+  s = q::Signal(a.size());
+  for(size_t i=0; i<a.size(); i++) {
+    const auto &e = a.value(i);
+    if (e.tag() == rpn::type_tag<stack::Complex>()) {
+      const auto &cx = static_cast<const stack::Complex&>(e);
+      s.re[i] = cx.real();
+      s.im[i] = cx.imag();
+    } else if (e.tag() == rpn::tt_double || e.tag() == rpn::tt_integer) {
+      s.re[i] = double(e);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::unique_ptr<StArray>
+to_doubles(const std::vector<double> &v) {
+  StArray::Elements rv;
+  rv.reserve(v.size());
+  for(auto const &d : v) {
+    rv.push_back(std::make_unique<StDouble>(d));
+  }
+  return std::make_unique<StArray>(std::move(rv));
+}
+
+// ( [samples] -- carray )
+NATIVE_WORD_DECL(fft, to_carray) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::Signal s;
+  if (!to_signal(PEEK_CAST(const StArray,rpn.stack.peek_const(1)), s)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StComplexArray>(std::move(s)));
+  return rv;
+}
+
+// ( carray -- [complex] )
+NATIVE_WORD_DECL(fft, carray_to) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto oca = rpn.stack.pop();
+  const auto &s = POP_CAST(StComplexArray,oca).val();
+  StArray::Elements cxs;
+  cxs.reserve(s.size());
+  for(size_t i=0; i<s.size(); i++) {
+    cxs.push_back(std::make_unique<stack::Complex>(s.re[i], s.im[i]));
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(cxs)));
+  return rv;
+}
+
+static void
+transform(rpn::Interp &rpn, bool inverse) {
+  auto oca = rpn.stack.pop();
+  auto &ca = POP_CAST(StComplexArray,oca);
+  q::fft(ca.mut(), inverse);
+  rpn.stack.push(std::move(oca));
+}
+
+// ( carray -- carray )
+NATIVE_WORD_DECL(fft, fft) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  transform(rpn, false);
+  return rv;
+}
+
+// ( [samples] -- carray )
+NATIVE_WORD_DECL(fft, fft_a) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::Signal s;
+  if (!to_signal(PEEK_CAST(const StArray,rpn.stack.peek_const(1)), s)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  q::fft(s);
+  rpn.stack.push(std::make_unique<StComplexArray>(std::move(s)));
+  return rv;
+}
+
+// ( carray -- carray )
+NATIVE_WORD_DECL(fft, ifft) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  transform(rpn, true);
+  return rv;
+}
+
+// ( carray carray -- carray )
+NATIVE_WORD_DECL(fft, conv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ob = rpn.stack.pop();
+  const auto &b = POP_CAST(StComplexArray,ob);
+  auto oa = rpn.stack.pop();
+  const auto &a = POP_CAST(StComplexArray,oa);
+  rpn.stack.push(std::make_unique<StComplexArray>(q::convolve(a.val(), b.val())));
+  return rv;
+}
+
+// ( [numbers] [numbers] -- [doubles] )
+NATIVE_WORD_DECL(fft, conv_aa) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &oa = PEEK_CAST(const StArray,rpn.stack.peek_const(2));
+  const auto &ob = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  q::Signal a, b;
+  if (!to_signal(oa, a) || !to_signal(ob, b)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  for(size_t i=0; i<a.size(); i++) {
+    if (a.im[i] != 0.) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+  }
+  for(size_t i=0; i<b.size(); i++) {
+    if (b.im[i] != 0.) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+  }
+  rpn.stack.pop();
+  rpn.stack.pop();
+  rpn.stack.push(to_doubles(q::convolve(a, b).re));
+  return rv;
+}
+
+// ( carray -- [doubles] )
+NATIVE_WORD_DECL(fft, magnitude) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto oca = rpn.stack.pop();
+  const auto &s = POP_CAST(StComplexArray,oca).val();
+  std::vector<double> mag(s.size());
+  for(size_t i=0; i<s.size(); i++) {
+    mag[i] = std::hypot(s.re[i], s.im[i]);
+  }
+  rpn.stack.push(to_doubles(mag));
+  return rv;
+}
+
+// ( complex -- double )
+NATIVE_WORD_DECL(fft, magnitude_c) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ocx = rpn.stack.pop();
+  const auto &cx = POP_CAST(stack::Complex,ocx);
+  rpn.stack.push_double(std::abs(cx));
+  return rv;
+}
+
+// ( carray -- [degrees] ) in degrees, like ATAN2
+NATIVE_WORD_DECL(fft, phase) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto oca = rpn.stack.pop();
+  const auto &s = POP_CAST(StComplexArray,oca).val();
+  std::vector<double> ph(s.size());
+  for(size_t i=0; i<s.size(); i++) {
+    ph[i] = std::atan2(s.im[i], s.re[i]) * 180. / M_PI;
+  }
+  rpn.stack.push(to_doubles(ph));
+  return rv;
+}
+
+// ( complex -- degrees )
+NATIVE_WORD_DECL(fft, phase_c) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ocx = rpn.stack.pop();
+  const auto &cx = POP_CAST(stack::Complex,ocx);
+  rpn.stack.push_double(std::arg(cx) * 180. / M_PI);
+  return rv;
+}
+
+void
+rpn::Interp::addFftWords() {
+  rpn::Interp &rpn = *this; // in case we want to move this out someday
+  rpn.addDefinition("->CARRAY", NATIVE_WORD_WDEF(fft, rpn::StrictTypeValidator::d1_array, to_carray, nullptr));
+  rpn.addDefinition("CARRAY->", NATIVE_WORD_WDEF(fft, fft_validator::d1_carray, carray_to, nullptr));
+  rpn.addDefinition("FFT", NATIVE_WORD_WDEF(fft, fft_validator::d1_carray, fft, nullptr));
+  rpn.addDefinition("FFT", NATIVE_WORD_WDEF(fft, rpn::StrictTypeValidator::d1_array, fft_a, nullptr));
+  rpn.addDefinition("IFFT", NATIVE_WORD_WDEF(fft, fft_validator::d1_carray, ifft, nullptr));
+  rpn.addDefinition("CONV", NATIVE_WORD_WDEF(fft, fft_validator::d2_carray_carray, conv, nullptr));
+  rpn.addDefinition("CONV", NATIVE_WORD_WDEF(fft, rpn::StrictTypeValidator::d2_array_array, conv_aa, nullptr));
+  rpn.addDefinition("MAGNITUDE", NATIVE_WORD_WDEF(fft, fft_validator::d1_carray, magnitude, nullptr));
+  rpn.addDefinition("MAGNITUDE", NATIVE_WORD_WDEF(fft, math_validator::d1_complex, magnitude_c, nullptr));
+  rpn.addDefinition("PHASE", NATIVE_WORD_WDEF(fft, fft_validator::d1_carray, phase, nullptr));
+  rpn.addDefinition("PHASE", NATIVE_WORD_WDEF(fft, math_validator::d1_complex, phase_c, nullptr));
+}
+
+static const rpn::TypeTag sk_carrayTag = rpn::TypeRegistry::add<StComplexArray>("ComplexArray");
+
+const rpn::StrictTypeValidator fft_validator::d1_carray({rpn::type_tag<StComplexArray>()}, "d1_carray");
+const rpn::StrictTypeValidator fft_validator::d2_carray_carray({rpn::type_tag<StComplexArray>(),rpn::type_tag<StComplexArray>()}, "d2_carray_carray");
+
+static const bool sk_complexArrayImage = rpn::ImageReader::addType("ComplexArray", [](rpn::ImageReader &r) {
+    q::Signal s(r.u32());
+    for(size_t i=0; i<s.size(); i++) {
+      s.re[i] = r.f64();
+      s.im[i] = r.f64();
+    }
+    return std::make_unique<StComplexArray>(std::move(s));
+  });
+
+/* end of qinc/rpn-lang/src/fft-dict.cpp */
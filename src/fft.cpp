@@ -0,0 +1,284 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/fft.cpp
+ *
+ * @file    fft.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#define _USE_MATH_DEFINES // for MSVC
+
+#include "fft.h"
+#include "simd.h"
+
+#include <map>
+#include <cmath>
+#include <mutex>
+#include <utility>
+
+/****************************************
+ * plans
+ *
+ * everything a length needs that doesn't depend on the samples.  plans
+ * are interned on the length, like frame rates, and live forever.
+ */
+namespace {
+  struct Plan {
+    size_t n;
+    bool pow2;
+    // radix-2: bit reversed index, and the twiddles for each pass laid end
+    // to end, the pass with half-width h starts at h-1
+    std::vector<size_t> rev;
+    std::vector<double> twRe;
+    std::vector<double> twIm;
+    // anything else goes through Bluestein: a chirp, and the transform of
+    // its conjugate at the padded power of two length
+    const Plan *inner = nullptr;
+    std::vector<double> chirpRe;
+    std::vector<double> chirpIm;
+    q::Signal kernel;
+  };
+}
+
+static void radix2(const Plan &p, double *RESTRICT re, double *RESTRICT im);
+
+static size_t
+next_pow2(size_t n) {
+  size_t rv = 1;
+  while (rv < n) {
+    rv <<= 1;
+  }
+  return rv;
+}
+
+static const Plan &plan_locked(size_t n, std::map<size_t,std::unique_ptr<const Plan>> &plans);
+
+static std::unique_ptr<const Plan>
+make_plan(size_t n, std::map<size_t,std::unique_ptr<const Plan>> &plans) {
+  auto rv = std::make_unique<Plan>();
+  rv->n = n;
+  rv->pow2 = (n & (n-1)) == 0;
+  if (rv->pow2) {
+    size_t bits = 0;
+    while ((size_t(1) << bits) < n) {
+      bits++;
+    }
+    rv->rev.resize(n);
+    for(size_t i=0; i<n; i++) {
+      size_t r = 0;
+      for(size_t b=0; b<bits; b++) {
+	r |= ((i >> b) & 1) << (bits-1-b);
+      }
+      rv->rev[i] = r;
+    }
+    rv->twRe.resize(n > 1 ? n-1 : 0);
+    rv->twIm.resize(rv->twRe.size());
+    for(size_t h=1; h<n; h*=2) {
+      for(size_t k=0; k<h; k++) {
+	double a = -M_PI * double(k) / double(h);
+	rv->twRe[h-1+k] = std::cos(a);
+	rv->twIm[h-1+k] = std::sin(a);
+      }
+    }
+  } else {
+    // w[k] = e^(-i pi k^2 / n).  k^2 is reduced mod 2n first, the angle
+    // loses precision quickly otherwise
+    size_t m = next_pow2(2*n-1);
+    rv->inner = &plan_locked(m, plans);
+    rv->chirpRe.resize(n);
+    rv->chirpIm.resize(n);
+    for(size_t k=0; k<n; k++) {
+      size_t k2 = (k*k) % (2*n);
+      double a = -M_PI * double(k2) / double(n);
+      rv->chirpRe[k] = std::cos(a);
+      rv->chirpIm[k] = std::sin(a);
+    }
+    q::Signal &b = rv->kernel;
+    b = q::Signal(m);
+    b.re[0] = rv->chirpRe[0];
+    b.im[0] = -rv->chirpIm[0];
+    for(size_t k=1; k<n; k++) {
+      b.re[k] = b.re[m-k] = rv->chirpRe[k];
+      b.im[k] = b.im[m-k] = -rv->chirpIm[k];
+    }
+    radix2(*rv->inner, b.re.data(), b.im.data());
+  }
+  return rv;
+}
+
+static const Plan &
+plan_locked(size_t n, std::map<size_t,std::unique_ptr<const Plan>> &plans) {
+  auto &slot = plans[n];
+  if (!slot) {
+    slot = make_plan(n, plans);
+  }
+  return *slot;
+}
+
+static const Plan &
+plan(size_t n) {
+  // transforms come in runs of one length, so remember the last one
+  thread_local const Plan *last = nullptr;
+  if (last != nullptr && last->n == n) {
+    return *last;
+  }
+
+  static std::mutex mx;
+  static std::map<size_t,std::unique_ptr<const Plan>> plans;
+  std::lock_guard lg(mx);
+  last = &plan_locked(n, plans);
+  return *last;
+}
+
+/****************************************
+ * kernels
+ *
+ * the butterflies walk four double arrays at once
+ */
+
+// iterative decimation in time, forward, in place
+static void
+radix2(const Plan &p, double *RESTRICT re, double *RESTRICT im) {
+  size_t n = p.n;
+  for(size_t i=0; i<n; i++) {
+    size_t j = p.rev[i];
+    if (i < j) {
+      std::swap(re[i], re[j]);
+      std::swap(im[i], im[j]);
+    }
+  }
+  for(size_t h=1; h<n; h*=2) {
+    const double *RESTRICT wr = &p.twRe[h-1];
+    const double *RESTRICT wi = &p.twIm[h-1];
+    for(size_t base=0; base<n; base+=2*h) {
+      double *RESTRICT ar = re + base;
+      double *RESTRICT ai = im + base;
+      double *RESTRICT br = re + base + h;
+      double *RESTRICT bi = im + base + h;
+      for(size_t k=0; k<h; k++) {
+	double tr = br[k]*wr[k] - bi[k]*wi[k];
+	double ti = br[k]*wi[k] + bi[k]*wr[k];
+	br[k] = ar[k] - tr;
+	bi[k] = ai[k] - ti;
+	ar[k] += tr;
+	ai[k] += ti;
+      }
+    }
+  }
+}
+
+// a *= b, elementwise
+static void
+multiply(size_t n, double *RESTRICT ar, double *RESTRICT ai, const double *RESTRICT br, const double *RESTRICT bi) {
+  for(size_t k=0; k<n; k++) {
+    double r = ar[k]*br[k] - ai[k]*bi[k];
+    double i = ar[k]*bi[k] + ai[k]*br[k];
+    ar[k] = r;
+    ai[k] = i;
+  }
+}
+
+static void
+scale(size_t n, double *RESTRICT re, double *RESTRICT im, double s) {
+  for(size_t k=0; k<n; k++) {
+    re[k] *= s;
+    im[k] *= s;
+  }
+}
+
+// the transform as a convolution with a chirp, at a power of two length
+static void
+bluestein(const Plan &p, double *RESTRICT re, double *RESTRICT im) {
+  const Plan &in = *p.inner;
+  size_t n = p.n;
+  size_t m = in.n;
+  q::Signal a(m);
+  for(size_t k=0; k<n; k++) {
+    a.re[k] = re[k];
+    a.im[k] = im[k];
+  }
+  multiply(n, a.re.data(), a.im.data(), p.chirpRe.data(), p.chirpIm.data());
+  radix2(in, a.re.data(), a.im.data());
+  multiply(m, a.re.data(), a.im.data(), p.kernel.re.data(), p.kernel.im.data());
+  // inverse by swapping the parts going in and coming out
+  radix2(in, a.im.data(), a.re.data());
+  scale(n, a.re.data(), a.im.data(), 1./double(m));
+  multiply(n, a.re.data(), a.im.data(), p.chirpRe.data(), p.chirpIm.data());
+  for(size_t k=0; k<n; k++) {
+    re[k] = a.re[k];
+    im[k] = a.im[k];
+  }
+}
+
+void
+q::fft(q::Signal &s, bool inverse) {
+  size_t n = s.size();
+  if (n < 2) {
+    return;
+  }
+  const Plan &p = plan(n);
+  double *re = s.re.data();
+  double *im = s.im.data();
+  if (inverse) {
+    // conj(fft(conj(x))) is the same as swapping the parts either side
+    std::swap(re, im);
+  }
+  if (p.pow2) {
+    radix2(p, re, im);
+  } else {
+    bluestein(p, re, im);
+  }
+  if (inverse) {
+    scale(n, re, im, 1./double(n));
+  }
+}
+
+/****************************************
+ * convolution
+ */
+
+// below this many multiplies it's not worth the transforms
+static const size_t sk_directConvolution = 4096;
+
+q::Signal
+q::convolve(const q::Signal &a, const q::Signal &b) {
+  size_t na = a.size();
+  size_t nb = b.size();
+  if (na == 0 || nb == 0) {
+    return q::Signal();
+  }
+  size_t n = na + nb - 1;
+  if (na * nb <= sk_directConvolution) {
+    q::Signal rv(n);
+    for(size_t i=0; i<na; i++) {
+      for(size_t j=0; j<nb; j++) {
+	rv.re[i+j] += a.re[i]*b.re[j] - a.im[i]*b.im[j];
+	rv.im[i+j] += a.re[i]*b.im[j] + a.im[i]*b.re[j];
+      }
+    }
+    return rv;
+  }
+
+  size_t m = next_pow2(n);
+  q::Signal fa(m);
+  q::Signal fb(m);
+  std::copy(a.re.begin(), a.re.end(), fa.re.begin());
+  std::copy(a.im.begin(), a.im.end(), fa.im.begin());
+  std::copy(b.re.begin(), b.re.end(), fb.re.begin());
+  std::copy(b.im.begin(), b.im.end(), fb.im.begin());
+  q::fft(fa);
+  q::fft(fb);
+  multiply(m, fa.re.data(), fa.im.data(), fb.re.data(), fb.im.data());
+  q::fft(fa, true);
+  fa.re.resize(n);
+  fa.im.resize(n);
+  return fa;
+}
+
+/* end of qinc/rpn-lang/src/fft.cpp */
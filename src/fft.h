@@ -0,0 +1,145 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/fft.h
+ *
+ * @file    fft.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <complex>
+
+namespace q {
+  /*
+   * complex samples kept as separate real and imaginary arrays, so the
+   * transform loops run down plain double arrays
+   */
+  struct Signal {
+    Signal() = default;
+    explicit Signal(size_t n) : re(n, 0.), im(n, 0.) {}
+    size_t size() const { return re.size(); }
+    bool operator==(const Signal &rhs) const { return re == rhs.re && im == rhs.im; }
+
+    std::vector<double> re;
+    std::vector<double> im;
+  };
+
+  // in place, any length.  the inverse is scaled by 1/n
+  void fft(Signal &s, bool inverse=false);
+  // linear convolution, a.size()+b.size()-1 samples
+  Signal convolve(const Signal &a, const Signal &b);
+}
+
+#ifdef _RPN_LANG_RPN_H_
+namespace stack {
+  class Complex : public rpn::Stack::Object, public std::complex<double>  {
+  public:
+    Complex() = delete;
+    Complex(double re, double im) : std::complex<double>(re,im) {}
+    Complex(const Complex &cx) : rpn::Stack::Object(cx), std::complex<double>(cx) {}
+    Complex(const std::complex<double> &cx) : std::complex<double>(cx) {}
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const Complex, orhs);
+      return ((const std::complex<double> &)*this) == ((const std::complex<double> &)rhs);
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Complex>(*this); };
+    virtual operator std::string() const override {
+      return to_string(this->real(), this->imag());
+    }
+  virtual std::string deparse() const override {
+    std::string rv;
+    rv += std::to_string(this->real()) + " ";
+    rv += std::to_string(this->imag()) + " ->COMPLEX";
+    return rv;
+  }
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Complex");
+    w.f64(this->real());
+    w.f64(this->imag());
+    return true;
+  }
+  static std::string to_string(double re, double im) {
+    std:: string rv = rpn::to_string(re);
+    if (im>0) {
+      rv += "+";
+    }
+    rv += rpn::to_string(im);
+    rv += "i";
+    return rv;
+  }
+  private:
+};
+
+  /*
+   * a whole signal as one stack object.  copies share the samples until
+   * one of them is changed
+   */
+  class ComplexArray : public rpn::Stack::Object {
+  public:
+    ComplexArray() : _v(std::make_shared<q::Signal>()) {}
+    ComplexArray(q::Signal &&s) : _v(std::make_shared<q::Signal>(std::move(s))) {}
+    ComplexArray(const ComplexArray &ca) = default;
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const ComplexArray, orhs);
+      return _v == rhs._v || *_v == *rhs._v;
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<ComplexArray>(*this); };
+    virtual operator std::string() const override {
+      std::string rv = "[";
+      for(size_t i=0; i<_v->size(); i++) {
+	rv += Complex::to_string(_v->re[i], _v->im[i]);
+	rv += ", ";
+      }
+      rv += "]";
+      return rv;
+    }
+    virtual std::string deparse() const override {
+      std::string rv;
+      for(size_t i=0; i<_v->size(); i++) {
+	rv += std::to_string(_v->re[i]) + " ";
+	rv += std::to_string(_v->im[i]) + " ->COMPLEX ";
+      }
+      rv += std::to_string(_v->size()) + " ->ARRAY ->CARRAY";
+      return rv;
+    }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("ComplexArray");
+      w.u32(uint32_t(_v->size()));
+      for(size_t i=0; i<_v->size(); i++) {
+	w.f64(_v->re[i]);
+	w.f64(_v->im[i]);
+      }
+      return true;
+    }
+    size_t size() const { return _v->size(); }
+    const q::Signal &val() const { return *_v; }
+    q::Signal &mut() {
+      if (_v.use_count() > 1) {
+	_v = std::make_shared<q::Signal>(*_v);
+      }
+      return *_v;
+    }
+  private:
+    std::shared_ptr<q::Signal> _v;
+  };
+} // namespace stack
+
+namespace math_validator {
+  extern const rpn::StrictTypeValidator d1_complex;
+}
+
+namespace fft_validator {
+  extern const rpn::StrictTypeValidator d1_carray;
+  extern const rpn::StrictTypeValidator d2_carray_carray;
+}
+#endif
+
+/* end of qinc/rpn-lang/src/fft.h */
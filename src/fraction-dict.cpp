@@ -15,9 +15,77 @@
 #include "../rpn.h"
 #include <cmath>
 #include "fraction.h"
+#include "bignum.h"
 
 using StFraction = stack::Fraction;
 
+/*
+ * the products in Fraction's arithmetic wrap long before the values
+ * get silly, these say when so the word can redo it as a BigRational
+ */
+// a/b + c/d, or a/b - c/d
+static bool
+checked_sum(const q::Fraction &l, const q::Fraction &r, bool subtract, q::Fraction &out) {
+  int64_t ad, cb, n, d;
+  if (!q::checked_multiply(l._numerator, r._denominator, ad) ||
+      !q::checked_multiply(r._numerator, l._denominator, cb) ||
+      !(subtract ? q::checked_subtract(ad, cb, n) : q::checked_add(ad, cb, n)) ||
+      !q::checked_multiply(l._denominator, r._denominator, d)) {
+    return false;
+  }
+  out = q::Fraction(n, d);
+  return true;
+}
+
+// (a*c)/(b*d)
+static bool
+checked_product(int64_t a, int64_t b, int64_t c, int64_t d, q::Fraction &out) {
+  int64_t n, dd;
+  if (!q::checked_multiply(a, c, n) || !q::checked_multiply(b, d, dd)) {
+    return false;
+  }
+  out = q::Fraction(n, dd);
+  return true;
+}
+
+static q::BigRational
+exact(const q::Fraction &f) {
+  return q::BigRational(q::BigInt(f._numerator), q::BigInt(f._denominator));
+}
+
+// l op r for op one of + - * /, as a BigRational if it won't fit
+static void
+push_arith(rpn::Stack &s, char op, const q::Fraction &l, const q::Fraction &r) {
+  q::Fraction f(0, 1);
+  bool fits = false;
+  switch(op) {
+  case '+': fits = checked_sum(l, r, false, f); break;
+  case '-': fits = checked_sum(l, r, true, f); break;
+  case '*': fits = checked_product(l._numerator, l._denominator, r._numerator, r._denominator, f); break;
+  case '/': fits = checked_product(l._numerator, l._denominator, r._denominator, r._numerator, f); break;
+  }
+  if (fits) {
+    s.push(StFraction(f));
+    return;
+  }
+  switch(op) {
+  case '+': stack::push_exact(s, exact(l) + exact(r)); break;
+  case '-': stack::push_exact(s, exact(l) - exact(r)); break;
+  case '*': stack::push_exact(s, exact(l) * exact(r)); break;
+  case '/': stack::push_exact(s, exact(l) / exact(r)); break;
+  }
+}
+
+// an Integer beside a Fraction is exact as n/1, a Double is left on the stack
+static bool
+pop_whole(rpn::Stack &s, q::Fraction &f) {
+  if (s.peek_const(1).tag() != rpn::tt_integer) {
+    return false;
+  }
+  f = q::Fraction(s.pop_integer(), 1);
+  return true;
+}
+
 NATIVE_WORD_DECL(fraction, to_frac_ii) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto denom = rpn.stack.pop_integer();
@@ -33,6 +101,18 @@ NATIVE_WORD_DECL(fraction, to_frac_d) {
   return rv;
 }
 
+// ( x maxden -- frac ) the closest fraction with a denominator up to maxden
+NATIVE_WORD_DECL(fraction, to_frac_di) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  if (rpn.stack.peek_integer(1) < 1) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto maxden = rpn.stack.pop_integer();
+  auto dec = rpn.stack.pop_double();
+  rpn.stack.push(StFraction(q::Fraction::approximate(dec, maxden, q::Fraction::s_precision)));
+  return rv;
+}
+
 NATIVE_WORD_DECL(fraction, obj_to) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto ofrac = rpn.stack.pop();
@@ -64,7 +144,7 @@ NATIVE_WORD_DECL(fraction, add_ff) {
   const auto &f2 = POP_CAST(StFraction,o2);
   auto o1 = rpn.stack.pop();
   const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 + f2));
+  push_arith(rpn.stack, '+', f1, f2);
   return rv;
 }
 
@@ -72,17 +152,28 @@ NATIVE_WORD_DECL(fraction, add_fn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto o2 = rpn.stack.pop();
   const auto &f2 = POP_CAST(StFraction,o2);
-  auto d1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StFraction(d1 + f2));
+  q::Fraction f1(0, 1);
+  if (pop_whole(rpn.stack, f1)) {
+    push_arith(rpn.stack, '+', f1, f2);
+  } else {
+    auto d1 = rpn.stack.pop_as_double();
+    rpn.stack.push(StFraction(d1 + f2));
+  }
   return rv;
 }
 
 NATIVE_WORD_DECL(fraction, add_nf) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto d2 = rpn.stack.pop_as_double();
-  auto o1 = rpn.stack.pop();
-  const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 + d2));
+  q::Fraction f2(0, 1);
+  if (pop_whole(rpn.stack, f2)) {
+    auto o1 = rpn.stack.pop();
+    push_arith(rpn.stack, '+', POP_CAST(StFraction,o1), f2);
+  } else {
+    auto d2 = rpn.stack.pop_as_double();
+    auto o1 = rpn.stack.pop();
+    const auto &f1 = POP_CAST(StFraction,o1);
+    rpn.stack.push(StFraction(f1 + d2));
+  }
   return rv;
 }
 
@@ -92,7 +183,7 @@ NATIVE_WORD_DECL(fraction, sub_ff) {
   const auto &f2 = POP_CAST(StFraction,o2);
   auto o1 = rpn.stack.pop();
   const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 - f2));
+  push_arith(rpn.stack, '-', f1, f2);
   return rv;
 }
 
@@ -100,17 +191,28 @@ NATIVE_WORD_DECL(fraction, sub_fn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto o2 = rpn.stack.pop();
   const auto &f2 = POP_CAST(StFraction,o2);
-  auto d1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StFraction(d1 - f2));
+  q::Fraction f1(0, 1);
+  if (pop_whole(rpn.stack, f1)) {
+    push_arith(rpn.stack, '-', f1, f2);
+  } else {
+    auto d1 = rpn.stack.pop_as_double();
+    rpn.stack.push(StFraction(d1 - f2));
+  }
   return rv;
 }
 
 NATIVE_WORD_DECL(fraction, sub_nf) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto d2 = rpn.stack.pop_as_double();
-  auto o1 = rpn.stack.pop();
-  const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 - d2));
+  q::Fraction f2(0, 1);
+  if (pop_whole(rpn.stack, f2)) {
+    auto o1 = rpn.stack.pop();
+    push_arith(rpn.stack, '-', POP_CAST(StFraction,o1), f2);
+  } else {
+    auto d2 = rpn.stack.pop_as_double();
+    auto o1 = rpn.stack.pop();
+    const auto &f1 = POP_CAST(StFraction,o1);
+    rpn.stack.push(StFraction(f1 - d2));
+  }
   return rv;
 }
 
@@ -118,17 +220,28 @@ NATIVE_WORD_DECL(fraction, mult_fn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto o2 = rpn.stack.pop();
   const auto &f2 = POP_CAST(StFraction,o2);
-  auto d1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StFraction(d1 * f2));
+  q::Fraction f1(0, 1);
+  if (pop_whole(rpn.stack, f1)) {
+    push_arith(rpn.stack, '*', f1, f2);
+  } else {
+    auto d1 = rpn.stack.pop_as_double();
+    rpn.stack.push(StFraction(d1 * f2));
+  }
   return rv;
 }
 
 NATIVE_WORD_DECL(fraction, mult_nf) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto d2 = rpn.stack.pop_as_double();
-  auto o1 = rpn.stack.pop();
-  const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 * d2));
+  q::Fraction f2(0, 1);
+  if (pop_whole(rpn.stack, f2)) {
+    auto o1 = rpn.stack.pop();
+    push_arith(rpn.stack, '*', POP_CAST(StFraction,o1), f2);
+  } else {
+    auto d2 = rpn.stack.pop_as_double();
+    auto o1 = rpn.stack.pop();
+    const auto &f1 = POP_CAST(StFraction,o1);
+    rpn.stack.push(StFraction(f1 * d2));
+  }
   return rv;
 }
 
@@ -138,7 +251,7 @@ NATIVE_WORD_DECL(fraction, mult_ff) {
   const auto &f2 = POP_CAST(StFraction,o2);
   auto o1 = rpn.stack.pop();
   const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 * f2));
+  push_arith(rpn.stack, '*', f1, f2);
   return rv;
 }
 
@@ -147,17 +260,28 @@ NATIVE_WORD_DECL(fraction, divide_fn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto o2 = rpn.stack.pop();
   const auto &f2 = POP_CAST(StFraction,o2);
-  auto d1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StFraction(d1 / f2));
+  q::Fraction f1(0, 1);
+  if (pop_whole(rpn.stack, f1)) {
+    push_arith(rpn.stack, '/', f1, f2);
+  } else {
+    auto d1 = rpn.stack.pop_as_double();
+    rpn.stack.push(StFraction(d1 / f2));
+  }
   return rv;
 }
 
 NATIVE_WORD_DECL(fraction, divide_nf) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto d2 = rpn.stack.pop_as_double();
-  auto o1 = rpn.stack.pop();
-  const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 / d2));
+  q::Fraction f2(0, 1);
+  if (pop_whole(rpn.stack, f2)) {
+    auto o1 = rpn.stack.pop();
+    push_arith(rpn.stack, '/', POP_CAST(StFraction,o1), f2);
+  } else {
+    auto d2 = rpn.stack.pop_as_double();
+    auto o1 = rpn.stack.pop();
+    const auto &f1 = POP_CAST(StFraction,o1);
+    rpn.stack.push(StFraction(f1 / d2));
+  }
   return rv;
 }
 
@@ -167,7 +291,7 @@ NATIVE_WORD_DECL(fraction, divide_ff) {
   const auto &f2 = POP_CAST(StFraction,o2);
   auto o1 = rpn.stack.pop();
   const auto &f1 = POP_CAST(StFraction,o1);
-  rpn.stack.push(StFraction(f1 / f2));
+  push_arith(rpn.stack, '/', f1, f2);
   return rv;
 }
 
@@ -175,7 +299,7 @@ NATIVE_WORD_DECL(fraction, sq_f) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto o = rpn.stack.pop();
   const auto &f = POP_CAST(StFraction,o);
-  rpn.stack.push(StFraction(f * f));
+  push_arith(rpn.stack, '*', f, f);
   return rv;
 }
 
@@ -224,15 +348,23 @@ NATIVE_WORD_DECL(fraction, neg_f) {
   return rv;
 }
 
-const rpn::StrictTypeValidator frac_validator::d1_frac({typeid(StFraction).hash_code()}, "d1_frac");
-const rpn::StrictTypeValidator frac_validator::d2_frac_frac({typeid(StFraction).hash_code(),typeid(StFraction).hash_code()}, "d2_frac_frac");
-const rpn::StrictTypeValidator frac_validator::d2_frac_int({typeid(StFraction).hash_code(),typeid(StInteger).hash_code()}, "d2_frac_int");
-const rpn::StrictTypeValidator frac_validator::d2_frac_double({typeid(StFraction).hash_code(),typeid(StDouble).hash_code()}, "d2_frac_double");
-const rpn::StrictTypeValidator frac_validator::d2_int_frac({typeid(StInteger).hash_code(),typeid(StFraction).hash_code()}, "d2_int_frac");
-const rpn::StrictTypeValidator frac_validator::d2_double_frac({typeid(StDouble).hash_code(),typeid(StFraction).hash_code()}, "d2_double_frac");
+static const rpn::TypeTag sk_fractionTag = rpn::TypeRegistry::add<StFraction>("Fraction");
+
+const rpn::StrictTypeValidator frac_validator::d1_frac({rpn::type_tag<StFraction>()}, "d1_frac");
+const rpn::StrictTypeValidator frac_validator::d2_frac_frac({rpn::type_tag<StFraction>(),rpn::type_tag<StFraction>()}, "d2_frac_frac");
+const rpn::StrictTypeValidator frac_validator::d2_frac_int({rpn::type_tag<StFraction>(),rpn::type_tag<StInteger>()}, "d2_frac_int");
+const rpn::StrictTypeValidator frac_validator::d2_frac_double({rpn::type_tag<StFraction>(),rpn::type_tag<StDouble>()}, "d2_frac_double");
+const rpn::StrictTypeValidator frac_validator::d2_int_frac({rpn::type_tag<StInteger>(),rpn::type_tag<StFraction>()}, "d2_int_frac");
+const rpn::StrictTypeValidator frac_validator::d2_double_frac({rpn::type_tag<StDouble>(),rpn::type_tag<StFraction>()}, "d2_double_frac");
 const rpn::StrictTypeValidator frac_validator::d5_int_int_int_int_frac({
-    typeid(StInteger).hash_code(),typeid(StInteger).hash_code(),typeid(StInteger).hash_code(),typeid(StInteger).hash_code(),
-      typeid(StFraction).hash_code()}, "d5_int_int_int_int_frac");
+    rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),
+      rpn::type_tag<StFraction>()}, "d5_int_int_int_int_frac");
+
+static const bool sk_fractionImage = rpn::ImageReader::addType("Fraction", [](rpn::ImageReader &r) {
+    int64_t n = r.i64();
+    int64_t d = r.i64();
+    return std::make_unique<StFraction>(n, d);
+  });
 
 #define ADD_FRAC_NUM_WORD(rpn, word_token, method)			\
   rpn.addDefinition(word_token, NATIVE_WORD_WDEF(fraction, frac_validator::d2_frac_int, method##_fn, nullptr)); \
@@ -247,6 +379,7 @@ rpn::Interp::addFractionWords() {
   
   rpn.addDefinition("->FRAC", NATIVE_WORD_WDEF(fraction, rpn::StrictTypeValidator::d2_integer_integer, to_frac_ii, nullptr));
   rpn.addDefinition("->FRAC", NATIVE_WORD_WDEF(fraction, rpn::StrictTypeValidator::d1_double, to_frac_d, nullptr));
+  rpn.addDefinition("->FRAC", NATIVE_WORD_WDEF(fraction, rpn::StrictTypeValidator::d2_integer_double, to_frac_di, nullptr));
   rpn.addDefinition("->FLOAT", NATIVE_WORD_WDEF(fraction, frac_validator::d1_frac, to_float, nullptr));
   rpn.addDefinition("OBJ->", NATIVE_WORD_WDEF(fraction, frac_validator::d1_frac, obj_to, nullptr));
   rpn.addDefinition("INV", NATIVE_WORD_WDEF(fraction, frac_validator::d1_frac, inv_f, nullptr));
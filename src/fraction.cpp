@@ -14,6 +14,9 @@
 
 #include "fraction.h"
 
+#include <cstring>
+#include <cstdint>
+
 /****************************************
  * fraction methods
  */
@@ -26,7 +29,7 @@ operator+(const double &lhs, const q::Fraction &rhs) {
 
 q::Fraction
 operator-(const double &lhs, const q::Fraction &rhs) {
-  return rhs + lhs;
+  return q::Fraction(lhs) - rhs;
 }
 
 q::Fraction
@@ -43,57 +46,118 @@ operator/(const double &lhs, const q::Fraction &rhs) {
 
 double q::Fraction::s_precision = 0.00000000001;
 
-//
-// http://mathforum.org/library/drmath/view/51886.html
-//
-q::Fraction::Fraction(double val) {    // find nearest fraction
-  int sign = (val < 0.) ? -1 : 1;
-  val = fabs(val);
-  int intPart = (int)val;
-  val -= (double)intPart;
-  Fraction low(0, 1);           // "A" = 0/1
-  Fraction high(1, 1);          // "B" = 1/1
-  for (int i = 0; i < 100; ++i) {
-    double testLow = low._denominator * val - low._numerator;
-    double testHigh = high._numerator - high._denominator * val;
-    if (testHigh < s_precision * high._denominator)
-      break; // high is answer
-    if (testLow < s_precision * low._denominator) {  // low is answer
-      high = low;
+int64_t q::Fraction::s_maxDenominator = 0x10000;
+
+/*
+ * rates that are really n/1001, as they're usually typed and as the
+ * nearest double
+ */
+static const struct {
+  double typed;
+  int64_t numerator;
+} sk_broadcastRates[] = {
+  { 23.976, 24000 },
+  { 23.98, 24000 },
+  { 29.97, 30000 },
+  { 47.952, 48000 },
+  { 59.94, 60000 },
+  { 119.88, 120000 },
+};
+
+// continued fraction convergents, finishing with the best semiconvergent
+// when the next convergent's denominator is too big
+static q::Fraction
+best_rational(double val, int64_t maxDenominator, double tolerance) {
+  int64_t h0 = 0, h1 = 1; // numerators
+  int64_t k0 = 1, k1 = 0; // denominators
+  double x = val;
+  for (int i = 0; i < 64; ++i) {
+    double a = std::floor(x);
+    if (a > double(INT64_MAX >> 2) ||
+	(h1 != 0 && a > double((INT64_MAX >> 2) / h1))) {
+      break; // the next numerator won't fit
+    }
+    int64_t ia = int64_t(a);
+    int64_t h2 = ia * h1 + h0;
+    // a denominator that won't fit is past any maxDenominator too
+    bool kOver = k1 != 0 && a > double((INT64_MAX - k0) / k1);
+    int64_t k2 = kOver ? INT64_MAX : ia * k1 + k0;
+    if (kOver || k2 > maxDenominator) {
+      if (k1 != 0) {
+	int64_t t = (maxDenominator - k0) / k1;
+	int64_t hs = t * h1 + h0;
+	int64_t ks = t * k1 + k0;
+	if (ks > 0 && std::fabs(val - double(hs)/double(ks)) < std::fabs(val - double(h1)/double(k1))) {
+	  h1 = hs;
+	  k1 = ks;
+	}
+      }
       break;
     }
-    if (i & 1) {  // odd step: add multiple of low to high
-      double test = testHigh / testLow;
-      int count = (int)test;    // "N"
-      int64_t num = (count + 1) * low._numerator + high._numerator;
-      int64_t denom = (count + 1) * low._denominator + high._denominator;
-      if ((num > 0x8000) ||
-	  (denom > 0x10000))
-	break;
-      high._numerator = num - low._numerator;  // new "A"
-      high._denominator = denom - low._denominator;
-      low._numerator = num;             // new "B"
-      low._denominator = denom;
-    } else {  // even step: add multiple of high to low
-      double test = testLow / testHigh;
-      int count = (int)test;     // "N"
-      int64_t num = low._numerator + (count + 1) * high._numerator;
-      int64_t denom = low._denominator + (count + 1) * high._denominator;
-      if ((num > 0x10000) ||
-	  (denom > 0x10000))
-	break;
-      low._numerator = num - high._numerator;  // new "A"
-      low._denominator = denom - high._denominator;
-      high._numerator = num;            // new "B"
-      high._denominator = denom;
+    h0 = h1; h1 = h2;
+    k0 = k1; k1 = k2;
+    double rem = x - a;
+    if (std::fabs(val - double(h1)/double(k1)) <= tolerance || rem <= 0.) {
+      break;
     }
+    x = 1. / rem;
+  }
+  if (k1 == 0) {
+    // maxDenominator < 1, all that's left is the whole part
+    return q::Fraction(int64_t(val), 1);
+  }
+  return q::Fraction(h1, k1);
+}
+
+q::Fraction
+q::Fraction::approximate(double v, int64_t maxDenominator, double tolerance) {
+  if (std::isnan(v)) {
+    return Fraction(0, 0);
+  }
+  if (std::isinf(v)) {
+    return Fraction((v < 0) ? -1 : 1, 0);
+  }
+
+  // small direct mapped memo, per thread so workers don't contend
+  struct Memo {
+    double v;
+    int64_t maxDenominator;
+    double tolerance;
+    int64_t n, d;
+    bool valid;
+  };
+  thread_local Memo memo[64] = {};
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  Memo &m = memo[(bits ^ (bits >> 29) ^ (bits >> 47)) & 63];
+  if (m.valid && m.v == v && m.maxDenominator == maxDenominator && m.tolerance == tolerance) {
+    return Fraction(m.n, m.d);
+  }
+
+  int sign = (v < 0.) ? -1 : 1;
+  double val = std::fabs(v);
+  Fraction rv(0, 1);
+  if (val >= 0x1p62) {
+    // already a whole number, past 2^63 as close as it gets
+    rv = Fraction(val < 0x1p63 ? int64_t(val) : INT64_MAX, 1);
+  } else {
+    rv = best_rational(val, maxDenominator, tolerance);
   }
-  _numerator = (intPart * high._denominator + high._numerator) * sign;
-  _denominator = high._denominator;
+  rv._numerator *= sign;
 
-  //  Fraction r(intPart, 1) + high;
-  //  _numerator = r._numerator;
-  //  _denominator = r._denominator;
+  m = Memo { v, maxDenominator, tolerance, rv._numerator, rv._denominator, true };
+  return rv;
+}
+
+q::Fraction
+q::Fraction::from_rate(double v) {
+  for (auto const &br : sk_broadcastRates) {
+    double exact = double(br.numerator) / 1001.;
+    if (v == br.typed || std::fabs(v - exact) <= exact * 1e-12) {
+      return Fraction(br.numerator, 1001);
+    }
+  }
+  return approximate(v);
 }
 
 /* end of QInc/Projects/color-calc/src/libs/rpn-lang/src/fraction.cpp */
@@ -21,8 +21,9 @@ namespace q {
 class Fraction {
  public:
   Fraction(int64_t n, int64_t d) : _numerator(n), _denominator(d) {};
-  Fraction(double v);
+  Fraction(double v) : Fraction(approximate(v)) {};
   Fraction(const Fraction &o) : _numerator(o._numerator), _denominator(o._denominator) {};
+  Fraction &operator=(const Fraction &o) = default;
 
   Fraction operator+(const Fraction &rhs) const {
     // not very smart, brute force
@@ -30,8 +31,7 @@ class Fraction {
 		    _denominator * rhs._denominator);
   }
   Fraction operator+(const double &rhs) const {
-    return Fraction(_numerator + rhs*_denominator,
-		    _denominator);
+    return *this + Fraction(rhs);
   }
 
   Fraction operator-(const Fraction &rhs) const {
@@ -39,8 +39,7 @@ class Fraction {
 		    _denominator * rhs._denominator);
   }
   Fraction operator-(const double &rhs) const {
-    return Fraction(_numerator - rhs*_denominator,
-		    _denominator);
+    return *this - Fraction(rhs);
   }
 
   Fraction operator*(const Fraction &rhs) const {
@@ -48,16 +47,14 @@ class Fraction {
 		    _denominator * rhs._denominator);
   }
   Fraction operator*(const double &rhs) const {
-    return Fraction(_numerator*rhs,
-		    _denominator);
+    return *this * Fraction(rhs);
   }
 
   Fraction operator/(const Fraction &rhs) const {
     return *this * rhs.reciprocal();
   }
   Fraction operator/(const double &rhs) const {
-    return Fraction(_numerator,
-		    _denominator*rhs);
+    return *this / Fraction(rhs);
   }
 
   Fraction neg() const {
@@ -86,9 +83,20 @@ class Fraction {
   
   std::string to_string() const { return std::to_string(_numerator) + "/" + std::to_string(_denominator); };
 
+  /*
+   * the closest fraction to v with a denominator no bigger than
+   * maxDenominator, stopping early once it's within tolerance.  each
+   * thread remembers its recent answers
+   */
+  static Fraction approximate(double v, int64_t maxDenominator, double tolerance);
+  static Fraction approximate(double v) { return approximate(v, s_maxDenominator, s_precision); }
+  // v as a frame rate: the broadcast rates (23.976, 29.97, 59.94 ...) are n/1001
+  static Fraction from_rate(double v);
+
   int64_t _numerator;
   int64_t _denominator;
   static double s_precision;
+  static int64_t s_maxDenominator; // for Fraction(double)
 };
 }
 
@@ -119,10 +127,16 @@ namespace stack {
       std::string rv;
       rv += std::to_string(_numerator);
       rv += " ";
-      rv += std::to_string(_numerator);
+      rv += std::to_string(_denominator);
       rv += " ->FRAC";
       return rv;
     }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("Fraction");
+      w.i64(_numerator);
+      w.i64(_denominator);
+      return true;
+    }
   private:
 };
 
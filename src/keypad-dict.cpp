@@ -15,7 +15,7 @@
 #include "../rpn.h"
 
 static const rpn::StrictTypeValidator skAssignValidator({
-    typeid(StString).hash_code(), typeid(StString).hash_code(),typeid(StInteger).hash_code(), typeid(StInteger).hash_code()
+    rpn::type_tag<StString>(), rpn::type_tag<StString>(),rpn::type_tag<StInteger>(), rpn::type_tag<StInteger>()
       }, "skAssignValidator");
 
 NATIVE_WORD_DECL(keypad, ASSIGN_KEY) {
@@ -20,110 +20,59 @@ NATIVE_WORD_DECL(logic, ifte) {
   return rpn::WordDefinition::Result::ok;
 }
 
-NATIVE_WORD_DECL(logic, equal) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
+using Obj = rpn::Stack::Object;
+
+// the registry's operators when both are the same type, the virtuals otherwise
+static bool equal(const Obj &a, const Obj &b) {
+  rpn::TypeTag tag = a.tag();
+  if (tag == b.tag()) {
+    auto fast = rpn::TypeRegistry::ops(tag).equal;
+    if (fast) {
+      return fast(b, a);
+    }
+  }
   try {
-    bool val = (*s1 == *s2);
-    rpn.stack.push_boolean(val);
+    return b == a;
   } catch (...) {
-    rpn.stack.push_boolean(false);
+    return false;
   }
-  return rpn::WordDefinition::Result::ok;
 }
 
-NATIVE_WORD_DECL(logic, not_equal) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
+static bool not_equal(const Obj &a, const Obj &b) {
+  rpn::TypeTag tag = a.tag();
+  if (tag == b.tag()) {
+    auto fast = rpn::TypeRegistry::ops(tag).equal;
+    if (fast) {
+      return !fast(b, a);
+    }
+  }
   try {
-    bool val = !(*s1 == *s2);
-    rpn.stack.push_boolean(val);
+    return !(b == a);
   } catch (...) {
-    rpn.stack.push_boolean(false);
+    return false;
   }
-  return rpn::WordDefinition::Result::ok;
 }
 
-NATIVE_WORD_DECL(logic, greater) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
-  rpn.stack.push_boolean(*s2 > *s1);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, greater_eq) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
-  rpn.stack.push_boolean(!(*s2 < *s1));
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, less) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
-  rpn.stack.push_boolean(*s2 < *s1);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, less_eq) {
-  auto s1 = rpn.stack.pop();
-  auto s2 = rpn.stack.pop();
-  rpn.stack.push_boolean(!(*s2 > *s1));
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, l_not) {
-  auto s1 = rpn.stack.pop_boolean();
-  rpn.stack.push_boolean(!s1);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, l_and) {
-  auto s1 = rpn.stack.pop_boolean();
-  auto s2 = rpn.stack.pop_boolean();
-  rpn.stack.push_boolean(s1 && s2);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, l_or) {
-  auto s1 = rpn.stack.pop_boolean();
-  auto s2 = rpn.stack.pop_boolean();
-  rpn.stack.push_boolean(s1 || s2);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, b_or) {
-  auto s1 = rpn.stack.pop_integer();
-  auto s2 = rpn.stack.pop_integer();
-  rpn.stack.push_integer(s1 | s2);
-  return rpn::WordDefinition::Result::ok;
-}
-NATIVE_WORD_DECL(logic, b_and) {
-  auto s1 = rpn.stack.pop_integer();
-  auto s2 = rpn.stack.pop_integer();
-  rpn.stack.push_integer(s1 & s2);
-  return rpn::WordDefinition::Result::ok;
-}
-NATIVE_WORD_DECL(logic, b_xor) {
-  auto s1 = rpn.stack.pop_integer();
-  auto s2 = rpn.stack.pop_integer();
-  rpn.stack.push_integer(s1 ^ s2);
-  return rpn::WordDefinition::Result::ok;
-}
-NATIVE_WORD_DECL(logic, b_neg) {
-  auto s1 = rpn.stack.pop_integer();
-  rpn.stack.push_integer(~s1);
-  return rpn::WordDefinition::Result::ok;
-}
-
-NATIVE_WORD_DECL(logic, push_true) {
-  rpn.stack.push_boolean(true);
-  return rpn::WordDefinition::Result::ok;
+static bool less(const Obj &a, const Obj &b) {
+  rpn::TypeTag tag = a.tag();
+  if (tag == b.tag()) {
+    auto fast = rpn::TypeRegistry::ops(tag).less;
+    if (fast) {
+      return fast(a, b);
+    }
+  }
+  return a < b;
 }
 
-NATIVE_WORD_DECL(logic, push_false) {
-  rpn.stack.push_boolean(false);
-  return rpn::WordDefinition::Result::ok;
+static bool greater(const Obj &a, const Obj &b) {
+  rpn::TypeTag tag = a.tag();
+  if (tag == b.tag()) {
+    auto fast = rpn::TypeRegistry::ops(tag).less;
+    if (fast) {
+      return fast(b, a);
+    }
+  }
+  return a > b;
 }
 
 void
@@ -132,24 +81,24 @@ rpn::Interp::addLogicWords() {
   //    IFTE
   //    EQ?
   addDefinition("IFTE", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d3_boolean_any_any, ifte, nullptr));
-  addDefinition("==", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, equal, nullptr));
-  addDefinition(">", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, greater, nullptr));
-  addDefinition(">=", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, greater_eq, nullptr));
-  addDefinition("<", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, less, nullptr));
-  addDefinition("<=", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, less_eq, nullptr));
-  addDefinition("!=", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::two, not_equal, nullptr));
-
-  addDefinition("NOT", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d1_boolean, l_not, nullptr));
-  addDefinition("AND", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d2_boolean_boolean, l_and, nullptr));
-  addDefinition("OR", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d2_boolean_boolean, l_or, nullptr));
-
-  addDefinition("NEG", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d1_integer, b_neg, nullptr));
-  addDefinition("AND", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d2_integer_integer, b_and, nullptr));
-  addDefinition("OR", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d2_integer_integer, b_or, nullptr));
-  addDefinition("XOR", NATIVE_WORD_WDEF(logic, rpn::StrictTypeValidator::d2_integer_integer, b_xor, nullptr));
-
-  addDefinition("<true>", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::zero, push_true, nullptr));
-  addDefinition("<false>", NATIVE_WORD_WDEF(logic, rpn::StackSizeValidator::zero, push_false, nullptr));
+  def<bool(const Obj&,const Obj&)>("==", equal);
+  def<bool(const Obj&,const Obj&)>(">", greater);
+  def<bool(const Obj&,const Obj&)>(">=", [](const Obj &a, const Obj &b) { return !less(a, b); });
+  def<bool(const Obj&,const Obj&)>("<", less);
+  def<bool(const Obj&,const Obj&)>("<=", [](const Obj &a, const Obj &b) { return !greater(a, b); });
+  def<bool(const Obj&,const Obj&)>("!=", not_equal);
+
+  def<bool(bool)>("NOT", [](bool a) { return !a; });
+  def<bool(bool,bool)>("AND", [](bool a, bool b) { return a && b; });
+  def<bool(bool,bool)>("OR", [](bool a, bool b) { return a || b; });
+
+  def<int64_t(int64_t)>("NEG", [](int64_t a) { return ~a; });
+  def<int64_t(int64_t,int64_t)>("AND", [](int64_t a, int64_t b) { return a & b; });
+  def<int64_t(int64_t,int64_t)>("OR", [](int64_t a, int64_t b) { return a | b; });
+  def<int64_t(int64_t,int64_t)>("XOR", [](int64_t a, int64_t b) { return a ^ b; });
+
+  def<bool()>("<true>", [] { return true; });
+  def<bool()>("<false>", [] { return false; });
 
 }
 
@@ -13,116 +13,64 @@
  */
 
 #define _USE_MATH_DEFINES // for MSVC
-#define _CRT_RAND_S
 
 #include "../rpn.h"
+#include "fft.h"
+#include "bignum.h"
 
 #include <cmath>
 #include <limits>
 #include <complex>
 
-#if defined (_MSC_VER)
-#include <stdlib.h>
-double drand48() {
-  unsigned int rv=0;
-  rand_s(&rv);
-  return double(rv)/double(UINT_MAX);
-}
-#endif
-
 /****************************************
- * math types
+ * math types, declared in fft.h
  */
-namespace stack {
-  class Complex : public rpn::Stack::Object, public std::complex<double>  {
-  public:
-    Complex() = delete;
-    Complex(double re, double im) : std::complex<double>(re,im) {}
-    Complex(const Complex &cx) : std::complex<double>(cx) {}
-    Complex(const std::complex<double> &cx) : std::complex<double>(cx) {}
-    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
-      auto &rhs = PEEK_CAST(const Complex, orhs);
-      return ((const std::complex<double> &)*this) == ((const std::complex<double> &)rhs);
-    }
-    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Complex>(*this); };
-    virtual operator std::string() const override {
-      std:: string rv = rpn::to_string(this->real());
-      if (this->imag()>0) {
-	rv += "+";
-      }
-      rv += rpn::to_string(this->imag());
-      rv += "i";
-      return rv;
-    }
-  virtual std::string deparse() const override {
-    std::string rv;
-    rv += std::to_string(this->real()) + " ";
-    rv += std::to_string(this->imag()) + " ->COMPLEX";
-    return rv;
-  }
-  private:
-};
+static const rpn::TypeTag sk_complexTag = rpn::TypeRegistry::add<stack::Complex>("Complex");
 
-} // namespace stack
-namespace math_validator {
-  extern const rpn::StrictTypeValidator d1_complex;
-}
-const rpn::StrictTypeValidator math_validator::d1_complex({typeid(stack::Complex).hash_code()}, "d1_complex");
+const rpn::StrictTypeValidator math_validator::d1_complex({rpn::type_tag<stack::Complex>()}, "d1_complex");
+
+static const bool sk_complexImage = rpn::ImageReader::addType("Complex", [](rpn::ImageReader &r) {
+    double re = r.f64();
+    double im = r.f64();
+    return std::make_unique<stack::Complex>(re, im);
+  });
 
 /****************************************
  * math words
  */
-#define MATH_FUNC(op) NATIVE_WORD_FN(math,op)
-#define MATH_GENERATE(fn, val) NATIVE_WORD_FN_0_DOUBLE(math, fn, val)
-#define MATH_UNARY_FUNC(fn) NATIVE_WORD_FN_1_NUMBER(math, fn)
-#define MATH_UNARY_INTEGER_FUNC(fn) NATIVE_WORD_FN_1_INTEGER(math, fn)
-#define MATH_BINARY_FUNC(fn) NATIVE_WORD_FN_2_NUMBER(math, fn)
-#define MATH_BINARY_INTEGER_FUNC(fn) NATIVE_WORD_FN_2_INTEGER(math, fn)
-
-#define MATH_CONSTANT_WDEF(w) NATIVE_WORD_WDEF(math, rpn::StackSizeValidator::zero, w, nullptr)
-#define MATH_WORD_WDEF(validator,w) NATIVE_WORD_WDEF(math, validator, w, nullptr)
-
-// common case for binary function that converts to double except for
-// when both parameters are integers
-#define ADD_MATH_BINARY_NUMBER_WDEF(r, symbol, double_func, integer_func) \
-  ADD_NATIVE_2_NUMBER_WDEF(math, r, symbol, double_func, integer_func, nullptr)
 
-#define ADD_MATH_UNARY_NUMBER_WDEF(r, symbol, double_func, integer_func) \
-  ADD_NATIVE_1_NUMBER_WDEF(math, r, symbol, double_func, integer_func, nullptr)
+// integer words that go to a BigInt instead of wrapping, see bignum.h
+#define MATH_CHECKED_FUNC(fn, checked, op)				\
+  static void fn(rpn::Interp &rpn, int64_t a, int64_t b) {		\
+    int64_t r;								\
+    if (q::checked(a, b, r)) {						\
+      rpn.stack.push_integer(r);					\
+    } else {								\
+      stack::push_exact(rpn.stack, q::BigInt(a) op q::BigInt(b));	\
+    }									\
+  }
 
-static double deg_to_rad(const double &deg) {
+static double deg_to_rad(double deg) {
   return deg * (M_PI / 180.);
 }
-static double rad_to_deg(const double &rad) {
+static double rad_to_deg(double rad) {
   return rad * 180. / M_PI;
 }
 
 static double multiply(double a, double b) {
   return a*b;
 }
-static int64_t imultiply(int64_t a, int64_t b) {
-  return a*b;
-}
-MATH_BINARY_FUNC(multiply);
-MATH_BINARY_INTEGER_FUNC(imultiply);
+MATH_CHECKED_FUNC(imultiply, checked_multiply, *);
 
 static double add(double a, double b) {
   return a+b;
 }
-static int64_t iadd(int64_t a, int64_t b) {
-  return a+b;
-}
-MATH_BINARY_FUNC(add);
-MATH_BINARY_INTEGER_FUNC(iadd);
+MATH_CHECKED_FUNC(iadd, checked_add, +);
 
 static double subtract(double a, double b) {
   return a-b;
 }
-static int64_t isubtract(int64_t a, int64_t b) {
-  return a-b;
-}
-MATH_BINARY_FUNC(subtract);
-MATH_BINARY_INTEGER_FUNC(isubtract);
+MATH_CHECKED_FUNC(isubtract, checked_subtract, -);
 
 static double divide(double a, double b) {
   double rv = std::nan("");
@@ -134,17 +82,16 @@ static double divide(double a, double b) {
   return rv;
 }
 
-static int64_t idivide(int64_t a, int64_t b) {
-  int64_t rv = 0;
-  if (b!=0) {
-    rv = a/b;
+static void idivide(rpn::Interp &rpn, int64_t a, int64_t b) {
+  if (b == 0) {
+    rpn.stack.push_integer((a>0) ? std::numeric_limits<int64_t>::max() : -std::numeric_limits<int64_t>::max());
+  } else if (b == -1) {
+    // the one quotient that doesn't fit
+    stack::push_exact(rpn.stack, -q::BigInt(a));
   } else {
-    rv = (a>0) ? std::numeric_limits<int64_t>::max() : -std::numeric_limits<int64_t>::max();
+    rpn.stack.push_integer(a/b);
   }
-  return rv;
 }
-MATH_BINARY_FUNC(divide);
-MATH_BINARY_INTEGER_FUNC(idivide);
 
 static double inverse(double a) {
   double rv=std::nan("");
@@ -155,62 +102,85 @@ static double inverse(double a) {
   }
   return rv;
 }
-MATH_UNARY_FUNC(inverse);
 
 static double square(double a) {
   return a*a;
 }
-static int64_t isquare(int64_t a) {
-  return a*a;
+static void isquare(rpn::Interp &rpn, int64_t a) {
+  int64_t r;
+  if (q::checked_multiply(a, a, r)) {
+    rpn.stack.push_integer(r);
+  } else {
+    stack::push_exact(rpn.stack, q::BigInt(a) * q::BigInt(a));
+  }
 }
-MATH_UNARY_FUNC(square);
-MATH_UNARY_INTEGER_FUNC(isquare);
 
-MATH_BINARY_FUNC(pow);
-static int64_t ipow(int64_t a, int64_t b) {
-  return (int64_t)pow(a,b);
+// exact for a positive power, squaring in int64_t until it won't fit.  a
+// negative one is a double, but for 1 and -1, and 0 has none
+static rpn::WordDefinition::Result ipow(rpn::Interp &rpn, int64_t b, int64_t e) {
+  if (e >= 0 && std::log2(std::fabs(double(b))) * double(e) > double(q::BigInt::k_maxPowBits)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  if (e < 0) {
+    if (b == 0) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    if (b == 1 || b == -1) {
+      rpn.stack.push_integer((b == -1 && (e & 1) != 0) ? -1 : 1);
+    } else {
+      rpn.stack.push_double(std::pow(double(b), double(e)));
+    }
+    return rpn::WordDefinition::Result::ok;
+  }
+  int64_t r = 1;
+  bool fits = true;
+  for(int64_t sq = b, n = e; fits && n != 0; n >>= 1) {
+    if (n & 1) {
+      fits = q::checked_multiply(r, sq, r);
+    }
+    if (fits && n > 1) {
+      fits = q::checked_multiply(sq, sq, sq);
+    }
+  }
+  if (fits) {
+    rpn.stack.push_integer(r);
+  } else {
+    stack::push_exact(rpn.stack, q::BigInt(b).pow(uint64_t(e)));
+  }
+  return rpn::WordDefinition::Result::ok;
 }
-MATH_BINARY_INTEGER_FUNC(ipow);
 
 static double cos_deg(double a) {
   return cos(deg_to_rad(a));
 }
-MATH_UNARY_FUNC(cos_deg);
 
 static double acos_deg(double a) {
   return rad_to_deg(acos(a));
 }
-MATH_UNARY_FUNC(acos_deg);
 
 static double sin_deg(double a) {
   return sin(deg_to_rad(a));
 }
-MATH_UNARY_FUNC(sin_deg);
 
 static double asin_deg(double a) {
   return rad_to_deg(asin(a));
 }
-MATH_UNARY_FUNC(asin_deg);
 
 static double tan_deg(double a) {
   return tan(deg_to_rad(a));
 }
-MATH_UNARY_FUNC(tan_deg);
 
 static double atan_deg(double a) {
   return rad_to_deg(atan(a));
 }
-MATH_UNARY_FUNC(atan_deg);
 
 static double ln2(double a) {
   return log(a)/log(2.);
 }
-MATH_UNARY_FUNC(ln2);
 
 static double atan2_deg(double a, double b) {
   return rad_to_deg(atan2(a,b));
 }
-MATH_BINARY_FUNC(atan2_deg);
 
 static int64_t imin(int64_t a, int64_t b) {
   return std::min(a,b);
@@ -218,31 +188,8 @@ static int64_t imin(int64_t a, int64_t b) {
 static int64_t imax(int64_t a, int64_t b) {
   return std::max(a,b);
 }
-MATH_BINARY_FUNC(fmin);
-MATH_BINARY_FUNC(fmax);
-MATH_BINARY_INTEGER_FUNC(imin);
-MATH_BINARY_INTEGER_FUNC(imax);
-
-MATH_BINARY_FUNC(hypot);
-MATH_UNARY_FUNC(round);
-MATH_UNARY_FUNC(exp);
-MATH_UNARY_FUNC(ceil);
-MATH_UNARY_FUNC(floor);
-MATH_UNARY_FUNC(log);
-MATH_UNARY_FUNC(log10);
-
-MATH_UNARY_FUNC(deg_to_rad);
-MATH_UNARY_FUNC(rad_to_deg);
-
-MATH_GENERATE(pi, M_PI);
-MATH_GENERATE(e, M_E);
-MATH_GENERATE(rand, rand());
-
-NATIVE_WORD_DECL(math,quadratic) {
-  double c = rpn.stack.pop_as_double();
-  double b = rpn.stack.pop_as_double();
-  double a = rpn.stack.pop_as_double();
 
+static void quadratic(rpn::Interp &rpn, double a, double b, double c) {
   double sq = b*b - 4*a*c;
   if (sq<0) {
     std::complex<double> csq(sq, 0.);
@@ -256,98 +203,92 @@ NATIVE_WORD_DECL(math,quadratic) {
     rpn.stack.push_double(x1);
     rpn.stack.push_double(x2);
   }
-  return rpn::WordDefinition::Result::ok;
 }
 
-NATIVE_WORD_DECL(math,to_complex) {
-  double im = rpn.stack.pop_as_double();
-  double re = rpn.stack.pop_as_double();
-  rpn.stack.push(stack::Complex(re, im));
-  return rpn::WordDefinition::Result::ok;
+static stack::Complex to_complex(double re, double im) {
+  return stack::Complex(re, im);
 }
 
-NATIVE_WORD_DECL(math,complex_to) {
-  auto sob = rpn.stack.pop();
-  const auto &cx = PEEK_CAST(stack::Complex,*sob);
+static void complex_to(rpn::Interp &rpn, const stack::Complex &cx) {
   rpn.stack.push_double(cx.real());
   rpn.stack.push_double(cx.imag());
-  return rpn::WordDefinition::Result::ok;
 }
 
-NATIVE_WORD_DECL(math,sqrt) {
-  double x = rpn.stack.pop_as_double();
+static void square_root(rpn::Interp &rpn, double x) {
   if (x<0) {
     std::complex<double> cx(x, 0.);
     rpn.stack.push(stack::Complex(sqrt(cx)));
   } else {
     rpn.stack.push_double(sqrt(x));
   }
-  return rpn::WordDefinition::Result::ok;
-}
-
-#ifdef WIN32
-double drand48() {
-  return (double)rand()/32767.;
 }
-#endif
-
-MATH_GENERATE(drand, drand48());
 
 static double change_sign(double x) {
   return -1. * x;
 }
-MATH_UNARY_FUNC(change_sign);
-static int64_t ichange_sign(int64_t x) {
-  return -1 * x;
+static void ichange_sign(rpn::Interp &rpn, int64_t x) {
+  int64_t r;
+  if (q::checked_subtract(0, x, r)) {
+    rpn.stack.push_integer(r);
+  } else {
+    stack::push_exact(rpn.stack, -q::BigInt(x));
+  }
 }
-MATH_UNARY_INTEGER_FUNC(ichange_sign);
 
 void
 rpn::Interp::addMathWords() {
   rpn::Interp &rpn(*this);
 
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "+", add, iadd);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "-", subtract, isubtract);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "*", multiply, imultiply);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "/", divide, idivide);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "^", pow, ipow);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "HYPOT", hypot, hypot);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "ATAN2", atan2_deg, atan2_deg);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "MIN", fmin, imin);
-  ADD_MATH_BINARY_NUMBER_WDEF(rpn, "MAX", fmax, imax);
-
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "INV", inverse, inverse);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "SQ", square, isquare);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "SQRT", sqrt, sqrt);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "COS", cos_deg, cos_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "SIN", sin_deg, sin_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "TAN", tan_deg, tan_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "ACOS", acos_deg, acos_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "ASIN", asin_deg, asin_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "ATAN", atan_deg, atan_deg);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "EXP", exp, exp);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "LN", log, log);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "LN2", ln2, ln2);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "LOG", log10, log10);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "CHS", change_sign, ichange_sign);
-
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "D->R", deg_to_rad, deg_to_rad);
-  ADD_MATH_UNARY_NUMBER_WDEF(rpn, "R->D", rad_to_deg, rad_to_deg);
+  // the Integer versions first, the double ones take the mixes that are left
+  rpn.def<void(rpn::Interp&,int64_t,int64_t)>("+", iadd);
+  rpn.def<double(double,double)>("+", add);
+  rpn.def<void(rpn::Interp&,int64_t,int64_t)>("-", isubtract);
+  rpn.def<double(double,double)>("-", subtract);
+  rpn.def<void(rpn::Interp&,int64_t,int64_t)>("*", imultiply);
+  rpn.def<double(double,double)>("*", multiply);
+  rpn.def<void(rpn::Interp&,int64_t,int64_t)>("/", idivide);
+  rpn.def<double(double,double)>("/", divide);
+  rpn.def<rpn::WordDefinition::Result(rpn::Interp&,int64_t,int64_t)>("^", ipow);
+  rpn.def<double(double,double)>("^", pow);
+  rpn.def<double(double,double)>("HYPOT", hypot);
+  rpn.def<double(double,double)>("ATAN2", atan2_deg);
+  rpn.def<int64_t(int64_t,int64_t)>("MIN", imin);
+  rpn.def<double(double,double)>("MIN", fmin);
+  rpn.def<int64_t(int64_t,int64_t)>("MAX", imax);
+  rpn.def<double(double,double)>("MAX", fmax);
+
+  rpn.def<double(double)>("INV", inverse);
+  rpn.def<void(rpn::Interp&,int64_t)>("SQ", isquare);
+  rpn.def<double(double)>("SQ", square);
+  rpn.def<void(rpn::Interp&,double)>("SQRT", square_root);
+  rpn.def<double(double)>("COS", cos_deg);
+  rpn.def<double(double)>("SIN", sin_deg);
+  rpn.def<double(double)>("TAN", tan_deg);
+  rpn.def<double(double)>("ACOS", acos_deg);
+  rpn.def<double(double)>("ASIN", asin_deg);
+  rpn.def<double(double)>("ATAN", atan_deg);
+  rpn.def<double(double)>("EXP", exp);
+  rpn.def<double(double)>("LN", log);
+  rpn.def<double(double)>("LN2", ln2);
+  rpn.def<double(double)>("LOG", log10);
+  rpn.def<void(rpn::Interp&,int64_t)>("CHS", ichange_sign);
+  rpn.def<double(double)>("CHS", change_sign);
+
+  rpn.def<double(double)>("D->R", deg_to_rad);
+  rpn.def<double(double)>("R->D", rad_to_deg);
 
   // these don't really make sense on Integers, but maybe we should
   // allow it anyway?
-  addDefinition("ROUND", MATH_WORD_WDEF(rpn::StrictTypeValidator::d1_double, round));
-  addDefinition("CEIL", MATH_WORD_WDEF(rpn::StrictTypeValidator::d1_double, ceil));
-  addDefinition("FLOOR", MATH_WORD_WDEF(rpn::StrictTypeValidator::d1_double, floor));
-
-  ADD_NATIVE_3_NUMBER_WDEF(math, rpn, "QUAD", quadratic, quadratic, nullptr);
-  ADD_NATIVE_2_NUMBER_WDEF(math, rpn, "->COMPLEX", to_complex, to_complex, nullptr);
-  addDefinition("OBJ->", MATH_WORD_WDEF(math_validator::d1_complex, complex_to));
-
-  addDefinition("k_PI", MATH_CONSTANT_WDEF(pi));
-  addDefinition("k_E", MATH_CONSTANT_WDEF(e));
-  addDefinition("RAND", MATH_CONSTANT_WDEF(rand));
-  addDefinition("DRAND", MATH_CONSTANT_WDEF(drand));
+  rpn.def<double(const StDouble&)>("ROUND", [](const StDouble &x) { return round(x.val()); });
+  rpn.def<double(const StDouble&)>("CEIL", [](const StDouble &x) { return ceil(x.val()); });
+  rpn.def<double(const StDouble&)>("FLOOR", [](const StDouble &x) { return floor(x.val()); });
+
+  rpn.def<void(rpn::Interp&,double,double,double)>("QUAD", quadratic);
+  rpn.def<stack::Complex(double,double)>("->COMPLEX", to_complex);
+  rpn.def<void(rpn::Interp&,const stack::Complex&)>("OBJ->", complex_to);
+
+  rpn.def<double()>("k_PI", [] { return M_PI; });
+  rpn.def<double()>("k_E", [] { return M_E; });
 
   //  rpn.addDefinition("LSHIFT", MATH_BINARY_DEF(lshift)); // integer
   //  rpn.addDefinition("RSHIFT", MATH_BINARY_DEF(rshift)); // integer
@@ -0,0 +1,221 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/matrix-dict.cpp
+ *
+ * @file    matrix-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "matrix.h"
+#include "vec3.h"
+
+using StMatrix = stack::Matrix;
+using StVec3Array = stack::Vec3Array;
+
+static bool
+is_number(const rpn::Stack::Object &o) {
+  return o.tag() == rpn::tt_double || o.tag() == rpn::tt_integer;
+}
+
+static std::unique_ptr<StArray>
+to_doubles(const double *v, size_t n) {
+  StArray::Elements rv;
+  rv.reserve(n);
+  for(size_t i=0; i<n; i++) {
+    rv.push_back(std::make_unique<StDouble>(v[i]));
+  }
+  return std::make_unique<StArray>(std::move(rv));
+}
+
+// ( [rows] -- matrix ) every row an array of the same number of numbers
+NATIVE_WORD_DECL(matrix, to_matrix) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &rows = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  if (rows.size() == 0 || rows.value(0).tag() != rpn::tt_array) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  size_t cols = static_cast<const StArray&>(rows.value(0)).size();
+  q::Matrix m(rows.size(), cols);
+  for(size_t r=0; r<rows.size(); r++) {
+    if (rows.value(r).tag() != rpn::tt_array) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    const auto &row = static_cast<const StArray&>(rows.value(r));
+    if (row.size() != cols) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    for(size_t c=0; c<cols; c++) {
+      if (!is_number(row.value(c))) {
+	return rpn::WordDefinition::Result::param_error;
+      }
+      m(r,c) = double(row.value(c));
+    }
+  }
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StMatrix>(std::move(m)));
+  return rv;
+}
+
+// ( matrix -- [rows] )
+NATIVE_WORD_DECL(matrix, matrix_to) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto om = rpn.stack.pop();
+  const auto &m = POP_CAST(StMatrix,om).val();
+  StArray::Elements rows;
+  rows.reserve(m.rows);
+  for(size_t r=0; r<m.rows; r++) {
+    rows.push_back(to_doubles(m.row(r), m.cols));
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(rows)));
+  return rv;
+}
+
+// ( l r -- l*r )
+NATIVE_WORD_DECL(matrix, matmul) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &l = PEEK_CAST(const StMatrix,rpn.stack.peek_const(2)).val();
+  const auto &r = PEEK_CAST(const StMatrix,rpn.stack.peek_const(1)).val();
+  if (l.cols != r.rows) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  q::Matrix p = q::multiply(l, r);
+  rpn.stack.pop();
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StMatrix>(std::move(p)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(matrix, transpose) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto om = rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StMatrix>(q::transpose(POP_CAST(StMatrix,om).val())));
+  return rv;
+}
+
+NATIVE_WORD_DECL(matrix, inv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &m = PEEK_CAST(const StMatrix,rpn.stack.peek_const(1)).val();
+  q::Matrix inv;
+  if (m.rows != m.cols || !q::inverse(m, inv)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StMatrix>(std::move(inv)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(matrix, det) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &m = PEEK_CAST(const StMatrix,rpn.stack.peek_const(1)).val();
+  if (m.rows != m.cols) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  double d = q::determinant(m);
+  rpn.stack.pop();
+  rpn.stack.push_double(d);
+  return rv;
+}
+
+// ( A B -- X ) where AX = B
+NATIVE_WORD_DECL(matrix, solve) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &a = PEEK_CAST(const StMatrix,rpn.stack.peek_const(2)).val();
+  const auto &b = PEEK_CAST(const StMatrix,rpn.stack.peek_const(1)).val();
+  q::Matrix x;
+  if (a.rows != a.cols || b.rows != a.rows || !q::solve(q::decompose(a), b, x)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StMatrix>(std::move(x)));
+  return rv;
+}
+
+// ( A [b] -- [x] ) where Ax = b
+NATIVE_WORD_DECL(matrix, solve_a) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &a = PEEK_CAST(const StMatrix,rpn.stack.peek_const(2)).val();
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  if (a.rows != a.cols || arr.size() != a.rows) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  q::Matrix b(arr.size(), 1);
+  for(size_t i=0; i<arr.size(); i++) {
+    if (!is_number(arr.value(i))) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    b(i,0) = double(arr.value(i));
+  }
+  q::Matrix x;
+  if (!q::solve(q::decompose(a), b, x)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  rpn.stack.pop();
+  rpn.stack.push(to_doubles(x.a.data(), x.rows));
+  return rv;
+}
+
+// ( v matrix -- v' ) a 3x4 or 4x4 affine transform, see vec3.h
+NATIVE_WORD_DECL(matrix, transform) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &m = PEEK_CAST(const StMatrix,rpn.stack.peek_const(1)).val();
+  if (m.cols != 4 || (m.rows != 3 && m.rows != 4)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  double t[16] = { 0 };
+  std::copy(m.a.begin(), m.a.end(), t);
+  rpn.stack.pop();
+  auto ov = rpn.stack.pop();
+  if (ov->tag() == rpn::type_tag<StVec3Array>()) {
+    rpn.stack.push(std::make_unique<StVec3Array>(q::transform(POP_CAST(StVec3Array,ov).val(), t)));
+  } else {
+    const auto &v = POP_CAST(StVec3,ov);
+    q::Vec3s p = q::transform(q::Vec3s(v._x, v._y, v._z), t);
+    rpn.stack.push(StVec3(p.x[0], p.y[0], p.z[0]));
+  }
+  return rv;
+}
+
+void
+rpn::Interp::addMatrixWords() {
+  rpn::Interp &rpn = *this; // in case we want to move this out someday
+  rpn.addDefinition("->MATRIX", NATIVE_WORD_WDEF(matrix, rpn::StrictTypeValidator::d1_array, to_matrix, nullptr));
+  rpn.addDefinition("MATRIX->", NATIVE_WORD_WDEF(matrix, matrix_validator::d1_matrix, matrix_to, nullptr));
+  rpn.addDefinition("OBJ->", NATIVE_WORD_WDEF(matrix, matrix_validator::d1_matrix, matrix_to, nullptr));
+  rpn.addDefinition("MATMUL", NATIVE_WORD_WDEF(matrix, matrix_validator::d2_matrix_matrix, matmul, nullptr));
+  rpn.addDefinition("TRANSPOSE", NATIVE_WORD_WDEF(matrix, matrix_validator::d1_matrix, transpose, nullptr));
+  rpn.addDefinition("INV", NATIVE_WORD_WDEF(matrix, matrix_validator::d1_matrix, inv, nullptr));
+  rpn.addDefinition("DET", NATIVE_WORD_WDEF(matrix, matrix_validator::d1_matrix, det, nullptr));
+  rpn.addDefinition("SOLVE", NATIVE_WORD_WDEF(matrix, matrix_validator::d2_matrix_matrix, solve, nullptr));
+  rpn.addDefinition("SOLVE", NATIVE_WORD_WDEF(matrix, matrix_validator::d2_array_matrix, solve_a, nullptr));
+  rpn.addDefinition("TRANSFORM", NATIVE_WORD_WDEF(matrix, matrix_validator::d2_matrix_v3a, transform, nullptr));
+  rpn.addDefinition("TRANSFORM", NATIVE_WORD_WDEF(matrix, matrix_validator::d2_matrix_vec3, transform, nullptr));
+}
+
+static const rpn::TypeTag sk_matrixTag = rpn::TypeRegistry::add<StMatrix>("Matrix");
+
+const rpn::StrictTypeValidator matrix_validator::d1_matrix({rpn::type_tag<StMatrix>()}, "d1_matrix");
+const rpn::StrictTypeValidator matrix_validator::d2_matrix_matrix({rpn::type_tag<StMatrix>(),rpn::type_tag<StMatrix>()}, "d2_matrix_matrix");
+const rpn::StrictTypeValidator matrix_validator::d2_array_matrix({rpn::type_tag<StArray>(),rpn::type_tag<StMatrix>()}, "d2_array_matrix");
+const rpn::StrictTypeValidator matrix_validator::d2_matrix_v3a({rpn::type_tag<StMatrix>(),rpn::type_tag<StVec3Array>()}, "d2_matrix_v3a");
+const rpn::StrictTypeValidator matrix_validator::d2_matrix_vec3({rpn::type_tag<StMatrix>(),rpn::type_tag<StVec3>()}, "d2_matrix_vec3");
+
+static const bool sk_matrixImage = rpn::ImageReader::addType("Matrix", [](rpn::ImageReader &r) {
+    size_t rows = r.u32();
+    size_t cols = r.u32();
+    q::Matrix m(rows, cols);
+    for(auto &e : m.a) {
+      e = r.f64();
+    }
+    return std::make_unique<StMatrix>(std::move(m));
+  });
+
+/* end of qinc/rpn-lang/src/matrix-dict.cpp */
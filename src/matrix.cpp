@@ -0,0 +1,183 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/matrix.cpp
+ *
+ * @file    matrix.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "matrix.h"
+#include "simd.h"
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+// dst += s * src
+static void
+axpy(size_t n, double s, const double *RESTRICT src, double *RESTRICT dst) {
+  for(size_t j=0; j<n; j++) {
+    dst[j] += s * src[j];
+  }
+}
+
+static void
+scale(size_t n, double s, double *RESTRICT v) {
+  for(size_t j=0; j<n; j++) {
+    v[j] *= s;
+  }
+}
+
+q::Matrix
+q::Matrix::identity(size_t n) {
+  q::Matrix rv(n, n);
+  for(size_t i=0; i<n; i++) {
+    rv(i,i) = 1.;
+  }
+  return rv;
+}
+
+/****************************************
+ * multiply and transpose
+ *
+ * blocked so a tile of each operand stays in cache.  64x64 doubles is
+ * 32K, anything we see in practice is a single tile.
+ */
+static const size_t sk_block = 64;
+
+q::Matrix
+q::multiply(const q::Matrix &l, const q::Matrix &r) {
+  size_t n = l.rows;
+  size_t m = l.cols;
+  size_t p = r.cols;
+  q::Matrix rv(n, p);
+  for(size_t i0=0; i0<n; i0+=sk_block) {
+    size_t i1 = std::min(i0+sk_block, n);
+    for(size_t k0=0; k0<m; k0+=sk_block) {
+      size_t k1 = std::min(k0+sk_block, m);
+      for(size_t j0=0; j0<p; j0+=sk_block) {
+	size_t jn = std::min(j0+sk_block, p) - j0;
+	for(size_t i=i0; i<i1; i++) {
+	  double *c = rv.row(i) + j0;
+	  for(size_t k=k0; k<k1; k++) {
+	    axpy(jn, l(i,k), r.row(k) + j0, c);
+	  }
+	}
+      }
+    }
+  }
+  return rv;
+}
+
+q::Matrix
+q::transpose(const q::Matrix &m) {
+  q::Matrix rv(m.cols, m.rows);
+  for(size_t i0=0; i0<m.rows; i0+=sk_block) {
+    size_t i1 = std::min(i0+sk_block, m.rows);
+    for(size_t j0=0; j0<m.cols; j0+=sk_block) {
+      size_t j1 = std::min(j0+sk_block, m.cols);
+      for(size_t i=i0; i<i1; i++) {
+	for(size_t j=j0; j<j1; j++) {
+	  rv(j,i) = m(i,j);
+	}
+      }
+    }
+  }
+  return rv;
+}
+
+/****************************************
+ * LU
+ */
+q::LU
+q::decompose(const q::Matrix &m) {
+  size_t n = m.rows;
+  q::LU rv;
+  rv.lu = m;
+  rv.perm.resize(n);
+  for(size_t i=0; i<n; i++) {
+    rv.perm[i] = i;
+  }
+  q::Matrix &a = rv.lu;
+  for(size_t k=0; k<n; k++) {
+    size_t pivot = k;
+    double big = std::fabs(a(k,k));
+    for(size_t i=k+1; i<n; i++) {
+      if (std::fabs(a(i,k)) > big) {
+	big = std::fabs(a(i,k));
+	pivot = i;
+      }
+    }
+    if (big == 0.) {
+      rv.singular = true;
+      continue;
+    }
+    if (pivot != k) {
+      std::swap_ranges(a.row(k), a.row(k)+n, a.row(pivot));
+      std::swap(rv.perm[k], rv.perm[pivot]);
+      rv.sign = -rv.sign;
+    }
+    double d = a(k,k);
+    for(size_t i=k+1; i<n; i++) {
+      double f = a(i,k) / d;
+      a(i,k) = f;
+      axpy(n-k-1, -f, a.row(k)+k+1, a.row(i)+k+1);
+    }
+  }
+  return rv;
+}
+
+double
+q::determinant(const q::Matrix &m) {
+  q::LU lu = decompose(m);
+  if (lu.singular) {
+    return 0.;
+  }
+  double rv = lu.sign;
+  for(size_t i=0; i<m.rows; i++) {
+    rv *= lu.lu(i,i);
+  }
+  return rv;
+}
+
+// every column of b at once, a row at a time
+bool
+q::solve(const q::LU &lu, const q::Matrix &b, q::Matrix &x) {
+  if (lu.singular) {
+    return false;
+  }
+  const q::Matrix &a = lu.lu;
+  size_t n = a.rows;
+  size_t k = b.cols;
+  x = q::Matrix(n, k);
+  for(size_t i=0; i<n; i++) {
+    std::copy(b.row(lu.perm[i]), b.row(lu.perm[i])+k, x.row(i));
+  }
+  // L y = P b
+  for(size_t i=1; i<n; i++) {
+    for(size_t j=0; j<i; j++) {
+      axpy(k, -a(i,j), x.row(j), x.row(i));
+    }
+  }
+  // U x = y
+  for(size_t i=n; i-- > 0; ) {
+    for(size_t j=i+1; j<n; j++) {
+      axpy(k, -a(i,j), x.row(j), x.row(i));
+    }
+    scale(k, 1./a(i,i), x.row(i));
+  }
+  return true;
+}
+
+bool
+q::inverse(const q::Matrix &m, q::Matrix &inv) {
+  return solve(decompose(m), q::Matrix::identity(m.rows), inv);
+}
+
+/* end of qinc/rpn-lang/src/matrix.cpp */
@@ -0,0 +1,123 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/matrix.h
+ *
+ * @file    matrix.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace q {
+  /*
+   * a dense, row-major matrix of doubles
+   */
+  struct Matrix {
+    Matrix() = default;
+    Matrix(size_t r, size_t c) : rows(r), cols(c), a(r*c, 0.) {}
+    static Matrix identity(size_t n);
+    double &operator()(size_t r, size_t c) { return a[r*cols+c]; }
+    double operator()(size_t r, size_t c) const { return a[r*cols+c]; }
+    double *row(size_t r) { return a.data() + r*cols; }
+    const double *row(size_t r) const { return a.data() + r*cols; }
+    bool operator==(const Matrix &rhs) const { return rows == rhs.rows && cols == rhs.cols && a == rhs.a; }
+
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<double> a;
+  };
+
+  // l.cols has to be r.rows
+  Matrix multiply(const Matrix &l, const Matrix &r);
+  Matrix transpose(const Matrix &m);
+
+  /*
+   * PA = LU with partial pivoting, both packed into lu with L's unit
+   * diagonal left out.  row i of lu came from row perm[i] of A
+   */
+  struct LU {
+    Matrix lu;
+    std::vector<size_t> perm;
+    int sign = 1;        // of the permutation
+    bool singular = false;
+  };
+  // m has to be square
+  LU decompose(const Matrix &m);
+  double determinant(const Matrix &m);
+  // false if m is singular
+  bool solve(const LU &lu, const Matrix &b, Matrix &x);
+  bool inverse(const Matrix &m, Matrix &inv);
+}
+
+#ifdef _RPN_LANG_RPN_H_
+namespace stack {
+  /*
+   * copies share the elements
+   */
+  class Matrix : public rpn::Stack::Object {
+  public:
+    Matrix() : _v(std::make_shared<q::Matrix>()) {}
+    Matrix(q::Matrix &&m) : _v(std::make_shared<q::Matrix>(std::move(m))) {}
+    Matrix(const Matrix &m) = default;
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const Matrix, orhs);
+      return _v == rhs._v || *_v == *rhs._v;
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Matrix>(*this); };
+    virtual operator std::string() const override {
+      std::string rv = "[";
+      for(size_t r=0; r<_v->rows; r++) {
+	rv += "[";
+	for(size_t c=0; c<_v->cols; c++) {
+	  rv += rpn::to_string((*_v)(r,c));
+	  rv += ", ";
+	}
+	rv += "], ";
+      }
+      rv += "]";
+      return rv;
+    }
+    virtual std::string deparse() const override {
+      std::string rv;
+      for(size_t r=0; r<_v->rows; r++) {
+	for(size_t c=0; c<_v->cols; c++) {
+	  rv += std::to_string((*_v)(r,c)) + " ";
+	}
+	rv += std::to_string(_v->cols) + " ->ARRAY ";
+      }
+      rv += std::to_string(_v->rows) + " ->ARRAY ->MATRIX";
+      return rv;
+    }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("Matrix");
+      w.u32(uint32_t(_v->rows));
+      w.u32(uint32_t(_v->cols));
+      for(auto const &e : _v->a) {
+	w.f64(e);
+      }
+      return true;
+    }
+    const q::Matrix &val() const { return *_v; }
+  private:
+    std::shared_ptr<q::Matrix> _v;
+  };
+} // namespace stack
+
+namespace matrix_validator {
+  extern const rpn::StrictTypeValidator d1_matrix;
+  extern const rpn::StrictTypeValidator d2_matrix_matrix;
+  extern const rpn::StrictTypeValidator d2_array_matrix;
+  extern const rpn::StrictTypeValidator d2_matrix_v3a;
+  extern const rpn::StrictTypeValidator d2_matrix_vec3;
+}
+#endif
+
+/* end of qinc/rpn-lang/src/matrix.h */
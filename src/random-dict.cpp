@@ -0,0 +1,91 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/random-dict.cpp
+ *
+ * @file    random-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "random.h"
+
+#include <vector>
+
+// ( seed -- )
+NATIVE_WORD_DECL(random, seed) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn.random().seed(uint64_t(rpn.stack.pop_integer()));
+  return rv;
+}
+
+// ( -- x ) a whole number in [0,2^31) like rand() was
+NATIVE_WORD_DECL(random, rand) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn.stack.push_double(double(rpn.random().next() >> 33));
+  return rv;
+}
+
+// ( -- x ) [0,1)
+NATIVE_WORD_DECL(random, drand) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn.stack.push_double(rpn.random().uniform());
+  return rv;
+}
+
+// ( -- x ) mean 0, standard deviation 1
+NATIVE_WORD_DECL(random, nrand) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn.stack.push_double(rpn.random().normal());
+  return rv;
+}
+
+static rpn::WordDefinition::Result
+push_samples(rpn::Interp &rpn, bool normal) {
+  if (int64_t(PEEK_CAST(const StInteger,rpn.stack.peek_const(1))) < 0) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  size_t n = size_t(rpn.stack.pop_integer());
+  std::vector<double> v(n);
+  if (normal) {
+    rpn.random().normal(v.data(), n);
+  } else {
+    rpn.random().uniform(v.data(), n);
+  }
+  StArray::Elements rv;
+  rv.reserve(n);
+  for(auto d : v) {
+    rv.push_back(std::make_unique<StDouble>(d));
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(rv)));
+  return rpn::WordDefinition::Result::ok;
+}
+
+// ( n -- [x...] ) n DRANDs
+NATIVE_WORD_DECL(random, rands) {
+  return push_samples(rpn, false);
+}
+
+// ( n -- [x...] ) n NRANDs
+NATIVE_WORD_DECL(random, nrands) {
+  return push_samples(rpn, true);
+}
+
+void
+rpn::Interp::addRandomWords() {
+  rpn::Interp &rpn = *this; // in case we want to move this out someday
+
+  rpn.addDefinition("SEED", NATIVE_WORD_WDEF(random, rpn::StrictTypeValidator::d1_integer, seed, nullptr));
+  rpn.addDefinition("RAND", NATIVE_WORD_WDEF(random, rpn::StackSizeValidator::zero, rand, nullptr));
+  rpn.addDefinition("DRAND", NATIVE_WORD_WDEF(random, rpn::StackSizeValidator::zero, drand, nullptr));
+  rpn.addDefinition("NRAND", NATIVE_WORD_WDEF(random, rpn::StackSizeValidator::zero, nrand, nullptr));
+  rpn.addDefinition("RANDS", NATIVE_WORD_WDEF(random, rpn::StrictTypeValidator::d1_integer, rands, nullptr));
+  rpn.addDefinition("NRANDS", NATIVE_WORD_WDEF(random, rpn::StrictTypeValidator::d1_integer, nrands, nullptr));
+}
+
+/* end of qinc/rpn-lang/src/random-dict.cpp */
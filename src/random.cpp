@@ -0,0 +1,165 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/random.cpp
+ *
+ * @file    random.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#define _USE_MATH_DEFINES // for MSVC
+
+#include "random.h"
+#include "simd.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+// seeds xoshiro, any seed including 0 comes out as a good state
+static uint64_t
+splitmix64(uint64_t &x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+q::Random::Random() {
+  std::random_device rd;
+  seed((uint64_t(rd()) << 32) | rd());
+}
+
+void
+q::Random::seed(uint64_t s) {
+  for(auto &w : _s) {
+    w = splitmix64(s);
+  }
+  _haveSpare = false;
+}
+
+void
+q::Random::seed(uint64_t s, uint64_t stream) {
+  uint64_t x = s;
+  seed(splitmix64(x) ^ (stream * 0xd1b54a32d192ed03ull));
+}
+
+void
+q::Random::jump() {
+  static const uint64_t sk_jump[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+  uint64_t s[4] = { 0, 0, 0, 0 };
+  for(auto j : sk_jump) {
+    for(int b=0; b<64; b++) {
+      if (j & (uint64_t(1) << b)) {
+	for(int i=0; i<4; i++) {
+	  s[i] ^= _s[i];
+	}
+      }
+      next();
+    }
+  }
+  std::memcpy(_s, s, sizeof(_s));
+}
+
+/*
+ * Box-Muller, the second of each pair is kept for the next call
+ */
+double
+q::Random::normal() {
+  if (_haveSpare) {
+    _haveSpare = false;
+    return _spare;
+  }
+  double r = std::sqrt(-2. * std::log(1. - uniform())); // 1-u is never 0
+  double theta = 2. * M_PI * uniform();
+  _spare = r * std::sin(theta);
+  _haveSpare = true;
+  return r * std::cos(theta);
+}
+
+/****************************************
+ * bulk
+ *
+ * sk_lanes generators a jump() apart, kept as four arrays of state
+ * words so each step is the same handful of shifts, xors and adds
+ * across all the lanes (the *5 and *9 spelled as shifts and adds).  the
+ * top 52 bits go straight into a double's mantissa rather than through
+ * an integer conversion the vector units don't have
+ */
+static const size_t sk_lanes = 8;
+static const size_t sk_bulk = 64; // below this the lanes aren't worth setting up
+
+struct Lanes {
+  uint64_t s0[sk_lanes], s1[sk_lanes], s2[sk_lanes], s3[sk_lanes];
+};
+
+static void
+step(Lanes &l, double *RESTRICT out) {
+  uint64_t *RESTRICT s0 = l.s0;
+  uint64_t *RESTRICT s1 = l.s1;
+  uint64_t *RESTRICT s2 = l.s2;
+  uint64_t *RESTRICT s3 = l.s3;
+  uint64_t bits[sk_lanes];
+  for(size_t k=0; k<sk_lanes; k++) {
+    uint64_t m = s1[k] + (s1[k] << 2);       // *5
+    uint64_t r = (m << 7) | (m >> 57);
+    r += r << 3;                             // *9
+    uint64_t t = s1[k] << 17;
+    s2[k] ^= s0[k];
+    s3[k] ^= s1[k];
+    s1[k] ^= s2[k];
+    s0[k] ^= s3[k];
+    s2[k] ^= t;
+    s3[k] = (s3[k] << 45) | (s3[k] >> 19);
+    bits[k] = (r >> 12) | 0x3ff0000000000000ull; // [1,2)
+  }
+  double d[sk_lanes];
+  std::memcpy(d, bits, sizeof(d));
+  for(size_t k=0; k<sk_lanes; k++) {
+    out[k] = d[k] - 1.;
+  }
+}
+
+void
+q::Random::uniform(double *out, size_t n) {
+  size_t i = 0;
+  if (n >= sk_bulk) {
+    Lanes l;
+    for(size_t k=0; k<sk_lanes; k++) {
+      l.s0[k] = _s[0];
+      l.s1[k] = _s[1];
+      l.s2[k] = _s[2];
+      l.s3[k] = _s[3];
+      jump();
+    }
+    for(; i+sk_lanes <= n; i+=sk_lanes) {
+      step(l, out+i);
+    }
+  }
+  for(; i<n; i++) {
+    out[i] = uniform();
+  }
+}
+
+void
+q::Random::normal(double *out, size_t n) {
+  uniform(out, n);
+  // pairs of uniforms become pairs of normals in place
+  size_t i = 0;
+  for(; i+2 <= n; i+=2) {
+    double r = std::sqrt(-2. * std::log(1. - out[i]));
+    double theta = 2. * M_PI * out[i+1];
+    out[i] = r * std::cos(theta);
+    out[i+1] = r * std::sin(theta);
+  }
+  if (i < n) {
+    out[i] = normal();
+  }
+}
+
+/* end of qinc/rpn-lang/src/random.cpp */
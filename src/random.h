@@ -0,0 +1,64 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/random.h
+ *
+ * @file    random.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace q {
+  /*
+   * xoshiro256** (Blackman & Vigna).  every Interp has its own, so
+   * there's no shared state and a SEED makes a session repeatable
+   */
+  class Random {
+  public:
+    Random();                     // from std::random_device
+    explicit Random(uint64_t s) { seed(s); }
+
+    void seed(uint64_t s);
+    // stream i of seed s, each apply() iteration gets its own
+    void seed(uint64_t s, uint64_t stream);
+
+    uint64_t next() {
+      uint64_t rv = rotl(_s[1] * 5, 7) * 9;
+      uint64_t t = _s[1] << 17;
+      _s[2] ^= _s[0];
+      _s[3] ^= _s[1];
+      _s[1] ^= _s[2];
+      _s[0] ^= _s[3];
+      _s[2] ^= t;
+      _s[3] = rotl(_s[3], 45);
+      return rv;
+    }
+    // [0,1)
+    double uniform() { return double(next() >> 11) * (1. / 9007199254740992.); }
+    // mean 0, standard deviation 1
+    double normal();
+
+    // n at a time, several generators side by side so it vectorizes
+    void uniform(double *out, size_t n);
+    void normal(double *out, size_t n);
+
+    // as if next() had been called 2^128 times
+    void jump();
+
+  private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t _s[4];
+    bool _haveSpare = false; // normal() makes two at a time
+    double _spare = 0.;
+  };
+}
+
+/* end of qinc/rpn-lang/src/random.h */
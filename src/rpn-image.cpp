@@ -0,0 +1,221 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/rpn-image.cpp
+ *
+ * @file    rpn-image.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+
+#include <cstring>
+#include <typeinfo>
+#include <fstream>
+#include <sstream>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * image layout (native byte order, checked with the order mark)
+ *
+ *   "RPNI" <u32 version> <u32 order mark>
+ *   sections, written and read by rpn::Interp::saveImage/loadImage
+ *
+ * records:
+ *   <str type> <u32 payload length> <payload>
+ */
+static const char sk_magic[4] = { 'R', 'P', 'N', 'I' };
+static const uint32_t sk_orderMark = 0x01020304;
+
+const uint32_t rpn::ImageWriter::version = 1;
+
+uint64_t
+rpn::ImageWriter::hash(const std::string &bytes, uint64_t h) {
+  for(unsigned char c : bytes) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+void
+rpn::ImageWriter::header() {
+  raw(sk_magic, sizeof(sk_magic));
+  u32(version);
+  u32(sk_orderMark);
+}
+
+void
+rpn::ImageWriter::record(const std::string &type) {
+  str(type);
+  _open.push_back(_buf.size());
+  u32(0); // patched by object()
+}
+
+void
+rpn::ImageWriter::object(const rpn::Stack::Object &ob) {
+  size_t depth = _open.size();
+  if (!ob.image(*this) || _open.size() != depth+1) {
+    throw std::runtime_error(std::string("can't image ") + typeid(ob).name());
+  }
+  size_t at = _open.back();
+  _open.pop_back();
+  uint32_t len = uint32_t(_buf.size() - (at + sizeof(uint32_t)));
+  memcpy(&_buf[at], &len, sizeof(len));
+}
+
+bool
+rpn::ImageWriter::write(const std::string &path) const {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs.write(_buf.data(), _buf.size());
+  return bool(ofs);
+}
+
+static std::map<std::string,rpn::ImageReader::Loader> &
+loaders() {
+  static std::map<std::string,rpn::ImageReader::Loader> sk_loaders;
+  return sk_loaders;
+}
+
+bool
+rpn::ImageReader::addType(const std::string &type, const Loader &loader) {
+  return loaders().emplace(type, loader).second;
+}
+
+void
+rpn::ImageReader::raw(void *p, size_t n) {
+  if (size_t(_end - _p) < n) {
+    throw std::runtime_error("image truncated");
+  }
+  memcpy(p, _p, n);
+  _p += n;
+}
+
+std::string
+rpn::ImageReader::str() {
+  uint32_t len = u32();
+  if (size_t(_end - _p) < len) {
+    throw std::runtime_error("image truncated");
+  }
+  std::string rv(_p, len);
+  _p += len;
+  return rv;
+}
+
+bool
+rpn::ImageReader::header() {
+  char magic[sizeof(sk_magic)];
+  raw(magic, sizeof(magic));
+  uint32_t version = u32();
+  uint32_t order = u32();
+  return (memcmp(magic, sk_magic, sizeof(sk_magic)) == 0 &&
+	  version == rpn::ImageWriter::version &&
+	  order == sk_orderMark);
+}
+
+std::unique_ptr<rpn::Stack::Object>
+rpn::ImageReader::object() {
+  std::string type = str();
+  uint32_t len = u32();
+  if (size_t(_end - _p) < len) {
+    throw std::runtime_error("image truncated");
+  }
+  auto l = loaders().find(type);
+  if (l == loaders().end()) {
+    throw std::runtime_error("image: unknown type (" + type + ")");
+  }
+
+  ImageReader payload(_p, len, _ctx);
+  _p += len;
+  auto rv = l->second(payload);
+  if (!payload.at_end()) {
+    throw std::runtime_error("image: bad record (" + type + ")");
+  }
+  return rv;
+}
+
+rpn::ImageMap::ImageMap(const std::string &path) {
+#ifndef _MSC_VER
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+	_data = static_cast<const char*>(p);
+	_size = size_t(st.st_size);
+      }
+    }
+    close(fd);
+  }
+#else
+  std::ifstream ifs(path, std::ios::binary);
+  if (ifs) {
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    _buf = ss.str();
+    _data = _buf.data();
+    _size = _buf.size();
+  }
+#endif
+}
+
+rpn::ImageMap::~ImageMap() {
+#ifndef _MSC_VER
+  if (_data != nullptr) {
+    munmap(const_cast<char*>(_data), _size);
+  }
+#endif
+}
+
+/*
+ * loaders for the core types
+ */
+static const bool sk_coreTypes[] = {
+  rpn::ImageReader::addType("Double", [](rpn::ImageReader &r) {
+    return std::make_unique<StDouble>(r.f64());
+  }),
+  rpn::ImageReader::addType("Integer", [](rpn::ImageReader &r) {
+    return std::make_unique<StInteger>(r.i64());
+  }),
+  rpn::ImageReader::addType("Boolean", [](rpn::ImageReader &r) {
+    return std::make_unique<StBoolean>(r.u8() != 0);
+  }),
+  rpn::ImageReader::addType("String", [](rpn::ImageReader &r) {
+    return std::make_unique<StString>(r.str());
+  }),
+  rpn::ImageReader::addType("Vec3", [](rpn::ImageReader &r) {
+    double x = r.f64();
+    double y = r.f64();
+    double z = r.f64();
+    return std::make_unique<StVec3>(x, y, z);
+  }),
+  rpn::ImageReader::addType("Array", [](rpn::ImageReader &r) {
+    auto rv = std::make_unique<StArray>();
+    for(uint32_t n = r.u32(); n; n--) {
+      rv->add_value(*r.object());
+    }
+    return rv;
+  }),
+  rpn::ImageReader::addType("Object", [](rpn::ImageReader &r) {
+    auto rv = std::make_unique<StObject>();
+    for(uint32_t n = r.u32(); n; n--) {
+      std::string name = r.str();
+      rv->add_value(name, *r.object());
+    }
+    return rv;
+  }),
+};
+
+/* end of qinc/rpn-lang/src/rpn-image.cpp */
@@ -13,31 +13,32 @@
  */
 
 #include <fstream>
+#include <sstream>
 #include <queue>
 #include <future>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 
 #include <cmath>
+#include <cerrno>
 #include <algorithm>
-#include <format>
 
-#include "../rpn.h"
-
-static int sk_decimals=10;
-static double sk_precision=10000000000;
-
-std::string
-rpn::to_string(const double &dv) {
-  double dvr = std::round(sk_precision*(dv))/sk_precision;
-  double intpart;
+#ifndef _MSC_VER
+#include <dlfcn.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
 
-  std::string rv = std::format("{}", dvr);
-  if (modf(dvr, &intpart) == 0.0) {
-    rv += ".";
-  }
-  return rv;
-}
+#include "../rpn.h"
+#include "timecode.h"
+#include "bignum.h"
+#include "random.h"
+#include "trace.h"
+#include "trie.h"
+#include "work-pool.h"
 
 static std::string::size_type
 nextWord(std::string &word, std::string &buffer, const std::string &delim=" \n\t") {
@@ -60,13 +61,14 @@ enum CompileType {
   ct_forloop,
   ct_whileloop,
   ct_lambda,
-  ct_mathexpr
+  ct_mathexpr,
+  ct_parfor
 };
 
 struct Progn : public rpn::WordContext, public rpn::Stack::Object {
 public:
   Progn(rpn::Interp::Privates &p, CompileType t) : _p(p), _type(t) { _locals = std::make_shared<var_dict_t>(); };
-  Progn(const Progn &other) : _p(other._p), _wordlist(other._wordlist), _type(other._type), _ident(other._ident) {
+  Progn(const Progn &other) : rpn::WordContext(other), rpn::Stack::Object(other), _p(other._p), _wordlist(other._wordlist), _type(other._type), _ident(other._ident), _from(other._from), _seed(other._seed) {
     _locals = std::make_shared<var_dict_t>();
     for(auto const &v : *other._locals) {
       _locals->emplace(v.first, v.second->deep_copy());
@@ -95,9 +97,7 @@ public:
 
   rpn::WordDefinition::Result eval(rpn::Interp &rpn);
 
-  rpn::WordDefinition::Result eval_forloop(rpn::Interp &rpn);
   rpn::WordDefinition::Result eval_whileloop(rpn::Interp &rpn);
-  rpn::WordDefinition::Result eval_lambda(rpn::Interp &rpn);
   rpn::WordDefinition::Result eval_mathexpr(rpn::Interp &rpn);
 
   const std::vector<std::string> &wordlist() const { return _wordlist; };
@@ -117,14 +117,45 @@ public:
   }
 
   virtual std::string deparse() const override {
-    return "not-yet";
+    std::string body;
+    for(auto const &w : _wordlist) {
+      auto lv = _locals->find(w);
+      auto *pn = (lv != _locals->end()) ? dynamic_cast<const Progn*>(lv->second.get()) : nullptr;
+      body += " ";
+      body += (pn != nullptr) ? pn->deparse() : w; // nested loops are kept as locals
+    }
+    switch (_type) {
+    case ct_worddef: return ": " + _ident + body + " ;";
+    case ct_forloop: return "FOR " + _ident + body + " NEXT";
+    case ct_parfor: return "PARFOR " + _ident + body + " NEXT";
+    default: return "<<" + body + " >>";
+    }
+  }
+
+  virtual bool image(rpn::ImageWriter &w) const override {
+    w.record("Progn");
+    w.u8(uint8_t(_type));
+    w.str(_ident);
+    w.u32(uint32_t(_wordlist.size()));
+    for(auto const &word : _wordlist) {
+      w.str(word);
+    }
+    w.u32(uint32_t(_locals->size()));
+    for(auto const &lv : *_locals) {
+      w.str(lv.first);
+      w.object(*lv.second);
+    }
+    return true;
   }
-    
+
   rpn::Interp::Privates &_p;
   std::vector<std::string> _wordlist;
   std::shared_ptr<var_dict_t> _locals;
   CompileType _type;
   std::string _ident; // value and usage depends on type
+  double _from = 0.; // first index of a running ct_parfor
+  uint64_t _seed = 0; // iteration i of an apply() draws from stream i of this
+  bool _builtin = false; // defined while the Interp was being constructed, not saved in images
 };
 
 #include <chrono>
@@ -132,24 +163,42 @@ using namespace std::chrono_literals;
 
 struct rpn::Interp::Privates : public rpn::WordContext {
   std::future<void> _arv;
-  Privates(rpn::Interp &rpn) : _rpn(rpn), _tracing(false) {
+  Privates(rpn::Interp &rpn) : _rpn(rpn), _tracing(false), _running(true) {
     _arv = std::async(std::launch::async, &rpn::Interp::Privates::main_loop, this);
   };
+  // one of shared's workers: no queue of its own, and shared's words
+  Privates(rpn::Interp &rpn, Privates *shared) : _rpn(rpn), _tracing(false), _running(false) {
+    _shared = shared;
+    _worker = true;
+  }
   ~Privates() {
-    _running = false;
+    {
+      std::lock_guard lg(_qmx); // so main_loop() can't miss the wakeup
+      _running = false;
+    }
     _qcv.notify_one();
-    std::future_status status;
-    do {
+    std::future_status status = std::future_status::timeout;
+    while (_arv.valid() && status != std::future_status::ready) { // workers have no main_loop()
       switch(status = _arv.wait_for(1s)) {
       case std::future_status::deferred: printf("deferred\n"); break;
       case std::future_status::timeout: printf("timeout\n"); break;
       case std::future_status::ready: printf("ready!\n"); break;
       }
-    } while (status != std::future_status::ready);
+    }
+    // compiled words belong to the dictionary
+    std::set<Progn*> owned;
+    for(auto &we : _rtDictionary) {
+      if (auto *pn = dynamic_cast<Progn*>(we.second.context)) {
+	owned.insert(pn);
+      }
+    }
+    for(auto *pn : owned) {
+      delete pn;
+    }
   };
 
   rpn::WordDefinition::Result eval(const std::string &word, std::string &rest);
-  rpn::WordDefinition::Result runtime_eval(const std::string &word, std::string &rest);
+  rpn::WordDefinition::Result runtime_eval(const std::string &word, std::string &rest, bool inner=false);
   rpn::WordDefinition::Result compiletime_eval(const std::string &word, std::string &rest);
 
   // add words that require acces to the Privates struct.
@@ -162,41 +211,204 @@ struct rpn::Interp::Privates : public rpn::WordContext {
   rpn::WordDefinition::Result start_compile(CompileType t, bool needIdent);
   rpn::WordDefinition::Result end_compile(Progn *&progp, CompileType t);
 
+  /*
+   * inner interpreter - compiled words and loops are run from an explicit
+   * return stack rather than recursing through eval() on the C++ stack
+   */
+  struct Frame {
+    Progn *progn;
+    size_t ip;    // next word in progn->_wordlist
+    double index; // loop variable (ct_forloop)
+    double end;   // loop limit (ct_forloop)
+  };
+  rpn::WordDefinition::Result run(Progn *progn);
+  rpn::WordDefinition::Result enter(Progn *progn);
+  void leave();
+
+  bool save_image(const std::string &path);
+  bool load_image(const std::string &path);
+  // a word taken out of the dictionary, freed once no frame is running it
+  void retire(Progn *pn);
+  std::vector<std::unique_ptr<Progn>> _retired;
+
+  /*
+   * applying lambdas across arrays (MAP, FILTER, REDUCE, ZIP-WITH) - each
+   * call gets a stack holding only its arguments and must leave exactly
+   * one value.  pure lambdas over big inputs run in chunks on _pool, each
+   * pool thread with its own worker Interp (and so its own stack)
+   */
+  using Args = std::function<void(size_t i, rpn::Stack &stack)>;
+  using Results = std::vector<std::unique_ptr<rpn::Stack::Object>>;
+  rpn::WordDefinition::Result apply(Progn &fn, size_t n, const Args &args, Results &results, bool ordered=false);
+  rpn::WordDefinition::Result apply_one(Progn &fn, size_t i, const Args &args, std::unique_ptr<rpn::Stack::Object> &result);
+  bool is_pure(const Progn &fn, std::vector<std::string> &bound, std::string *culprit=nullptr, int depth=0);
+  rpn::WorkPool *pool();
+
+  /*
+   * lo hi PARFOR i ... NEXT - each iteration gets a copy of the stack
+   * under lo and hi, and its top value goes into an array in index order
+   */
+  rpn::WordDefinition::Result parfor(Progn &body);
+
+  std::map<std::string,size_t> _builtinWords; // built-in definitions per name
+
+  // every change to _rtDictionary goes through these so _names keeps up
+  void define(const std::string &word, const WordDefinition &def) {
+    _rtDictionary.emplace(word, def);
+    _names[word]++;
+  }
+  std::multimap<std::string,WordDefinition>::iterator undefine(std::multimap<std::string,WordDefinition>::iterator we) {
+    if (--_names[we->first] == 0) {
+      _names.erase(we->first);
+    }
+    return _rtDictionary.erase(we);
+  }
+  q::Trie _names; // definitions per word
+  // words starting with prefix, sorted, including modules not added yet
+  std::vector<std::string> complete(const std::string &prefix, size_t limit);
+
+  /*
+   * dictionaries past the core ones are added on first reference to one
+   * of their words.  A module comes in after the lower ones it shares a
+   * word with, so every word's overloads are in the same order as if
+   * they'd all been added up front
+   */
+  using Module = void (rpn::Interp::*)(); // an add*Words()
+  static const std::vector<Module> &modules();
+  struct ModuleIndex {
+    std::vector<std::vector<std::string>> words; // everything each module defines
+    std::unordered_map<std::string,uint32_t> providers; // word -> mask of modules
+    q::Trie names; // the same, for completion
+    std::vector<uint32_t> below; // lower modules sharing a word with each
+  };
+  static const ModuleIndex &module_index();
+  void materialize(const std::string &word) {
+    if (_unloaded != 0 && _loading == 0) {
+      const auto &providers = module_index().providers;
+      auto mi = providers.find(word);
+      if (mi != providers.end() && (mi->second & _unloaded) != 0) {
+	load_modules(mi->second);
+      }
+    }
+  }
+  void load_modules(uint32_t mask);
+  uint32_t _unloaded = 0; // modules not added yet
+  int _loading = 0;
+  std::vector<void*> _libraries; // LOAD-DICT, never unloaded since their words live there
+  rpn::WordDefinition::Result load_library(const std::string &path);
+  std::unique_ptr<rpn::WorkPool> _pool;
+  std::vector<std::unique_ptr<rpn::Interp>> _workers;
+  bool _worker = false; // one of another Interp's _workers, never fans out again
+  Privates *_shared = nullptr; // a worker looks its words up in this one's dictionary
+  std::multimap<std::string,WordDefinition> &dictionary() { return _shared ? _shared->_rtDictionary : _rtDictionary; }
+
+  const q::FrameRate *_frameRate = &q::FrameRate::get(q::Fraction(24, 1));
+  q::Random _random;
+
   bool is_local_variable(const std::string &word);
   bool find_local_variable(var_dict_t::const_iterator &var, const std::string &word);
 
   rpn::WordDefinition::Result parse(std::string &line) {
     rpn::WordDefinition::Result rv=rpn::WordDefinition::Result::ok;
+    rpn::NumberFormat::Use fmt(_rpn.stack.format());
+    Recorder *rec = _recorder;
+    _recorder = nullptr; // words that parse on their own (EVAL) are replayed as text
+    std::string src = rec ? line : std::string();
+    bool top = _parseDepth++ == 0; // EVAL's words are traced as the words they are
     for(; rv==rpn::WordDefinition::Result::ok && line.size()>0;) {
       std::string word;
+      size_t left = line.size();
+      if (top && _tracing && src.size() < left) {
+	src = line; // TRACE came on, only the rest is ever looked at
+      }
       /*auto p1 = */ nextWord(word,line);
+      bool compiling = !_ctVprogn.empty();
+      bool tracing = top && _tracing && !word.empty();
+      uint64_t start = tracing ? rpn::Tracer::now() : 0;
+      _textEval = tracing;
       rv = eval(word, line);
+      if (rec && rv==rpn::WordDefinition::Result::ok) {
+	// the text this word consumed, including any literal or comment
+	record(*rec, word, compiling, src.substr(src.size()-left, left-line.size()));
+      }
+      if (tracing) {
+	// recorded even when it was TRACE turning off, so a replay turns it off too
+	trace(rpn::Tracer::ev_text, src.substr(src.size()-left, left-line.size()), rv, start);
+      }
     }
+    _parseDepth--;
+    _recorder = rec;
     return rv;
   }
 
   rpn::WordDefinition::Result sync_parse_file(const std::string &path) {
     rpn::WordDefinition::Result rv=rpn::WordDefinition::Result::ok;
     std::ifstream ifs(path);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const std::string source = ss.str();
+
+    std::string cache = path + "c";
+    uint64_t hash = rpn::ImageWriter::hash(source);
+    if (_parseCache && load_parse_cache(cache, hash, rv)) {
+      return rv;
+    }
 
-    // XXX-ELH: do we really need to stuff this into a vector before we parse it?
-    std::string tmp;
-    std::vector<std::string> lines;
-    while(getline(ifs, tmp, '\n')) {
-      lines.push_back(tmp);
+    Recorder rec;
+    if (_parseCache) {
+      rec.w.header();
+      rec.w.u8('H');
+      rec.w.i64(int64_t(hash));
+      rec.w.i64(int64_t(dictionary_abi()));
+      _recorder = &rec;
     }
 
     int lineNo=0;
-    for(auto line = lines.begin(); line!=lines.end() && rv==rpn::WordDefinition::Result::ok; line++, lineNo++) {
-      rv = parse(*line);
+    for(size_t pos=0; pos<source.size() && rv==rpn::WordDefinition::Result::ok; lineNo++) {
+      size_t eol = source.find('\n', pos);
+      if (eol == std::string::npos) {
+	eol = source.size();
+      }
+      std::string line = source.substr(pos, eol-pos);
+      pos = eol+1;
+      rv = parse(line);
       if (rv != rpn::WordDefinition::Result::ok) {
 	printf("parse error at %s:%d\n", path.c_str(), lineNo);
       }
+      (_ctVprogn.empty() ? rec.text : rec.segment) += '\n';
     }
+    _recorder = nullptr;
 
+    if (_parseCache && rv == rpn::WordDefinition::Result::ok && _ctVprogn.empty()) {
+      flush_text(rec);
+      rec.w.u8('E');
+      if (!rec.w.write(cache) && _tracing) {
+	printf("can't write parse cache %s\n", cache.c_str());
+      }
+    }
     return rv;
   }
 
+  /*
+   * parseFile cache - the source hash and dictionary ABI, then records of
+   * top level text to evaluate ('X') and compiled definitions ('D') in the
+   * order the source had them
+   */
+  struct Recorder {
+    rpn::ImageWriter w;
+    std::string text;    // top level text not written yet
+    std::string segment; // text of a definition in progress
+  };
+  void record(Recorder &rec, const std::string &word, bool compiling, const std::string &consumed);
+  void flush_text(Recorder &rec);
+  bool load_parse_cache(const std::string &path, uint64_t hash, rpn::WordDefinition::Result &rv);
+  uint64_t dictionary_abi();
+
+  Recorder *_recorder = nullptr;
+  Progn *_lastDefined = nullptr;
+  bool _parseCache = false;
+  uint64_t _dictABI = 0; // 0 until a parse cache needs it
+
   /*
    */
   std::multimap<std::string,WordDefinition> _rtDictionary;
@@ -208,8 +420,29 @@ struct rpn::Interp::Privates : public rpn::WordContext {
   std::vector<Progn> _ctVprogn;
   std::vector<std::shared_ptr<var_dict_t>> _vlocals;
 
+  std::vector<Frame> _rstack;
+  size_t _rbase = 0; // first frame owned by the innermost run()
+  size_t _rlimit = 65536; // return stack depth limit (->RLIMIT)
+  bool _innerCall = false; // next eval() was dispatched from run()
+  bool _textEval = false; // next eval() is parse()'s, traced with its text
+  size_t _parseDepth = 0;
+  uint16_t _session = rpn::Tracer::session();
+
+  void trace(rpn::Tracer::Kind kind, const std::string &word,
+	     rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok, uint64_t start = 0) {
+    if (_loading != 0) {
+      return; // a module adding its words isn't what anybody ran
+    }
+    // a number is only kept for dictionary words, not every literal and line
+    bool known = kind == rpn::Tracer::ev_start || kind == rpn::Tracer::ev_define ||
+      (kind == rpn::Tracer::ev_word && dictionary().count(word) != 0);
+    rpn::Tracer::record(kind, word, known, uint8_t(rv), _rpn.stack.depth(), _rstack.size(), _session,
+			start ? start : rpn::Tracer::now());
+  }
+
   bool _needIdent;
   bool _tracing;
+  bool _sealed = false; // built-in dictionaries are loaded
 
   std::mutex _qmx;
   std::condition_variable _qcv;
@@ -228,7 +461,6 @@ struct rpn::Interp::Privates : public rpn::WordContext {
   std::queue<Request> _queue;
   bool _running;
   void main_loop() {
-    _running = true;
     for(;_running;) {
 
       std::unique_lock ul(_qmx);
@@ -242,6 +474,10 @@ struct rpn::Interp::Privates : public rpn::WordContext {
 	  req.completionHandler(parse(req.param));
 	} else if (req.cmd == "parseFile") {
 	  req.completionHandler(sync_parse_file(req.param));
+	} else if (req.cmd == "saveImage" || req.cmd == "loadImage") {
+	  bool ok = req.cmd == "saveImage" ? save_image(req.param) : load_image(req.param);
+	  _status = req.cmd + ": " + (ok ? "ok" : "eval error '" + req.param + "'");
+	  req.completionHandler(ok ? rpn::WordDefinition::Result::ok : rpn::WordDefinition::Result::eval_error);
 	}
       }
     }
@@ -249,77 +485,129 @@ struct rpn::Interp::Privates : public rpn::WordContext {
 };
 
 rpn::WordDefinition::Result
-Progn::eval_forloop(rpn::Interp &rpn) {
+Progn::eval_whileloop(rpn::Interp &/*rpn*/) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double end = rpn.stack.pop_as_double();
-  double start = rpn.stack.pop_as_double();
-  _p._vlocals.push_back(_locals);
-  for(; rv==rpn::WordDefinition::Result::ok && start<end; start += 1) {
-    (*_locals)[_ident] = std::make_unique<StDouble>(StDouble(start));
-    rv = eval_lambda(rpn);
-  }
-  _p._vlocals.pop_back();
   return rv;
 }
 
 rpn::WordDefinition::Result
-Progn::eval_whileloop(rpn::Interp &rpn) {
+rpn::Interp::Privates::enter(Progn *progn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  Frame frame { progn, 0, 0., 0. };
+
+  if (progn->_type == ct_forloop) {
+    if (_rpn.stack.depth() < 2) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    frame.end = _rpn.stack.pop_as_double();
+    frame.index = _rpn.stack.pop_as_double();
+    if (!(frame.index < frame.end)) {
+      return rv; // zero trip loop
+    }
+    (*progn->_locals)[progn->_ident] = std::make_unique<StDouble>(StDouble(frame.index));
+  }
+
+  // tail call - the caller has nothing left to do, so reuse its slot.  Only
+  // for words from the dictionary, nested loops still need the caller's locals
+  if (progn->_type == ct_worddef && _rstack.size() > _rbase) {
+    const Frame &caller = _rstack.back();
+    if (caller.ip >= caller.progn->_wordlist.size() &&
+	(caller.progn->_type != ct_forloop || !(caller.index + 1 < caller.end))) {
+      leave();
+    }
+  }
+
+  if (_rstack.size() >= _rlimit) {
+    printf("return stack overflow (limit %zu)\n", _rlimit);
+    return rpn::WordDefinition::Result::eval_error;
+  }
+
+  _rstack.push_back(frame);
+  _vlocals.push_back(progn->_locals);
   return rv;
 }
 
-rpn::WordDefinition::Result
-Progn::eval_lambda(rpn::Interp &rpn) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  std::string rest;
-
-  _p._vlocals.push_back(_locals);
+void
+rpn::Interp::Privates::leave() {
+  _vlocals.pop_back();
+  _rstack.pop_back();
+}
 
-  for(auto wi= _wordlist.cbegin(); rv==rpn::WordDefinition::Result::ok && wi != _wordlist.cend(); wi++) {
-    var_dict_t::const_iterator lv = _locals->find(*wi);
-    bool lvp = (lv != _locals->end());
-    if (!lvp) {
-      lvp = _p.find_local_variable(lv, *wi);
+rpn::WordDefinition::Result
+rpn::Interp::Privates::run(Progn *progn) {
+  size_t base = _rbase;
+  _rbase = _rstack.size();
+
+  rpn::WordDefinition::Result rv = enter(progn);
+  while (rv==rpn::WordDefinition::Result::ok && _rstack.size() > _rbase) {
+    Frame &frame = _rstack.back();
+    const auto &wordlist = frame.progn->_wordlist;
+
+    if (frame.ip >= wordlist.size()) {
+      if (frame.progn->_type == ct_forloop && (frame.index += 1) < frame.end) {
+	(*frame.progn->_locals)[frame.progn->_ident] = std::make_unique<StDouble>(StDouble(frame.index));
+	frame.ip = 0;
+      } else {
+	leave();
+      }
+      continue;
     }
 
-    if (lvp) {
+    const std::string &word = wordlist[frame.ip++];
+    var_dict_t::const_iterator lv;
+    if (find_local_variable(lv, word)) {
       auto *pn = dynamic_cast<Progn*>(&(*lv->second));
-      if (pn != nullptr) {
-	rpn.stack.print("recursive progn");
-	pn->print();
-	pn->eval(rpn);
+      if (pn != nullptr && pn->_type == ct_lambda) {
+	_rpn.stack.push(*pn); // a << >> in a body is a value
+
+      } else if (pn != nullptr && pn->_type == ct_parfor) {
+	rv = parfor(*pn);
+
+      } else if (pn != nullptr) {
+	if (_tracing) {
+	  trace(rpn::Tracer::ev_enter, pn->_ident);
+	}
+	rv = enter(pn);
 
       } else {
-	std::string sv = (*lv->second);
-	printf("push local: %s => %s\n", lv->first.c_str(), sv.c_str());
-	rpn.stack.push(*lv->second);
+	_rpn.stack.push(*lv->second);
+	if (_tracing) {
+	  trace(rpn::Tracer::ev_local, lv->first);
+	}
 
       }
 
     } else {
-      if (*wi == ".\"") {
+      std::string rest;
+      if (word == ".\"") {
         // XXX-ELH: special treatment for the '."' word - we need 'rest' to contain the next word from the wordlist
-        std::string word = *wi++;
-        if (wi != _wordlist.cend()) {
-          rest = *wi;
+        if (frame.ip < wordlist.size()) {
+          rest = wordlist[frame.ip++];
         }
-        rv = _p.eval(word, rest);
-        rest = ""; // and reset
+        rv = eval(word, rest);
 
       } else {
-        rv = _p.eval(*wi, rest);
+	_innerCall = true;
+        rv = eval(word, rest);
       }
 
     }
   }
 
-  _p._vlocals.pop_back();
+  // unwind anything left over from an error
+  while (_rstack.size() > _rbase) {
+    leave();
+  }
+  _rbase = base;
+  if (_rstack.empty()) {
+    _retired.clear();
+  }
 
   return rv;
 }
 
 rpn::WordDefinition::Result
-Progn::eval_mathexpr(rpn::Interp &rpn) {
+Progn::eval_mathexpr(rpn::Interp &/*rpn*/) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   return rv;
 }
@@ -329,24 +617,22 @@ Progn::eval(rpn::Interp &rpn) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   switch (_type) {
   case ct_worddef:
-    rv = eval_lambda(rpn);
-    break;
-
   case ct_forloop:
-    rv = eval_forloop(rpn);
+  case ct_lambda:
+    rv = _p.run(this);
     break;
 
   case ct_whileloop:
     rv = eval_whileloop(rpn);
     break;
 
-  case ct_lambda:
-    rv = eval_lambda(rpn);
-    break;
-
   case ct_mathexpr:
     rv = eval_mathexpr(rpn);
     break;
+
+  case ct_parfor:
+    rv = _p.parfor(*this);
+    break;
   }
   return rv;
 }
@@ -374,10 +660,13 @@ NATIVE_WORD_DECL(private, ct_SEMICOLON) {
   if (rv == rpn::WordDefinition::Result::ok) {
 
     if (p->_tracing) {
-      printf("adding '%s' to the dictionary\n", progp->_ident.c_str());
+      p->trace(rpn::Tracer::ev_define, progp->_ident);
     }
+    progp->_builtin = !p->_sealed;
+    p->_lastDefined = progp;
 
-    p->_rtDictionary.emplace(progp->_ident, rpn::WordDefinition {
+    p->materialize(progp->_ident);
+    p->define(progp->_ident, rpn::WordDefinition {
 	rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, COMPILED_EVAL), progp });
 
   } else {
@@ -392,23 +681,47 @@ NATIVE_WORD_DECL(private, TRACE) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
   bool pred = rpn.stack.pop_as_boolean();
+  if (pred && !p->_tracing) {
+    p->trace(rpn::Tracer::ev_start, "TRACE");
+  }
   p->_tracing = pred;
   return rv;
 }
 
+// ( path -- ) what TRACE has recorded so far, see tools/rpn-trace
+NATIVE_WORD_DECL(private, TRACE_DUMP) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  std::string path = rpn.stack.pop_string();
+  if (!rpn::Tracer::dump(path)) {
+    rv = rpn::WordDefinition::Result::eval_error;
+  }
+  return rv;
+}
+
+static StArray
+word_array(const std::vector<std::string> &words) {
+  StArray rv;
+  for(const auto &w : words) {
+    rv.add_value(StString(w));
+  }
+  return rv;
+}
+
 NATIVE_WORD_DECL(private, WORDLIST) {
   // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
-  std::set<std::string> keys;
-  for(const auto &dw : p->_rtDictionary) {
-    keys.insert(dw.first);
-  }
-  StArray res;
-  for(const auto &k : keys) {
-    res.add_value(StString(k));
-  }
-  rpn.stack.push(res);
+  rpn.stack.push(word_array(p->complete("", 0)));
+  return rv;
+}
+
+// ( prefix -- [words] )
+NATIVE_WORD_DECL(private, WORDS_MATCHING) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  std::string prefix = rpn.stack.pop_string();
+  rpn.stack.push(word_array(p->complete(prefix, 0)));
   return rv;
 }
 
@@ -429,7 +742,7 @@ NATIVE_WORD_DECL(private, BOOL_FALSE) {
 NATIVE_WORD_DECL(private, precision_to) {
   // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  rpn.stack.push_integer(sk_decimals);
+  rpn.stack.push_integer(rpn.stack.precision());
   return rv;
 }
 
@@ -437,8 +750,53 @@ NATIVE_WORD_DECL(private, to_precision) {
   // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto new_dec = rpn.stack.pop_integer();
-  sk_decimals = (int)std::clamp(new_dec, 0LL, 20LL); // there is probably a known upper bound here
-  sk_precision = std::pow(10, sk_decimals);
+  rpn.stack.setPrecision(int(std::clamp<int64_t>(new_dec, 0, 20))); // there is probably a known upper bound here
+  return rv;
+}
+
+NATIVE_WORD_DECL(private, rlimit_to) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  rpn.stack.push_integer(p->_rlimit);
+  return rv;
+}
+
+NATIVE_WORD_DECL(private, to_rlimit) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  auto limit = rpn.stack.pop_integer();
+  if (limit > 0) {
+    p->_rlimit = size_t(limit);
+  } else {
+    rv = rpn::WordDefinition::Result::param_error;
+  }
+  return rv;
+}
+
+NATIVE_WORD_DECL(private, SAVE_IMAGE) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  std::string path = rpn.stack.pop_string();
+  return p->save_image(path) ? rpn::WordDefinition::Result::ok : rpn::WordDefinition::Result::eval_error;
+}
+
+NATIVE_WORD_DECL(private, LOAD_IMAGE) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  std::string path = rpn.stack.pop_string();
+  return p->load_image(path) ? rpn::WordDefinition::Result::ok : rpn::WordDefinition::Result::eval_error;
+}
+
+// ( path -- )
+NATIVE_WORD_DECL(private, LOAD_DICT) {
+  // (rpn::Interp &rpn, rpn::WordContext *ctx, std::string &rest)
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  rpn::WordDefinition::Result rv = p->load_library(rpn.stack.peek_string(1));
+  if (rv == rpn::WordDefinition::Result::ok) {
+    rpn.stack.pop();
+  }
   return rv;
 }
 
@@ -502,6 +860,11 @@ NATIVE_WORD_DECL(private, ct_FOR) {
   return rv;
 }
 
+NATIVE_WORD_DECL(private, PARFOR) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  return p->start_compile(ct_parfor, true);
+}
+
 NATIVE_WORD_DECL(private, deparse) { // not really private
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   std::string eval;
@@ -540,6 +903,17 @@ rpn::Interp::Privates::end_compile(Progn *&progp, CompileType t) {
   return rv;
 }
 
+/*
+ * a nested loop or lambda is kept as a local of the body around it, under
+ * a name that no number or word can be
+ */
+static std::string
+local_name(const Progn *pn) {
+  char name[32];
+  snprintf(name, sizeof(name), "\xce\xbb%llx", (unsigned long long)(uintptr_t)pn); // λ
+  return name;
+}
+
 NATIVE_WORD_DECL(private, ct_NEXT) {
   rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
@@ -550,7 +924,9 @@ NATIVE_WORD_DECL(private, ct_NEXT) {
     } else */ {
     Progn *progp=nullptr;
 
-    rv = p->end_compile(progp, ct_forloop);
+    // NEXT closes both kinds of counted loop
+    bool par = (p->_ctVprogn.size()>0) && p->_ctVprogn.back()._type == ct_parfor;
+    rv = p->end_compile(progp, par ? ct_parfor : ct_forloop);
 
     if (rv == rpn::WordDefinition::Result::ok) {
 
@@ -565,7 +941,7 @@ NATIVE_WORD_DECL(private, ct_NEXT) {
 
 	// in a definition or nested loops
 
-	std::string word = std::to_string((uint64_t)progp);
+	std::string word = local_name(progp);
 	p->_ctVprogn.back()._locals->emplace(word, progp);
 	//	delete progp; who owns progp???
 	p->_ctVprogn.back().addWord(word);
@@ -580,6 +956,326 @@ NATIVE_WORD_DECL(private, ct_NEXT) {
   return rv;
 }
 
+NATIVE_WORD_DECL(private, LAMBDA) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  return p->start_compile(ct_lambda, false);
+}
+
+NATIVE_WORD_DECL(private, ct_END_LAMBDA) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  Progn *progp=nullptr;
+  rpn::WordDefinition::Result rv = p->end_compile(progp, ct_lambda);
+
+  if (rv == rpn::WordDefinition::Result::ok) {
+    if (p->_ctVprogn.size() == 0) {
+      // top level, the lambda is a value
+      rpn.stack.push(std::unique_ptr<rpn::Stack::Object>(progp));
+
+    } else {
+      // kept as a local like a nested loop, run() pushes it
+      std::string word = local_name(progp);
+      p->_ctVprogn.back()._locals->emplace(word, progp);
+      p->_ctVprogn.back().addWord(word);
+    }
+
+  } else {
+    rv = rpn::WordDefinition::Result::compile_error;
+  }
+  return rv;
+}
+
+namespace lambda_validator {
+  extern const rpn::StrictTypeValidator d2_lambda_array;
+  extern const rpn::StrictTypeValidator d3_lambda_any_array;
+  extern const rpn::StrictTypeValidator d3_lambda_array_array;
+}
+
+// below this many calls a lambda isn't worth handing to the pool
+static const size_t sk_parallelApply = 1024;
+// words with no context that still aren't safe on a worker
+static const std::set<std::string> sk_impureWords = { ".S" };
+
+rpn::WorkPool *
+rpn::Interp::Privates::pool() {
+  if (!_pool) {
+    unsigned n = std::max(1u, std::thread::hardware_concurrency());
+    _pool = std::make_unique<rpn::WorkPool>(n);
+    for(unsigned i=0; i<n; i++) {
+      _workers.push_back(std::unique_ptr<rpn::Interp>(new rpn::Interp(this)));
+    }
+  }
+  return _pool.get();
+}
+
+/*
+ * pure: numbers, strings, the lambda's own loops and their variables, and
+ * built-in words that either have no context or are compiled from pure
+ * words.  Anything else (user words, outer locals, the Interp's own
+ * words) runs serially.
+ */
+bool
+rpn::Interp::Privates::is_pure(const Progn &fn, std::vector<std::string> &bound, std::string *culprit, int depth) {
+  if (depth > 16) {
+    return false;
+  }
+  bool loop = (fn._type == ct_forloop || fn._type == ct_parfor);
+  if (loop) {
+    bound.push_back(fn._ident);
+  }
+  bool rv = true;
+  const auto &wordlist = fn._wordlist;
+  for(size_t i=0; rv && i<wordlist.size(); i++) {
+    const std::string &word = wordlist[i];
+    auto lv = fn._locals->find(word);
+    if (word == ".\"") {
+      i++; // the string itself
+
+    } else if (std::isdigit(word[0]) || (word[0]=='-' && std::isdigit(word[1]))) {
+      // a literal
+
+    } else if (lv != fn._locals->end()) {
+      auto *pn = dynamic_cast<const Progn*>(lv->second.get());
+      rv = (pn != nullptr) && is_pure(*pn, bound, culprit, depth+1);
+
+    } else if (std::find(bound.begin(), bound.end(), word) != bound.end()) {
+      // a loop variable
+
+    } else {
+      materialize(word);
+      auto range = _rtDictionary.equal_range(word);
+      auto bw = _builtinWords.find(word);
+      rv = (range.first != range.second && bw != _builtinWords.end() &&
+	    bw->second == size_t(std::distance(range.first, range.second)) &&
+	    sk_impureWords.count(word) == 0);
+      for(auto we=range.first; rv && we!=range.second; we++) {
+	auto *pn = dynamic_cast<const Progn*>(we->second.context);
+	rv = (we->second.context == nullptr) || (pn != nullptr && pn->_builtin && is_pure(*pn, bound, culprit, depth+1));
+      }
+      if (!rv && culprit != nullptr && culprit->empty()) {
+	*culprit = word;
+      }
+    }
+  }
+  if (loop) {
+    bound.pop_back();
+  }
+  return rv;
+}
+
+rpn::WordDefinition::Result
+rpn::Interp::Privates::apply_one(Progn &fn, size_t i, const Args &args, std::unique_ptr<rpn::Stack::Object> &result) {
+  _rpn.stack.clear();
+  args(i, _rpn.stack);
+  _random.seed(fn._seed, i); // the same numbers whichever thread runs it
+  if (fn._type == ct_parfor) {
+    (*fn._locals)[fn._ident] = std::make_unique<StDouble>(StDouble(fn._from + double(i)));
+  }
+  rpn::WordDefinition::Result rv = run(&fn);
+  if (rv == rpn::WordDefinition::Result::ok) {
+    if (fn._type == ct_parfor ? _rpn.stack.depth() > 0 : _rpn.stack.depth() == 1) {
+      // a loop body's result is its top value, the rest of its stack goes
+      result = _rpn.stack.pop();
+    } else if (fn._type == ct_parfor) {
+      printf("PARFOR %s left nothing\n", fn._ident.c_str());
+      rv = rpn::WordDefinition::Result::eval_error;
+    } else {
+      printf("lambda left %zu values, wants 1\n", _rpn.stack.depth());
+      rv = rpn::WordDefinition::Result::eval_error;
+    }
+  }
+  return rv;
+}
+
+rpn::WordDefinition::Result
+rpn::Interp::Privates::apply(Progn &fn, size_t n, const Args &args, Results &results, bool ordered) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  results.clear();
+  results.resize(n);
+  fn._seed = _random.next();
+
+  std::vector<std::string> bound;
+  rpn::WorkPool *wp = (!_worker && !ordered && n >= sk_parallelApply && is_pure(fn, bound)) ? pool() : nullptr;
+  if (wp != nullptr && wp->size() > 1) {
+    size_t chunk = std::max<size_t>(64, n / (wp->size() * 8));
+    size_t nchunks = (n + chunk - 1) / chunk;
+    std::vector<rpn::WordDefinition::Result> rvs(nchunks, rpn::WordDefinition::Result::ok);
+    std::vector<std::unique_ptr<Progn>> fns;
+    for(auto &w : _workers) {
+      fns.push_back(std::make_unique<Progn>(fn)); // loops keep their variable in the Progn
+      w->stack.setPrecision(_rpn.stack.precision());
+      w->setFrameRate(*_frameRate);
+      w->m_p->_tracing = _tracing;
+    }
+    std::vector<rpn::WorkPool::Task> tasks;
+    for(size_t c=0; c<nchunks; c++) {
+      tasks.push_back([&, c](unsigned w) {
+	rpn::NumberFormat::Use fmt(_rpn.stack.format());
+	Privates &worker = *_workers[w]->m_p;
+	for(size_t i=c*chunk; i<std::min(n, (c+1)*chunk) && rvs[c]==rpn::WordDefinition::Result::ok; i++) {
+	  rvs[c] = worker.apply_one(*fns[w], i, args, results[i]);
+	}
+	_workers[w]->stack.clear();
+      });
+    }
+    wp->run(tasks);
+    for(auto r : rvs) {
+      if (r != rpn::WordDefinition::Result::ok) {
+	return r;
+      }
+    }
+
+  } else {
+    rpn::Stack saved;
+    _rpn.stack.swap(saved);
+    q::Random random = _random;
+    for(size_t i=0; i<n && rv==rpn::WordDefinition::Result::ok; i++) {
+      rv = apply_one(fn, i, args, results[i]);
+    }
+    _random = random;
+    _rpn.stack.clear();
+    _rpn.stack.swap(saved);
+  }
+  return rv;
+}
+
+rpn::WordDefinition::Result
+rpn::Interp::Privates::parfor(Progn &body) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  if (_rpn.stack.depth() < 2) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  // iterations share nothing, so the whole body has to be safe on a worker
+  // even when the range is too small to fan out
+  std::vector<std::string> bound;
+  std::string culprit;
+  if (!is_pure(body, bound, &culprit)) {
+    printf("PARFOR %s: '%s' isn't safe in parallel\n", body._ident.c_str(), culprit.c_str());
+    return rpn::WordDefinition::Result::eval_error;
+  }
+
+  auto hi = _rpn.stack.pop();
+  auto lo = _rpn.stack.pop();
+  double from = double(*lo);
+  double to = double(*hi);
+  size_t n = (from < to) ? size_t(std::ceil(to - from)) : 0;
+
+  // the loop's inputs, copied onto each iteration's stack
+  std::vector<const rpn::Stack::Object*> inputs;
+  for(size_t i=_rpn.stack.depth(); i>0; i--) {
+    inputs.push_back(&_rpn.stack.peek_const(int(i)));
+  }
+  body._from = from;
+  Results results;
+  rv = apply(body, n, [&inputs](size_t, rpn::Stack &stack) {
+      for(auto const *in : inputs) {
+	stack.push(*in);
+      }
+    }, results);
+  body._locals->erase(body._ident);
+
+  if (rv == rpn::WordDefinition::Result::ok) {
+    _rpn.stack.push(std::make_unique<StArray>(std::move(results)));
+  } else {
+    _rpn.stack.push(std::move(lo));
+    _rpn.stack.push(std::move(hi));
+  }
+  return rv;
+}
+
+// ( [x...] << x -- y >> -- [y...] )
+NATIVE_WORD_DECL(private, MAP) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  auto fn = rpn.stack.pop();
+  auto arr = rpn.stack.pop();
+  const auto &v = PEEK_CAST(const StArray,*arr);
+  rpn::Interp::Privates::Results results;
+  rpn::WordDefinition::Result rv = p->apply(PEEK_CAST(Progn,*fn), v.size(), [&v](size_t i, rpn::Stack &stack) {
+      stack.push(v.value(i));
+    }, results);
+  if (rv == rpn::WordDefinition::Result::ok) {
+    rpn.stack.push(std::make_unique<StArray>(std::move(results)));
+  } else {
+    rpn.stack.push(std::move(arr));
+    rpn.stack.push(std::move(fn));
+  }
+  return rv;
+}
+
+// ( [x...] << x -- flag >> -- [x...] ) keeps the x where flag is true
+NATIVE_WORD_DECL(private, FILTER) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  auto fn = rpn.stack.pop();
+  auto arr = rpn.stack.pop();
+  const auto &v = PEEK_CAST(const StArray,*arr);
+  rpn::Interp::Privates::Results results;
+  rpn::WordDefinition::Result rv = p->apply(PEEK_CAST(Progn,*fn), v.size(), [&v](size_t i, rpn::Stack &stack) {
+      stack.push(v.value(i));
+    }, results);
+  if (rv == rpn::WordDefinition::Result::ok) {
+    StArray::Elements kept;
+    for(size_t i=0; i<results.size(); i++) {
+      rpn.stack.push(std::move(results[i]));
+      if (rpn.stack.pop_as_boolean()) {
+	kept.push_back(v.value(i).deep_copy());
+      }
+    }
+    rpn.stack.push(std::make_unique<StArray>(std::move(kept)));
+  } else {
+    rpn.stack.push(std::move(arr));
+    rpn.stack.push(std::move(fn));
+  }
+  return rv;
+}
+
+// ( [x...] init << acc x -- acc' >> -- acc ) a left fold, always serial
+NATIVE_WORD_DECL(private, REDUCE) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  auto fn = rpn.stack.pop();
+  auto init = rpn.stack.pop();
+  auto arr = rpn.stack.pop();
+  const auto &v = PEEK_CAST(const StArray,*arr);
+  rpn::Interp::Privates::Results results;
+  // each call takes the last one's result
+  rpn::WordDefinition::Result rv = p->apply(PEEK_CAST(Progn,*fn), v.size(), [&](size_t i, rpn::Stack &stack) {
+      stack.push(i == 0 ? init->deep_copy() : std::move(results[i-1]));
+      stack.push(v.value(i));
+    }, results, true);
+  if (rv == rpn::WordDefinition::Result::ok) {
+    rpn.stack.push(results.empty() ? std::move(init) : std::move(results.back()));
+  } else {
+    rpn.stack.push(std::move(arr));
+    rpn.stack.push(std::move(init));
+    rpn.stack.push(std::move(fn));
+  }
+  return rv;
+}
+
+// ( [a...] [b...] << a b -- c >> -- [c...] ) the arrays must be the same length
+NATIVE_WORD_DECL(private, ZIP_WITH) {
+  rpn::Interp::Privates *p = dynamic_cast<rpn::Interp::Privates*>(ctx);
+  const auto &va = PEEK_CAST(const StArray,rpn.stack.peek_const(3));
+  const auto &vb = PEEK_CAST(const StArray,rpn.stack.peek_const(2));
+  if (va.size() != vb.size()) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto fn = rpn.stack.pop();
+  auto b = rpn.stack.pop();
+  auto a = rpn.stack.pop();
+  rpn::Interp::Privates::Results results;
+  rpn::WordDefinition::Result rv = p->apply(PEEK_CAST(Progn,*fn), va.size(), [&va, &vb](size_t i, rpn::Stack &stack) {
+      stack.push(va.value(i));
+      stack.push(vb.value(i));
+    }, results);
+  if (rv == rpn::WordDefinition::Result::ok) {
+    rpn.stack.push(std::make_unique<StArray>(std::move(results)));
+  } else {
+    rpn.stack.push(std::move(a));
+    rpn.stack.push(std::move(b));
+    rpn.stack.push(std::move(fn));
+  }
+  return rv;
+}
+
 #ifdef notyet
 NATIVE_WORD_DECL(private, ct_STEP) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
@@ -591,25 +1287,41 @@ NATIVE_WORD_DECL(private, ct_STEP) {
 
 void
 rpn::Interp::Privates::add_private_words() {
-  _rtDictionary.emplace(":", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, COLON), this });
-  _rtDictionary.emplace("(", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, OPAREN), this });
-  _rtDictionary.emplace(".\"", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, DQUOTE), this });
-  _rtDictionary.emplace("FOR", rpn::WordDefinition { rpn::StrictTypeValidator::d2_integer_integer, NATIVE_WORD_FN(private, FOR), this });
-  _rtDictionary.emplace("TRACE", rpn::WordDefinition { rpn::StrictTypeValidator::d1_boolean, NATIVE_WORD_FN(private, TRACE), this });
-  _rtDictionary.emplace("WORDLIST", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, WORDLIST), this });
-  _rtDictionary.emplace("DEPARSE", rpn::WordDefinition { rpn::StackSizeValidator::one, NATIVE_WORD_FN(private, deparse), this });
-  _rtDictionary.emplace("EVAL", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, eval), this });
-
-  _rtDictionary.emplace("TRUE", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, BOOL_TRUE), this });
-  _rtDictionary.emplace("FALSE", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, BOOL_FALSE), this });
-  _rtDictionary.emplace("->PRECISION", rpn::WordDefinition { rpn::StrictTypeValidator::d1_integer, NATIVE_WORD_FN(private, to_precision), this });
-  _rtDictionary.emplace("PRECISION->", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, precision_to), this });
+  define(":", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, COLON), this });
+  define("(", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, OPAREN), this });
+  define(".\"", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, DQUOTE), this });
+  define("FOR", rpn::WordDefinition { rpn::StrictTypeValidator::d2_integer_integer, NATIVE_WORD_FN(private, FOR), this });
+  define("PARFOR", rpn::WordDefinition { rpn::StrictTypeValidator::d2_integer_integer, NATIVE_WORD_FN(private, PARFOR), this });
+  define("TRACE", rpn::WordDefinition { rpn::StrictTypeValidator::d1_boolean, NATIVE_WORD_FN(private, TRACE), this });
+  define("TRACE-DUMP", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, TRACE_DUMP), this });
+  define("WORDLIST", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, WORDLIST), this });
+  define("WORDS-MATCHING", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, WORDS_MATCHING), this });
+  define("DEPARSE", rpn::WordDefinition { rpn::StackSizeValidator::one, NATIVE_WORD_FN(private, deparse), this });
+  define("EVAL", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, eval), this });
+
+  define("TRUE", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, BOOL_TRUE), this });
+  define("FALSE", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, BOOL_FALSE), this });
+  define("->PRECISION", rpn::WordDefinition { rpn::StrictTypeValidator::d1_integer, NATIVE_WORD_FN(private, to_precision), this });
+  define("PRECISION->", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, precision_to), this });
+  define("->RLIMIT", rpn::WordDefinition { rpn::StrictTypeValidator::d1_integer, NATIVE_WORD_FN(private, to_rlimit), this });
+  define("RLIMIT->", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, rlimit_to), this });
+  define("SAVE-IMAGE", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, SAVE_IMAGE), this });
+  define("LOAD-IMAGE", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, LOAD_IMAGE), this });
+  define("LOAD-DICT", rpn::WordDefinition { rpn::StrictTypeValidator::d1_string, NATIVE_WORD_FN(private, LOAD_DICT), this });
+  define("<<", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, LAMBDA), this });
+  define("MAP", rpn::WordDefinition { lambda_validator::d2_lambda_array, NATIVE_WORD_FN(private, MAP), this });
+  define("FILTER", rpn::WordDefinition { lambda_validator::d2_lambda_array, NATIVE_WORD_FN(private, FILTER), this });
+  define("REDUCE", rpn::WordDefinition { lambda_validator::d3_lambda_any_array, NATIVE_WORD_FN(private, REDUCE), this });
+  define("ZIP-WITH", rpn::WordDefinition { lambda_validator::d3_lambda_array_array, NATIVE_WORD_FN(private, ZIP_WITH), this });
 
   _ctDictionary.emplace(";", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, ct_SEMICOLON), this });
   _ctDictionary.emplace("(", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, OPAREN), this });
   _ctDictionary.emplace(".\"", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, ct_DQUOTE), this });
   _ctDictionary.emplace("FOR", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, ct_FOR), this });
   _ctDictionary.emplace("NEXT", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, ct_NEXT), this });
+  _ctDictionary.emplace("PARFOR", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, PARFOR), this });
+  _ctDictionary.emplace("<<", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, LAMBDA), this });
+  _ctDictionary.emplace(">>", rpn::WordDefinition { rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, ct_END_LAMBDA), this });
 #ifdef notyet
   _ctDictionary.emplace("STEP", rpn::WordDefinition { rpn::StrictTypeValidator::d1_double, NATIVE_WORD_FN(private, ct_STEP), this });
 #endif
@@ -617,8 +1329,12 @@ rpn::Interp::Privates::add_private_words() {
 
 rpn::WordDefinition::Result
 rpn::Interp::Privates::eval(const std::string &word, std::string &rest) {
-  if (_tracing)
-    printf("evaluating: '%s' '%s'\n", word.c_str(), rest.c_str());
+  bool inner = _innerCall;
+  _innerCall = false;
+  // parse() traces its own words with the text they consumed
+  bool tracing = _tracing && !_textEval;
+  _textEval = false;
+  uint64_t start = tracing ? rpn::Tracer::now() : 0;
 
   if (word.size()==0) {
     return rpn::WordDefinition::Result::ok;
@@ -647,7 +1363,7 @@ rpn::Interp::Privates::eval(const std::string &word, std::string &rest) {
 
   } else {
     try {
-      rv = runtime_eval(word,rest);
+      rv = runtime_eval(word,rest,inner);
 
     } catch (const std::bad_cast &/*bce*/) {
       rv = rpn::WordDefinition::Result::param_error;
@@ -711,30 +1427,54 @@ rpn::Interp::Privates::eval(const std::string &word, std::string &rest) {
     printf("%s: %s\n", __func__, _status.c_str());
   }
 
-  if (_tracing)
-    printf("returns: %d (%s)\n", rv, rest.c_str());
-   
+  if (tracing) {
+    trace(rpn::Tracer::ev_word, word, rv, start);
+  }
+
   return rv;
 }
 
 rpn::WordDefinition::Result
-rpn::Interp::Privates::runtime_eval(const std::string &word, std::string &rest) {
+rpn::Interp::Privates::runtime_eval(const std::string &word, std::string &rest, bool inner) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::dict_error;
   // numbers just push
-  if (std::isdigit(word[0])||(word[0]=='-'&&std::isdigit(word[1]))) {
+  if (std::isdigit(word[0]) && word.find_first_of(":;") != std::string::npos) {
+    // HH:MM:SS:FF or HH:MM:SS;FF at the session rate
+    int64_t h, m, s, f;
+    if (q::Timecode::parse(word, *_frameRate, h, m, s, f)) {
+      q::Fraction fr(_frameRate->numerator, _frameRate->denominator);
+      _rpn.stack.push(stack::Timecode(q::Timecode(h, m, s, f, fr)));
+      rv = rpn::WordDefinition::Result::ok;
+    } else {
+      rv = rpn::WordDefinition::Result::parse_error;
+    }
+  } else if (std::isdigit(word[0])||(word[0]=='-'&&std::isdigit(word[1]))) {
     if (word.find('.') != std::string::npos) {
       double val = strtod(word.c_str(), nullptr);
       _rpn.stack.push_double(val);
     } else {
-      long val = strtol(word.c_str(), nullptr, 0);
-      _rpn.stack.push_integer(val);
+      errno = 0;
+      long long val = strtoll(word.c_str(), nullptr, 0);
+      q::BigInt big;
+      if (errno == ERANGE && q::BigInt::parse(word, big)) {
+	// too long for an Integer
+	stack::push_exact(_rpn.stack, std::move(big));
+      } else {
+	_rpn.stack.push_integer(val);
+      }
     }
     rv = rpn::WordDefinition::Result::ok;
   } else {
     if (word_exists(word)) {
       auto we = validate_word(word, _rpn.stack);
-      if (we != _rtDictionary.end()) {
-	rv = we->second.eval(_rpn,  we->second.context, rest);
+      if (we != dictionary().end()) {
+	Progn *progn = inner ? dynamic_cast<Progn*>(we->second.context) : nullptr;
+	if (progn != nullptr) {
+	  // called from a running word, push a frame instead of recursing
+	  rv = enter(progn);
+	} else {
+	  rv = we->second.eval(_rpn,  we->second.context, rest);
+	}
       } else {
 	rv = rpn::WordDefinition::Result::param_error;
       }
@@ -794,8 +1534,7 @@ rpn::Interp::Privates::compiletime_eval(const std::string &word, std::string &re
       
     } else {
       // everything else, we check in the runtime dictionary
-      const auto &rw = _rtDictionary.find(word);
-      if (rw != _rtDictionary.end()) {
+      if (word_exists(word)) {
 	progn.addWord(word);
 	rv=rpn::WordDefinition::Result::ok;
 
@@ -813,15 +1552,179 @@ rpn::Interp::Privates::compiletime_eval(const std::string &word, std::string &re
   return rv;
 }
 
+/*
+ * the lazily added dictionaries, in the order they used to be added
+ */
+const std::vector<rpn::Interp::Privates::Module> &
+rpn::Interp::Privates::modules() {
+  static const std::vector<Module> sk_modules = {
+    &rpn::Interp::addMathWords,
+    &rpn::Interp::addTypeWords,
+    &rpn::Interp::addArrayWords,
+    &rpn::Interp::addFractionWords,
+    &rpn::Interp::addTimecodeWords,
+    &rpn::Interp::addFftWords,
+    &rpn::Interp::addVec3Words,
+    &rpn::Interp::addMatrixWords,
+    &rpn::Interp::addBignumWords,
+    &rpn::Interp::addRandomWords,
+  };
+  return sk_modules;
+}
+
+/*
+ * which words each module defines comes from adding them all, once, to a
+ * scratch Interp that has nothing waiting, so materialize() leaves it be
+ */
+const rpn::Interp::Privates::ModuleIndex &
+rpn::Interp::Privates::module_index() {
+  static const ModuleIndex sk_index = [] {
+    ModuleIndex rv;
+    const auto &mods = modules();
+    rpn::Interp scratch(nullptr); // no main_loop() either
+    scratch.m_p->add_private_words();
+    scratch.addStackWords();
+    scratch.addLogicWords();
+    rv.words.resize(mods.size());
+    for(size_t m=0; m<mods.size(); m++) {
+      std::map<std::string,size_t> before;
+      for(const auto &dw : scratch.m_p->_rtDictionary) {
+	before[dw.first]++;
+      }
+      (scratch.*mods[m])();
+      for(auto we=scratch.m_p->_rtDictionary.begin(); we!=scratch.m_p->_rtDictionary.end();
+	  we=scratch.m_p->_rtDictionary.upper_bound(we->first)) {
+	if (scratch.m_p->_rtDictionary.count(we->first) > before[we->first]) {
+	  rv.words[m].push_back(we->first);
+	}
+      }
+    }
+    for(size_t m=0; m<mods.size(); m++) {
+      for(const auto &w : rv.words[m]) {
+	rv.providers[w] |= uint32_t(1) << m;
+	rv.names[w] |= uint32_t(1) << m;
+      }
+    }
+    rv.below.resize(mods.size());
+    for(size_t m=0; m<mods.size(); m++) {
+      for(const auto &w : rv.words[m]) {
+	rv.below[m] |= rv.providers[w] & ((uint32_t(1) << m) - 1);
+      }
+    }
+    return rv;
+  }();
+  return sk_index;
+}
+
+void
+rpn::Interp::Privates::load_modules(uint32_t mask) {
+  const auto &mods = modules();
+  for(size_t m=0; m<mods.size(); m++) {
+    uint32_t bit = uint32_t(1) << m;
+    if ((mask & bit) == 0 || (_unloaded & bit) == 0) {
+      continue;
+    }
+    load_modules(module_index().below[m]);
+    _unloaded &= ~bit;
+    bool sealed = _sealed;
+    _sealed = false; // anything it compiles is built in
+    // a module's own ': ;'s, when the first use is inside someone else's
+    std::vector<Progn> compiling;
+    compiling.swap(_ctVprogn);
+    bool needIdent = _needIdent;
+    Progn *lastDefined = _lastDefined;
+    Recorder *rec = _recorder;
+    _recorder = nullptr;
+    _loading++;
+    (_rpn.*mods[m])();
+    _loading--;
+    _recorder = rec;
+    _lastDefined = lastDefined;
+    _needIdent = needIdent;
+    _ctVprogn.swap(compiling);
+    _sealed = sealed;
+    for(const auto &w : module_index().words[m]) {
+      _builtinWords[w] = _rtDictionary.count(w);
+    }
+  }
+}
+
+/*
+ * both tries come out sorted, so the two merge.  each is cut at limit
+ * on its own, the union's first limit are still the right ones
+ */
+std::vector<std::string>
+rpn::Interp::Privates::complete(const std::string &prefix, size_t limit) {
+  std::vector<std::string> defined;
+  _names.visit(prefix, [&](const std::string &w, uint32_t) {
+      defined.push_back(w);
+      return limit == 0 || defined.size() < limit;
+    });
+  if (_unloaded == 0) {
+    return defined;
+  }
+  std::vector<std::string> pending;
+  module_index().names.visit(prefix, [&](const std::string &w, uint32_t mask) {
+      if ((mask & _unloaded) != 0) {
+	pending.push_back(w);
+      }
+      return limit == 0 || pending.size() < limit;
+    });
+  std::vector<std::string> rv;
+  std::set_union(defined.begin(), defined.end(), pending.begin(), pending.end(), std::back_inserter(rv));
+  if (limit != 0 && rv.size() > limit) {
+    rv.resize(limit);
+  }
+  return rv;
+}
+
+/*
+ * a shared object with an RPN_DICTIONARY() adds its words when it's
+ * loaded.  one that won't load, or has no rpn_add_words(), is an eval_error
+ */
+rpn::WordDefinition::Result
+rpn::Interp::Privates::load_library(const std::string &path) {
+  using AddWords = void (*)(rpn::Interp &);
+#ifndef _MSC_VER
+  void *lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (lib == nullptr) {
+    return rpn::WordDefinition::Result::eval_error;
+  }
+  auto add = reinterpret_cast<AddWords>(dlsym(lib, "rpn_add_words"));
+  if (add == nullptr) {
+    dlclose(lib);
+    return rpn::WordDefinition::Result::eval_error;
+  }
+#else
+  HMODULE lib = LoadLibraryA(path.c_str());
+  if (lib == nullptr) {
+    return rpn::WordDefinition::Result::eval_error;
+  }
+  auto add = reinterpret_cast<AddWords>(GetProcAddress(lib, "rpn_add_words"));
+  if (add == nullptr) {
+    FreeLibrary(lib);
+    return rpn::WordDefinition::Result::eval_error;
+  }
+#endif
+  _libraries.push_back(lib);
+  add(_rpn);
+  return rpn::WordDefinition::Result::ok;
+}
+
 rpn::Interp::Interp() {
   m_p = new Privates(*this);
   m_p->add_private_words();
   addStackWords();
   addLogicWords();
-  addMathWords();
-  addTypeWords();
-  addFractionWords();
-  addTimecodeWords();
+  m_p->_sealed = true;
+  for(const auto &dw : m_p->_rtDictionary) {
+    m_p->_builtinWords[dw.first]++;
+  }
+  m_p->_unloaded = uint32_t((uint64_t(1) << Privates::modules().size()) - 1); // the rest wait for their words
+}
+
+rpn::Interp::Interp(Privates *shared) {
+  m_p = new Privates(*this, shared);
 }
 
 rpn::Interp::~Interp() {
@@ -835,20 +1738,42 @@ rpn::Interp::status() {
 
 bool
 rpn::Interp::addDefinition(const std::string &word, const WordDefinition &def) {
-  m_p->_rtDictionary.emplace(word, def);
+  m_p->materialize(word); // after the built-ins of the same name
+  m_p->define(word, def);
   return true;
 }
 
+// for def<>, a mix of types the word already has (the same validator) stays with that one
+bool
+rpn::Interp::addNative(const std::string &word, const WordDefinition &def) {
+  m_p->materialize(word); // the built-ins it might repeat
+  auto range = m_p->_rtDictionary.equal_range(word);
+  for(auto we=range.first; we!=range.second; we++) {
+    if (&we->second.validator == &def.validator) {
+      return false;
+    }
+  }
+  return addDefinition(word, def);
+}
+
 bool
 rpn::Interp::removeDefinition(const std::string &word) {
-  m_p->_rtDictionary.erase(word);
+  m_p->materialize(word); // or they'd come back later
+  auto range = m_p->_rtDictionary.equal_range(word);
+  for(auto we=range.first; we!=range.second; ) {
+    auto *pn = dynamic_cast<Progn*>(we->second.context);
+    we = m_p->undefine(we);
+    if (pn != nullptr) {
+      m_p->retire(pn);
+    }
+  }
   return true;
 }
 
 std::multimap<std::string,rpn::WordDefinition>::iterator
 rpn::Interp::Privates::validate_word(const std::string &word, rpn::Stack &stack) {
-  const auto &beg = _rtDictionary.lower_bound(word);
-  const auto &end = _rtDictionary.upper_bound(word);
+  const auto &beg = dictionary().lower_bound(word);
+  const auto &end = dictionary().upper_bound(word);
   if (beg != end) {
     auto stack_types = stack.types();
     for(auto we=beg; we!=end; we++) {
@@ -857,19 +1782,21 @@ rpn::Interp::Privates::validate_word(const std::string &word, rpn::Stack &stack)
       }
     }
   }
-  return _rtDictionary.end();
+  return dictionary().end();
 }
 
 bool
 rpn::Interp::Privates::word_exists(const std::string &word) {
-  auto beg = _rtDictionary.lower_bound(word);
-  const auto &end = _rtDictionary.upper_bound(word);
+  materialize(word);
+  auto beg = dictionary().lower_bound(word);
+  const auto &end = dictionary().upper_bound(word);
   return (beg != end);
 }
 
 bool
 rpn::Interp::validateWord(const std::string &word) {
-  return m_p->validate_word(word, this->stack) != m_p->_rtDictionary.end();
+  m_p->materialize(word);
+  return m_p->validate_word(word, this->stack) != m_p->dictionary().end();
 }
 
 bool
@@ -901,11 +1828,325 @@ rpn::Interp::parseFile(const std::string &path, std::function<void(rpn::WordDefi
   m_p->queue_request("parseFile", path, completionHandler);
 }
 
+void
+rpn::Interp::setParseCache(bool enable) {
+  m_p->_parseCache = enable;
+}
+
+void
+rpn::Interp::setFrameRate(const q::FrameRate &rate) {
+  m_p->_frameRate = &rate;
+}
+
+const q::FrameRate &
+rpn::Interp::frameRate() const {
+  return *m_p->_frameRate;
+}
+
+q::Random &
+rpn::Interp::random() {
+  return m_p->_random;
+}
+
+void
+rpn::Interp::saveImage(const std::string &path, std::function<void(rpn::WordDefinition::Result)>completionHandler) {
+  m_p->queue_request("saveImage", path, completionHandler);
+}
+
+void
+rpn::Interp::loadImage(const std::string &path, std::function<void(rpn::WordDefinition::Result)>completionHandler) {
+  m_p->queue_request("loadImage", path, completionHandler);
+}
+
+bool
+rpn::Interp::saveImage(const std::string &path) {
+  return m_p->save_image(path);
+}
+
+bool
+rpn::Interp::loadImage(const std::string &path) {
+  return m_p->load_image(path);
+}
+
+bool
+rpn::Interp::loadDictionary(const std::string &path) {
+  return m_p->load_library(path) == rpn::WordDefinition::Result::ok;
+}
+
+std::vector<std::string>
+rpn::Interp::complete(const std::string &prefix, size_t limit) {
+  return m_p->complete(prefix, limit);
+}
+
+/*
+ * images - the stack and the user defined words
+ */
+static const bool sk_prognImage = rpn::ImageReader::addType("Progn", [](rpn::ImageReader &r) {
+    auto *p = dynamic_cast<rpn::Interp::Privates*>(r.context());
+    if (p == nullptr) {
+      throw std::runtime_error("image: compiled words need an interpreter");
+    }
+    auto rv = std::make_unique<Progn>(*p, CompileType(r.u8()));
+    rv->_ident = r.str();
+    for(uint32_t n = r.u32(); n; n--) {
+      rv->addWord(r.str());
+    }
+    for(uint32_t n = r.u32(); n; n--) {
+      std::string name = r.str();
+      rv->_locals->emplace(name, r.object());
+    }
+    return rv;
+  });
+
+bool
+rpn::Interp::Privates::save_image(const std::string &path) {
+  bool rv = false;
+  try {
+    rpn::ImageWriter w;
+    w.header();
+
+    w.u8('S');
+    size_t depth = _rpn.stack.depth();
+    w.u32(uint32_t(depth));
+    for(size_t i=depth; i; i--) {
+      w.object(_rpn.stack.peek(int(i)));
+    }
+
+    std::vector<std::pair<std::string,const Progn*>> words;
+    for(const auto &dw : _rtDictionary) {
+      auto *pn = dynamic_cast<const Progn*>(dw.second.context);
+      if (pn != nullptr && !pn->_builtin) {
+	words.emplace_back(dw.first, pn);
+      }
+    }
+    w.u8('W');
+    w.u32(uint32_t(words.size()));
+    for(const auto &dw : words) {
+      w.str(dw.first);
+      w.object(*dw.second);
+    }
+
+    w.u8('E');
+    rv = w.write(path);
+    if (!rv) {
+      printf("can't write image %s\n", path.c_str());
+    }
+
+  } catch(const std::exception &e) {
+    printf("%s: %s\n", path.c_str(), e.what());
+  }
+  return rv;
+}
+
+bool
+rpn::Interp::Privates::load_image(const std::string &path) {
+  rpn::ImageMap map(path);
+  if (!map.ok()) {
+    printf("can't open image %s\n", path.c_str());
+    return false;
+  }
+
+  // decode everything first, a bad image leaves the interpreter alone
+  std::vector<std::unique_ptr<rpn::Stack::Object>> stack;
+  std::vector<std::pair<std::string,Progn*>> words;
+  try {
+    rpn::ImageReader r(map.data(), map.size(), this);
+    if (!r.header()) {
+      throw std::runtime_error("not an image, or the wrong version");
+    }
+    for(uint8_t section = r.u8(); section != 'E'; section = r.u8()) {
+      switch (section) {
+      case 'S':
+	for(uint32_t n = r.u32(); n; n--) {
+	  stack.push_back(r.object());
+	}
+	break;
+
+      case 'W':
+	for(uint32_t n = r.u32(); n; n--) {
+	  std::string word = r.str();
+	  auto ob = r.object();
+	  auto *pn = dynamic_cast<Progn*>(ob.get());
+	  if (pn == nullptr) {
+	    throw std::runtime_error("image: " + word + " is not a compiled word");
+	  }
+	  ob.release();
+	  words.emplace_back(word, pn);
+	}
+	break;
+
+      default:
+	throw std::runtime_error("image: unknown section");
+      }
+    }
+
+  } catch(const std::exception &e) {
+    printf("%s: %s\n", path.c_str(), e.what());
+    for(auto &dw : words) {
+      delete dw.second;
+    }
+    return false;
+  }
+
+  _rpn.stack.clear();
+  for(auto &ob : stack) {
+    _rpn.stack.push(std::move(ob));
+  }
+
+  // the image replaces user words of the same name, built-ins stay
+  for(const auto &dw : words) {
+    auto range = _rtDictionary.equal_range(dw.first);
+    for(auto we = range.first; we != range.second; ) {
+      auto *pn = dynamic_cast<Progn*>(we->second.context);
+      if (pn != nullptr && !pn->_builtin) {
+	we = undefine(we);
+	retire(pn);
+      } else {
+	we++;
+      }
+    }
+  }
+  for(const auto &dw : words) {
+    materialize(dw.first);
+    define(dw.first, rpn::WordDefinition {
+	rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, COMPILED_EVAL), dw.second });
+  }
+  return true;
+}
+
+void
+rpn::Interp::Privates::retire(Progn *pn) {
+  if (_lastDefined == pn) {
+    _lastDefined = nullptr;
+  }
+  bool running = std::any_of(_rstack.begin(), _rstack.end(), [pn](const Frame &f) { return f.progn == pn; });
+  if (running) {
+    _retired.emplace_back(pn);
+  } else {
+    delete pn;
+  }
+}
+
+/*
+ * parseFile cache
+ */
+void
+rpn::Interp::Privates::record(Recorder &rec, const std::string &word, bool compiling, const std::string &consumed) {
+  rec.segment += consumed;
+  if (_ctVprogn.empty()) {
+    if (compiling && word == ";" && _lastDefined != nullptr) {
+      flush_text(rec);
+      rec.w.u8('D');
+      rec.w.str(_lastDefined->_ident);
+      rec.w.object(*_lastDefined);
+    } else {
+      rec.text += rec.segment; // includes loops run at the top level
+    }
+    rec.segment.clear();
+  }
+}
+
+void
+rpn::Interp::Privates::flush_text(Recorder &rec) {
+  if (rec.text.find_first_not_of(" \t\n") != std::string::npos) {
+    rec.w.u8('X');
+    rec.w.str(rec.text);
+  }
+  rec.text.clear();
+}
+
+// names and signatures of the built-in words, a cache made against a
+// different dictionary is stale.  the built-ins come first in each word's
+// overloads
+uint64_t
+rpn::Interp::Privates::dictionary_abi() {
+  if (_dictABI == 0) {
+    load_modules(_unloaded);
+    uint64_t rv = rpn::ImageWriter::hash(std::to_string(rpn::ImageWriter::version));
+    for(const auto &bw : _builtinWords) {
+      auto we = _rtDictionary.lower_bound(bw.first);
+      for(size_t i=0; i<bw.second; i++, we++) {
+	rv = rpn::ImageWriter::hash(we->first + " " + we->second.validator.to_string() + "\n", rv);
+      }
+    }
+    _dictABI = rv;
+  }
+  return _dictABI;
+}
+
+bool
+rpn::Interp::Privates::load_parse_cache(const std::string &path, uint64_t hash, rpn::WordDefinition::Result &rv) {
+  rpn::ImageMap map(path);
+  if (!map.ok()) {
+    return false;
+  }
+
+  struct Op {
+    std::string text;
+    std::string word;
+    std::unique_ptr<rpn::Stack::Object> progn;
+  };
+  std::vector<Op> ops;
+  try {
+    rpn::ImageReader r(map.data(), map.size(), this);
+    if (!r.header() || r.u8() != 'H' ||
+	uint64_t(r.i64()) != hash || uint64_t(r.i64()) != dictionary_abi()) {
+      return false; // stale
+    }
+    for(uint8_t op = r.u8(); op != 'E'; op = r.u8()) {
+      switch (op) {
+      case 'X':
+	ops.push_back({ r.str(), "", nullptr });
+	break;
+
+      case 'D': {
+	std::string word = r.str();
+	auto ob = r.object();
+	if (dynamic_cast<Progn*>(ob.get()) == nullptr) {
+	  throw std::runtime_error(word + " is not a compiled word");
+	}
+	ops.push_back({ "", word, std::move(ob) });
+	break;
+      }
+
+      default:
+	throw std::runtime_error("unknown record");
+      }
+    }
+
+  } catch(const std::exception &e) {
+    if (_tracing) {
+      printf("%s: %s, reparsing\n", path.c_str(), e.what());
+    }
+    return false;
+  }
+
+  rv = rpn::WordDefinition::Result::ok;
+  for(auto op = ops.begin(); op != ops.end() && rv==rpn::WordDefinition::Result::ok; op++) {
+    if (op->progn) {
+      auto *progp = static_cast<Progn*>(op->progn.release());
+      progp->_builtin = !_sealed;
+      _lastDefined = progp;
+      materialize(op->word);
+      define(op->word, rpn::WordDefinition {
+	  rpn::StackSizeValidator::zero, NATIVE_WORD_FN(private, COMPILED_EVAL), progp });
+
+    } else {
+      std::string line = op->text;
+      rv = parse(line);
+      if (rv != rpn::WordDefinition::Result::ok) {
+	printf("parse error in %s\n", path.c_str());
+      }
+    }
+  }
+  return true;
+}
+
 /*
  */
 
 bool
-rpn::StrictTypeValidator::operator()(const std::vector<size_t> &types, rpn::Stack &stack) const {
+rpn::StrictTypeValidator::operator()(const std::vector<size_t> &types, rpn::Stack &/*stack*/) const {
   bool rv = types.size() >= _types.size();
   for(auto si=types.cbegin(), wi=_types.cbegin(); rv==true && wi!=_types.cend(); si++, wi++) {
     rv &= ((*wi==v_anytype) || (*si == *wi));
@@ -943,9 +2184,9 @@ rpn::StackSizeValidator::to_string() const {
 bool
 rpn::StackSizeValidator::operator()(const std::vector<size_t> &types, rpn::Stack &stack) const {
   bool rv = false;
-  if ((_n==(size_t)-1) && types.size()>0 && types[0]==typeid(StInteger).hash_code()) { // negative means to ntos - check top of stack as integer and make sure that the stack is >=
+  if ((_n==(size_t)-1) && types.size()>0 && types[0]==rpn::tt_integer) { // negative means to ntos - check top of stack as integer and make sure that the stack is >=
     auto nn = stack.peek_integer(1);
-    rv = (types.size()-1) >= nn;
+    rv = nn >= 0 && (types.size()-1) >= size_t(nn);
   } else {
     rv = (types.size() >=_n);
   }
@@ -956,53 +2197,63 @@ rpn::StackSizeValidator::operator()(const std::vector<size_t> &types, rpn::Stack
  * canned validators for common stack depth/types
  *
  */
-const size_t rpn::StrictTypeValidator::v_anytype = typeid(rpn::Stack::Object).hash_code();
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_double({typeid(StDouble).hash_code()},"d1_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_integer({typeid(StInteger).hash_code()},"d1_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_boolean({typeid(StBoolean).hash_code()},"d1_boolean");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_string({typeid(StString).hash_code()},"d1_string");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_vec3({typeid(StVec3).hash_code()},"d1_vec3");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_object({typeid(StObject).hash_code()},"d1_object");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_array({typeid(StArray).hash_code()},"d1_array");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_boolean_boolean({typeid(StBoolean).hash_code(), typeid(StBoolean).hash_code()},"d2_boolean_boolean");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_double({typeid(StDouble).hash_code(), typeid(StDouble).hash_code()},"d2_double_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_integer({typeid(StDouble).hash_code(), typeid(StInteger).hash_code()},"d2_double_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_double({typeid(StInteger).hash_code(), typeid(StDouble).hash_code()},"d2_integer_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_integer({typeid(StInteger).hash_code(), typeid(StInteger).hash_code()},"d2_integer_integer");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_vec3({typeid(StDouble).hash_code(), typeid(StVec3).hash_code()},"d2_double_vec3");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_double({typeid(StVec3).hash_code(), typeid(StDouble).hash_code()},"d2_vec3_double");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_vec3({typeid(StInteger).hash_code(), typeid(StVec3).hash_code()},"d2_integer_vec3");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_integer({typeid(StVec3).hash_code(), typeid(StInteger).hash_code()},"d2_vec3_integer");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_vec3({typeid(StVec3).hash_code(), typeid(StVec3).hash_code()},"d2_vec3_vec3");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_string_any({typeid(StString).hash_code(),rpn::StrictTypeValidator::v_anytype},"d2_string_any");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_string({rpn::StrictTypeValidator::v_anytype,typeid(StString).hash_code()},"d2_any_string");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_array_any({typeid(StArray).hash_code(), rpn::StrictTypeValidator::v_anytype},"d2_array_any");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_array({rpn::StrictTypeValidator::v_anytype,typeid(StArray).hash_code()},"d2_any_array");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_object_any({typeid(StObject).hash_code(),rpn::StrictTypeValidator::v_anytype},"d2_object_any");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_object({rpn::StrictTypeValidator::v_anytype,typeid(StObject).hash_code()},"d2_any_object");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_double_double({typeid(StDouble).hash_code(),typeid(StDouble).hash_code(),typeid(StDouble).hash_code()},"d3_double_double_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_double_double({typeid(StInteger).hash_code(),typeid(StDouble).hash_code(),typeid(StDouble).hash_code()},"d3_integer_double_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_integer_double({typeid(StDouble).hash_code(),typeid(StInteger).hash_code(),typeid(StDouble).hash_code()},"d3_double_integer_double");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_double_integer({typeid(StDouble).hash_code(),typeid(StDouble).hash_code(),typeid(StInteger).hash_code()},"d3_double_double_integer");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_integer_integer({typeid(StInteger).hash_code(),typeid(StInteger).hash_code(),typeid(StInteger).hash_code()},"d3_integer_integer_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_integer_integer({typeid(StDouble).hash_code(),typeid(StInteger).hash_code(),typeid(StInteger).hash_code()},"d3_double_integer_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_double_integer({typeid(StInteger).hash_code(),typeid(StDouble).hash_code(),typeid(StInteger).hash_code()},"d3_integer_double_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_integer_double({typeid(StInteger).hash_code(),typeid(StInteger).hash_code(),typeid(StDouble).hash_code()},"d3_integer_integer_double");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_object_string_any({typeid(StObject).hash_code(),typeid(StString).hash_code(),rpn::StrictTypeValidator::v_anytype},"d3_object_string_any");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_string_any_object({typeid(StString).hash_code(),rpn::StrictTypeValidator::v_anytype,typeid(StObject).hash_code()},"d3_string_any_object");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_boolean_any_any({typeid(StBoolean).hash_code(), rpn::StrictTypeValidator::v_anytype, rpn::StrictTypeValidator::v_anytype} ,"d3_any_any_boolean");
-
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d4_double_double_double_integer({typeid(StDouble).hash_code(),typeid(StDouble).hash_code(),typeid(StDouble).hash_code(),typeid(StInteger).hash_code()},"d4_double_double_double_integer");
-const rpn::StrictTypeValidator rpn::StrictTypeValidator::d4_integer_double_double_double({typeid(StInteger).hash_code(),typeid(StDouble).hash_code(),typeid(StDouble).hash_code(),typeid(StDouble).hash_code()},"d4_integer_double_double_double");
+const size_t rpn::StrictTypeValidator::v_anytype = rpn::tt_any;
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_double({rpn::type_tag<StDouble>()},"d1_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_integer({rpn::type_tag<StInteger>()},"d1_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_boolean({rpn::type_tag<StBoolean>()},"d1_boolean");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_string({rpn::type_tag<StString>()},"d1_string");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_vec3({rpn::type_tag<StVec3>()},"d1_vec3");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_object({rpn::type_tag<StObject>()},"d1_object");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d1_array({rpn::type_tag<StArray>()},"d1_array");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_boolean_boolean({rpn::type_tag<StBoolean>(), rpn::type_tag<StBoolean>()},"d2_boolean_boolean");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_double({rpn::type_tag<StDouble>(), rpn::type_tag<StDouble>()},"d2_double_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_integer({rpn::type_tag<StDouble>(), rpn::type_tag<StInteger>()},"d2_double_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_double({rpn::type_tag<StInteger>(), rpn::type_tag<StDouble>()},"d2_integer_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_integer({rpn::type_tag<StInteger>(), rpn::type_tag<StInteger>()},"d2_integer_integer");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_double_vec3({rpn::type_tag<StDouble>(), rpn::type_tag<StVec3>()},"d2_double_vec3");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_double({rpn::type_tag<StVec3>(), rpn::type_tag<StDouble>()},"d2_vec3_double");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_vec3({rpn::type_tag<StInteger>(), rpn::type_tag<StVec3>()},"d2_integer_vec3");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_integer({rpn::type_tag<StVec3>(), rpn::type_tag<StInteger>()},"d2_vec3_integer");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_vec3_vec3({rpn::type_tag<StVec3>(), rpn::type_tag<StVec3>()},"d2_vec3_vec3");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_string_any({rpn::type_tag<StString>(),rpn::StrictTypeValidator::v_anytype},"d2_string_any");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_string({rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StString>()},"d2_any_string");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_array_any({rpn::type_tag<StArray>(), rpn::StrictTypeValidator::v_anytype},"d2_array_any");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_array({rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StArray>()},"d2_any_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_array_array({rpn::type_tag<StArray>(),rpn::type_tag<StArray>()},"d2_array_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_integer_array({rpn::type_tag<StInteger>(),rpn::type_tag<StArray>()},"d2_integer_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_string_array({rpn::type_tag<StString>(),rpn::type_tag<StArray>()},"d2_string_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_object_any({rpn::type_tag<StObject>(),rpn::StrictTypeValidator::v_anytype},"d2_object_any");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d2_any_object({rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StObject>()},"d2_any_object");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_double_double({rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>()},"d3_double_double_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_double_double({rpn::type_tag<StInteger>(),rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>()},"d3_integer_double_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_integer_double({rpn::type_tag<StDouble>(),rpn::type_tag<StInteger>(),rpn::type_tag<StDouble>()},"d3_double_integer_double");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_double_integer({rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>(),rpn::type_tag<StInteger>()},"d3_double_double_integer");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_integer_integer({rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>()},"d3_integer_integer_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_double_integer_integer({rpn::type_tag<StDouble>(),rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>()},"d3_double_integer_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_double_integer({rpn::type_tag<StInteger>(),rpn::type_tag<StDouble>(),rpn::type_tag<StInteger>()},"d3_integer_double_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_integer_double({rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),rpn::type_tag<StDouble>()},"d3_integer_integer_double");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_object_string_any({rpn::type_tag<StObject>(),rpn::type_tag<StString>(),rpn::StrictTypeValidator::v_anytype},"d3_object_string_any");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_string_any_object({rpn::type_tag<StString>(),rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StObject>()},"d3_string_any_object");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_any_array({rpn::type_tag<StInteger>(),rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StArray>()},"d3_integer_any_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_any_integer_array({rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StInteger>(),rpn::type_tag<StArray>()},"d3_any_integer_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_integer_integer_array({rpn::type_tag<StInteger>(),rpn::type_tag<StInteger>(),rpn::type_tag<StArray>()},"d3_integer_integer_array");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d3_boolean_any_any({rpn::type_tag<StBoolean>(), rpn::StrictTypeValidator::v_anytype, rpn::StrictTypeValidator::v_anytype} ,"d3_any_any_boolean");
+
+const rpn::StrictTypeValidator lambda_validator::d2_lambda_array({rpn::type_tag<Progn>(),rpn::type_tag<StArray>()},"d2_lambda_array");
+const rpn::StrictTypeValidator lambda_validator::d3_lambda_any_array({rpn::type_tag<Progn>(),rpn::StrictTypeValidator::v_anytype,rpn::type_tag<StArray>()},"d3_lambda_any_array");
+const rpn::StrictTypeValidator lambda_validator::d3_lambda_array_array({rpn::type_tag<Progn>(),rpn::type_tag<StArray>(),rpn::type_tag<StArray>()},"d3_lambda_array_array");
+
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d4_double_double_double_integer({rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>(),rpn::type_tag<StInteger>()},"d4_double_double_double_integer");
+const rpn::StrictTypeValidator rpn::StrictTypeValidator::d4_integer_double_double_double({rpn::type_tag<StInteger>(),rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>(),rpn::type_tag<StDouble>()},"d4_integer_double_double_double");
 
 const rpn::StackSizeValidator rpn::StackSizeValidator::zero(0);
 const rpn::StackSizeValidator rpn::StackSizeValidator::one(1);
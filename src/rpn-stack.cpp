@@ -15,26 +15,334 @@
 #include "../rpn.h"
 
 #include <cmath>
+#include <algorithm>
+#include <charconv>
 #include <typeinfo>
+#include <atomic>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+ * number formatting
+ */
+static const rpn::NumberFormat sk_defaultFormat;
+static thread_local const rpn::NumberFormat *tl_format = &sk_defaultFormat;
+
+const rpn::NumberFormat &
+rpn::NumberFormat::current() {
+  return *tl_format;
+}
+
+rpn::NumberFormat::Use::Use(const NumberFormat &f) : _prev(tl_format) {
+  tl_format = &f;
+}
+
+rpn::NumberFormat::Use::~Use() {
+  tl_format = _prev;
+}
+
+char *
+rpn::to_chars(char *first, char *last, const double &dv, const NumberFormat &f) {
+  static const double sk_scale[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+  };
+  double scale = sk_scale[std::clamp(f.decimals, 0, 20)];
+
+  // past 2^53 a double has no fraction left to round off (and scaling could overflow)
+  double dvr = dv;
+  if (std::abs(dv*scale) < 9007199254740992.) {
+    dvr = std::round(dv*scale)/scale;
+  }
+  if (dvr == 0.) {
+    dvr = 0.; // no -0.
+  }
+
+  // whole numbers get a trailing '.' so they read as doubles, unless they're
+  // already in exponent form
+  char *end = std::to_chars(first, last, dvr).ptr;
+  double intpart;
+  if (std::isfinite(dvr) && std::modf(dvr, &intpart) == 0.0 &&
+      std::find(first, end, 'e') == end && end != last) {
+    *end++ = '.';
+  }
+  return end;
+}
+
+std::string
+rpn::to_string(const double &dv) {
+  char buf[32];
+  return std::string(buf, rpn::to_chars(buf, buf+sizeof(buf), dv));
+}
+
+/*
+ * object keys and shapes
+ *
+ * both tables only grow; keys and shapes live for the whole process so
+ * objects can hold plain pointers to them.
+ */
+static std::mutex &
+shape_mutex() {
+  static std::mutex sk_mutex;
+  return sk_mutex;
+}
+
+StObject::Key
+StObject::intern(const std::string &name) {
+  static std::unordered_set<std::string> sk_keys;
+  std::lock_guard<std::mutex> lock(shape_mutex());
+  return &*sk_keys.insert(name).first;
+}
+
+const StObject::Shape *
+StObject::Shape::empty() {
+  static const Shape sk_empty;
+  return &sk_empty;
+}
+
+size_t
+StObject::Shape::find(const std::string &name) const {
+  auto i = std::lower_bound(_keys.begin(), _keys.end(), name,
+			    [](Key k, const std::string &n) { return *k < n; });
+  return (i != _keys.end() && **i == name) ? size_t(i - _keys.begin()) : npos;
+}
+
+const StObject::Shape *
+StObject::Shape::with(Key key) const {
+  // one shape per key set, whatever order the keys were added in
+  static std::map<std::vector<Key>,Shape> sk_shapes;
+  std::lock_guard<std::mutex> lock(shape_mutex());
+  auto n = _next.find(key);
+  if (n != _next.end()) {
+    return n->second;
+  }
+  std::vector<Key> keys = _keys;
+  auto at = std::lower_bound(keys.begin(), keys.end(), key,
+			     [](Key a, Key b) { return *a < *b; });
+  keys.insert(at, key);
+  auto s = sk_shapes.try_emplace(keys);
+  if (s.second) {
+    s.first->second._keys = std::move(keys);
+  }
+  _next.emplace(key, &s.first->second);
+  return &s.first->second;
+}
+
+/*
+ * type tags
+ */
+namespace {
+  struct TypeEntry {
+    const std::type_info *type = nullptr;
+    std::string name;
+    rpn::TypeRegistry::Ops ops;
+  };
+
+  template<typename T> bool same_equal(const rpn::Stack::Object &a, const rpn::Stack::Object &b) {
+    return static_cast<const T&>(a).val() == static_cast<const T&>(b).val();
+  }
+  // booleans don't order, they keep the throwing operator<
+  template<typename T> bool same_less(const rpn::Stack::Object &a, const rpn::Stack::Object &b) {
+    return static_cast<const T&>(a).val() < static_cast<const T&>(b).val();
+  }
+
+  // entries never move, so they're read without the lock
+  class Registry {
+  public:
+    Registry() : _entries(new TypeEntry[rpn::TypeRegistry::k_maxTypes]) {
+      put(rpn::tt_any, typeid(rpn::Stack::Object), "Any", rpn::TypeRegistry::Ops());
+      put(rpn::tt_double, typeid(StDouble), "Double", { same_equal<StDouble>, same_less<StDouble> });
+      put(rpn::tt_integer, typeid(StInteger), "Integer", { same_equal<StInteger>, same_less<StInteger> });
+      put(rpn::tt_boolean, typeid(StBoolean), "Boolean", { same_equal<StBoolean>, nullptr });
+      put(rpn::tt_string, typeid(StString), "String", { same_equal<StString>, same_less<StString> });
+      put(rpn::tt_object, typeid(StObject), "Object", rpn::TypeRegistry::Ops());
+      put(rpn::tt_array, typeid(StArray), "Array", rpn::TypeRegistry::Ops());
+      put(rpn::tt_vec3, typeid(StVec3), "Vec3", rpn::TypeRegistry::Ops());
+      _next = rpn::tt_registered;
+    }
+
+    rpn::TypeTag tag(const std::type_info &t) {
+      std::lock_guard<std::mutex> lg(_mx);
+      auto ti = _tags.find(std::type_index(t));
+      if (ti != _tags.end()) {
+	return ti->second;
+      }
+      if (_next >= rpn::TypeRegistry::k_maxTypes) {
+	throw std::runtime_error(std::string("too many stack types at ") + t.name());
+      }
+      rpn::TypeTag rv = rpn::TypeTag(_next++);
+      put(rv, t, t.name(), rpn::TypeRegistry::Ops());
+      return rv;
+    }
+
+    void describe(rpn::TypeTag tag, const std::string &name, const rpn::TypeRegistry::Ops &ops) {
+      std::lock_guard<std::mutex> lg(_mx);
+      _entries[tag].name = name;
+      _entries[tag].ops = ops;
+    }
+
+    const TypeEntry &entry(rpn::TypeTag tag) const { return _entries[tag]; }
+    size_t size() const { return _next; }
+
+  private:
+    void put(rpn::TypeTag tag, const std::type_info &t, const std::string &name, const rpn::TypeRegistry::Ops &ops) {
+      _entries[tag].type = &t;
+      _entries[tag].name = name;
+      _entries[tag].ops = ops;
+      _tags.emplace(std::type_index(t), tag);
+    }
+
+    std::mutex _mx;
+    std::unique_ptr<TypeEntry[]> _entries;
+    std::unordered_map<std::type_index,rpn::TypeTag> _tags;
+    std::atomic<size_t> _next{0};
+  };
+
+  Registry &registry() {
+    static Registry sk_registry;
+    return sk_registry;
+  }
+}
+
+rpn::TypeTag
+rpn::TypeRegistry::tag(const std::type_info &t) {
+  return registry().tag(t);
+}
+
+rpn::TypeTag
+rpn::TypeRegistry::add(const std::type_info &t, const std::string &name, const Ops &ops) {
+  TypeTag rv = registry().tag(t);
+  registry().describe(rv, name, ops);
+  return rv;
+}
+
+const std::string &
+rpn::TypeRegistry::name(TypeTag tag) {
+  return registry().entry(tag).name;
+}
+
+const rpn::TypeRegistry::Ops &
+rpn::TypeRegistry::ops(TypeTag tag) {
+  return registry().entry(tag).ops;
+}
+
+size_t
+rpn::TypeRegistry::size() {
+  return registry().size();
+}
+
+/*
+ * an object that hasn't been on a stack yet (an array element, say).  a
+ * few types a thread has seen recently are kept so this is rarely more
+ * than a compare
+ */
+rpn::TypeTag
+rpn::Stack::Object::lookup_tag() const {
+  struct Seen {
+    const std::type_info *type;
+    TypeTag tag;
+  };
+  static thread_local Seen tl_seen[8] = {};
+  const std::type_info &t = typeid(*this);
+  Seen &s = tl_seen[(reinterpret_cast<uintptr_t>(&t) >> 4) & 7];
+  if (s.type != &t) {
+    s.tag = TypeRegistry::tag(t);
+    s.type = &t;
+  }
+  return s.tag;
+}
+
+void
+rpn::Stack::stamp(Object &ob) {
+  if (ob._tag == tt_untagged) {
+    ob._tag = ob.lookup_tag();
+  }
+}
 
 /*
  * primitives for stack operations
  */
 
+rpn::Stack::Entry &
+rpn::Stack::entry(int n) {
+  if(n>0 && _stack.size()>=size_t(n)) {
+    return *(_stack.begin()+n-1);
+  } else {
+    std::string err = "peek: invalid paramaters (n ";
+    err += std::to_string(n) + ") (depth " + std::to_string(_stack.size()) + ")";
+    throw std::runtime_error(err);
+  }
+}
+
+const std::string &
+rpn::Stack::text(Entry &e) {
+  if (e.textDecimals != _format.decimals) {
+    NumberFormat::Use fmt(_format);
+    e.text = std::string(*e.ob);
+    e.textDecimals = _format.decimals;
+  }
+  return e.text;
+}
+
+void
+rpn::Stack::touch(size_t n) {
+  _generation++;
+  n = std::min(n, _stack.size());
+  for(auto i=_stack.begin(); n; i++, n--) {
+    i->changed = _generation;
+  }
+}
+
+uint64_t
+rpn::Stack::changes(uint64_t since, int n, std::vector<Change> &out) {
+  size_t depth = _stack.size();
+  size_t level = 1;
+  for(auto i=_stack.begin(); i!=_stack.end() && level<=size_t(n); i++, level++) {
+    if (i->changed > since) {
+      out.push_back({ depth-level, text(*i) });
+    }
+  }
+  return _generation;
+}
+
+void
+rpn::Stack::setPrecision(int decimals) {
+  if (decimals != _format.decimals) {
+    _format.decimals = decimals;
+    touch(_stack.size()); // every cached rendering is stale
+  }
+}
+
 std::vector<size_t>
 rpn::Stack::types() const {
   std::vector<size_t> types;
   for(auto const &v : _stack) {
-    auto &vt = *v;
-    types.push_back(typeid(vt).hash_code());
+    types.push_back(v.ob->_tag);
   }
   return types;
 }
 
 void
 rpn::Stack::push(const Object &ob) {
-  std::unique_ptr<Object> ptr = ob.deep_copy();
-  _stack.push_front(std::move(ptr));
+  push(ob.deep_copy());
+}
+
+void
+rpn::Stack::push(std::unique_ptr<Object> ob) {
+  stamp(*ob);
+  _stack.push_front(Entry(std::move(ob), ++_generation));
+}
+
+void
+rpn::Stack::pushn(std::vector<std::unique_ptr<Object>> &&obs) {
+  ++_generation;
+  for(auto &ob : obs) {
+    stamp(*ob);
+    _stack.push_front(Entry(std::move(ob), _generation));
+  }
+  obs.clear();
 }
 
 void
@@ -61,64 +369,81 @@ std::unique_ptr<rpn::Stack::Object>
 rpn::Stack::pop() {
   std::unique_ptr<Object> rv(nullptr);
   if (_stack.size()>0) {
-    rv = std::move(_stack.front());
+    rv = std::move(_stack.front().ob);
     _stack.pop_front();
+    _generation++;
+  }
+  return rv;
+}
+
+std::vector<std::unique_ptr<rpn::Stack::Object>>
+rpn::Stack::popn(size_t n) {
+  std::vector<std::unique_ptr<Object>> rv;
+  if (n <= _stack.size()) {
+    rv.reserve(n);
+    for(auto i=_stack.begin()+n; i!=_stack.begin(); ) {
+      rv.push_back(std::move((--i)->ob));
+    }
+    _stack.erase(_stack.begin(), _stack.begin()+n);
+    _generation++;
   }
   return rv;
 }
 
+// the tag says what it is, no dynamic_cast
+template<typename T> static const T *
+tagged(const rpn::Stack::Object &ob, rpn::TypeTag tag) {
+  return (ob.tag() == tag) ? static_cast<const T*>(&ob) : nullptr;
+}
+
+static std::runtime_error
+not_a(const rpn::Stack::Object &ob, rpn::TypeTag needed) {
+  std::string msg("top of stack not ");
+  msg += rpn::TypeRegistry::name(needed);
+  msg += " (tos ";
+  msg += rpn::TypeRegistry::name(ob.tag());
+  msg += ")";
+  return std::runtime_error(msg);
+}
+
 bool
 rpn::Stack::pop_boolean() {
   auto tos = pop();
-  auto *typed = dynamic_cast<StBoolean*>(tos.get());
+  auto *typed = tagged<StBoolean>(*tos, tt_boolean);
   if (typed) {
     return bool(*typed);
   }
-  throw std::runtime_error("top of stack not boolean");
+  throw not_a(*tos, tt_boolean);
 }
 
 std::string
 rpn::Stack::pop_string() {
   auto tos = pop();
-  auto *typed = dynamic_cast<StString*>(tos.get());
+  auto *typed = tagged<StString>(*tos, tt_string);
   if (typed) {
-    return std::string(*typed);
+    return typed->val();
   }
-  throw std::runtime_error("top of stack not string");
+  throw not_a(*tos, tt_string);
 }
 
 int64_t
 rpn::Stack::pop_integer() {
   auto tos = pop();
-  auto *typed = dynamic_cast<StInteger*>(tos.get());
+  auto *typed = tagged<StInteger>(*tos, tt_integer);
   if (typed) {
-    return *typed;
-  }
-  auto h1 =typeid(tos.get()).hash_code();
-  auto h2 = typeid(StInteger*).hash_code();
-  std::string msg("top of stack not double (tos ");
-  msg += std::to_string(h1);
-  msg += ") (needed ";
-  msg += std::to_string(h2);
-  msg += ")";
-  throw std::runtime_error(msg);
+    return typed->val();
+  }
+  throw not_a(*tos, tt_integer);
 }
 
 double
 rpn::Stack::pop_double() {
   auto tos = pop();
-  auto *typed = dynamic_cast<StDouble*>(tos.get());
+  auto *typed = tagged<StDouble>(*tos, tt_double);
   if (typed) {
-    return double(*typed);
-  }
-  auto h1 =typeid(tos.get()).hash_code();
-  auto h2 = typeid(StDouble*).hash_code();
-  std::string msg("top of stack not double (tos ");
-  msg += std::to_string(h1);
-  msg += ") (needed ";
-  msg += std::to_string(h2);
-  msg += ")";
-  throw std::runtime_error(msg);
+    return typed->val();
+  }
+  throw not_a(*tos, tt_double);
 }
 
 double
@@ -131,75 +456,88 @@ rpn::Stack::pop_as_double() {
 bool
 rpn::Stack::pop_as_boolean() {
   auto tos = pop();
-  auto raw = tos.get();
   bool val=false;
 
-  auto *bp = dynamic_cast<StBoolean*>(raw);
-  auto *sp = dynamic_cast<StString*>(raw);
-  auto *dp = dynamic_cast<StDouble*>(raw);
-  auto *ip = dynamic_cast<StInteger*>(raw);
-
-  if (bp) {
-    val = *bp;
-
-  } else if (ip) {
-    val = int64_t(*ip) != 0;
-
-  } else if (dp) {
-    val = double(*dp) != 0.;
-
-  } else if (sp) {
-    val = (std::string(*sp)!="");
-
+  switch(tos->tag()) {
+  case tt_boolean:
+    val = static_cast<const StBoolean&>(*tos);
+    break;
+  case tt_integer:
+    val = static_cast<const StInteger&>(*tos).val() != 0;
+    break;
+  case tt_double:
+    val = static_cast<const StDouble&>(*tos).val() != 0.;
+    break;
+  case tt_string:
+    val = static_cast<const StString&>(*tos).val() != "";
+    break;
   }
-  
+
   return val;
 }
 
+// callers may change the object in place, so this counts as a change
 rpn::Stack::Object &
 rpn::Stack::peek(int n) {
-  if(n>0 && _stack.size()>=n) {
-    return **(_stack.begin()+n-1);
-  } else {
-    std::string err = "peek: invalid paramaters (n ";
-    err += std::to_string(n) + ") (depth " + std::to_string(_stack.size()) + ")";
-    throw std::runtime_error(err);
-  }
+  auto &e = entry(n);
+  e.changed = ++_generation;
+  e.textDecimals = -1;
+  return *e.ob;
+}
+
+const rpn::Stack::Object &
+rpn::Stack::peek_const(int n) {
+  return *entry(n).ob;
 }
 
 bool
 rpn::Stack::peek_boolean(int n) {
-  auto const &sv = dynamic_cast<const StBoolean&>(peek(n));
+  auto &ob = *entry(n).ob;
+  if (ob.tag() != tt_boolean) {
+    throw std::bad_cast();
+  }
+  auto const &sv = static_cast<const StBoolean&>(ob);
   return sv;
 }
 
 std::string
 rpn::Stack::peek_string(int n) {
-  auto const &sv = dynamic_cast<const StString&>(peek(n));
+  auto &ob = *entry(n).ob;
+  if (ob.tag() != tt_string) {
+    throw std::bad_cast();
+  }
+  auto const &sv = static_cast<const StString&>(ob);
   return sv;
 }
 
 std::string
 rpn::Stack::peek_as_string(int n) {
-  auto const &sv = peek(n);
-  return (std::string)sv;
+  return text(entry(n));
 }
 
 int64_t
 rpn::Stack::peek_integer(int n) {
-  auto const &sv = dynamic_cast<const StInteger&>(peek(n));
+  auto &ob = *entry(n).ob;
+  if (ob.tag() != tt_integer) {
+    throw std::bad_cast();
+  }
+  auto const &sv = static_cast<const StInteger&>(ob);
   return sv;
 }
 
 double
 rpn::Stack::peek_double(int n) {
-  auto const &sv = dynamic_cast<const StDouble&>(peek(n));
+  auto &ob = *entry(n).ob;
+  if (ob.tag() != tt_double) {
+    throw std::bad_cast();
+  }
+  auto const &sv = static_cast<const StDouble&>(ob);
   return sv;
 }
 
 double
 rpn::Stack::peek_as_double(int n) {
-  auto &raw = peek(n);
+  auto &raw = *entry(n).ob;
   double val = raw;
   return val;
 }
@@ -207,21 +545,29 @@ rpn::Stack::peek_as_double(int n) {
 void
 rpn::Stack::clear() {
   _stack.clear();
+  _generation++;
+}
+
+void
+rpn::Stack::swap(Stack &other) {
+  _stack.swap(other._stack);
+  touch(_stack.size());
+  other.touch(other._stack.size());
 }
 
 void
 rpn::Stack::dropn(int n) {
-  if (_stack.size()>=n) {
+  if (n>=0 && _stack.size()>=size_t(n)) {
     _stack.erase(_stack.begin(), _stack.begin()+n);
+    _generation++;
   }
 }
 
 void
 rpn::Stack::dupn(int n) {
-  if (_stack.size()>=n) {
+  if (n>=0 && _stack.size()>=size_t(n)) {
     for(int i = n; i; i--) {
-      std::unique_ptr<Object> ptr = (*(_stack.begin()+(n-1)))->deep_copy();
-      _stack.push_front(std::move(ptr));
+      push((_stack.begin()+(n-1))->ob->deep_copy());
     }
   } else {
     // handle error
@@ -231,8 +577,9 @@ rpn::Stack::dupn(int n) {
 
 void
 rpn::Stack::nipn(int n) {
-  if (_stack.size()>=n) {
+  if (n>=0 && _stack.size()>=size_t(n)) {
     _stack.erase(_stack.begin()+(n-1));
+    touch(n-1);
   } else {
     // handle error
     printf("%s: (size %lu) (n %d)\n", __func__, _stack.size(), n);
@@ -241,9 +588,8 @@ rpn::Stack::nipn(int n) {
 
 void
 rpn::Stack::pick(int n) {
-  if (n>0 && _stack.size()>=n) {
-    std::unique_ptr<Object> ptr = (*(_stack.begin()+(n-1)))->deep_copy();
-    _stack.push_front(std::move(ptr));
+  if (n>0 && _stack.size()>=size_t(n)) {
+    push((_stack.begin()+(n-1))->ob->deep_copy());
   } else {
     // throw error?
   }
@@ -251,23 +597,26 @@ rpn::Stack::pick(int n) {
 
 void
 rpn::Stack::reversen(int n) {
-  if (n>0 && n<=_stack.size()) {
+  if (n>0 && size_t(n)<=_stack.size()) {
     std::reverse(_stack.begin(), _stack.begin()+(n));
+    touch(n);
   }
 }
 
 void
 rpn::Stack::reverse() {
   std::reverse(_stack.begin(), _stack.end());
+  touch(_stack.size());
 }
 
 void
 rpn::Stack::rolldn(int n) {
-  if (n>0 && n<=_stack.size()) {
+  if (n>0 && size_t(n)<=_stack.size()) {
     auto i = _stack.begin();
-    auto ptr = std::move(*i);
+    auto e = std::move(*i);
     _stack.erase(i);
-    _stack.insert(_stack.begin()+(n-1), std::move(ptr));
+    _stack.insert(_stack.begin()+(n-1), std::move(e));
+    touch(n);
   } else {
     // handle error
   }
@@ -275,11 +624,12 @@ rpn::Stack::rolldn(int n) {
 
 void
 rpn::Stack::rollun(int n) {
-  if (n>0 && n<=_stack.size()) {
+  if (n>0 && size_t(n)<=_stack.size()) {
     auto i = (_stack.begin()+(n-1));
-    auto ptr = std::move(*i);
+    auto e = std::move(*i);
     _stack.erase(i);
-    _stack.push_front(std::move(ptr));
+    _stack.push_front(std::move(e));
+    touch(n);
   } else {
     // handle error
   }
@@ -287,9 +637,11 @@ rpn::Stack::rollun(int n) {
 
 void
 rpn::Stack::tuckn(int n) {
-  if (n>0 && n<=_stack.size()) {
-    auto ptr = (*_stack.begin())->deep_copy();
-    _stack.insert(_stack.begin()+(n-1), std::move(ptr));
+  if (n>0 && size_t(n)<=_stack.size()) {
+    auto ptr = _stack.begin()->ob->deep_copy();
+    stamp(*ptr);
+    _stack.insert(_stack.begin()+(n-1), Entry(std::move(ptr)));
+    touch(n);
   } else {
     // handle error
   }
@@ -299,6 +651,7 @@ void
 rpn::Stack::swap() {
   if (_stack.size()>1) {
     std::swap(*_stack.begin(), *(_stack.begin()+1));
+    touch(2);
   }
 }
 
@@ -306,6 +659,7 @@ void
 rpn::Stack::drop() {
   if (_stack.size()>0) {
     _stack.pop_front();
+    _generation++;
   }
 }
 
@@ -351,16 +705,16 @@ rpn::Stack::print(const std::string &msg) {
   printf("+---- %02zu -- %s %*.*s+\n", _stack.size(), msg.c_str(), padlen, padlen, padding);
   size_t n = _stack.size();
   for(auto i=_stack.rbegin(); i!=_stack.rend(); i++, n--) {
-    auto &r = **i; // https://stackoverflow.com/questions/46494928/clang-warning-on-expression-side-effects
+    auto &r = *i->ob; // https://stackoverflow.com/questions/46494928/clang-warning-on-expression-side-effects
     char hc[32];
-    snprintf(hc, sizeof(hc), "%08lx", typeid(r).hash_code());
-    std::string type = typeid(r).name();
+    snprintf(hc, sizeof(hc), "%04x", unsigned(r.tag()));
+    std::string type = TypeRegistry::name(r.tag());
     if (type.size() > 30) {
       type.erase(30);
     }
     type += ":";
     type += hc;
-    std::string strval = (*i)->to_string();
+    std::string strval = text(*i);
     if (strval.size() > 40) {
       strval.erase(37);
       strval += "...";
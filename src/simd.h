@@ -0,0 +1,28 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/simd.h
+ *
+ * @file    simd.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+/*
+ * the numeric kernels are plain loops, unit stride over unaliased double
+ * arrays, and leave the vectorizing to the compiler rather than using
+ * intrinsics, so they build the same everywhere.  RESTRICT is the
+ * promise that the arrays don't overlap.
+ */
+#if defined(_MSC_VER)
+#define RESTRICT __restrict
+#else
+#define RESTRICT __restrict__
+#endif
+
+/* end of qinc/rpn-lang/src/simd.h */
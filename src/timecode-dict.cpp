@@ -16,189 +16,265 @@
 #include "fraction.h"
 #include "timecode.h"
 
-/*
- * Reference: https://github.com/bradcordeiro/libedl/blob/master/src/timecode.cpp
- */
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
 static bool
-isDropFrame(unsigned &ifr, const q::Fraction &fr) {
-  ifr = std::ceil(double(fr));
-  bool isDF = (std::floor(double(fr)) != double(fr)); // it's probably more nuanced than this.
-  return isDF;
+good_rate(const q::Fraction &fr) {
+  return (fr._numerator != 0 && fr._denominator != 0 && (fr._numerator > 0) == (fr._denominator > 0));
 }
 
-q::Timecode::Timecode(int64_t h, int64_t m, int64_t s, int64_t f, const q::Fraction &fr) : _day(0), _hour(h), _minute(m), _second(s), _frame(f), _frameRate(fr) {
-  normalize();
+NATIVE_WORD_DECL(timecode, to_tc_if) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  if (!good_rate(PEEK_CAST(const stack::Fraction,rpn.stack.peek_const(2)))) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto frame = rpn.stack.pop_integer();
+  auto ofrac = rpn.stack.pop();
+  const auto &fr = POP_CAST(stack::Fraction,ofrac);
+  rpn.stack.push(stack::Timecode(q::Timecode(frame,fr)));
+  return rv;
 }
 
-int64_t maxFrames(const q::Fraction &fr) {
-  q::Timecode maxtc(23,59,59,std::ceil(double(fr))-1, fr);
-  return maxtc.to_frames();
+// ( 29.97 frames -- tc ) the rate goes through q::Fraction::from_rate()
+NATIVE_WORD_DECL(timecode, to_tc_id) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::Fraction fr = q::Fraction::from_rate(rpn.stack.peek_double(2));
+  if (!good_rate(fr)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto frame = rpn.stack.pop_integer();
+  rpn.stack.pop();
+  rpn.stack.push(stack::Timecode(q::Timecode(frame,fr)));
+  return rv;
 }
 
-q::Timecode::Timecode(int64_t frameInput, const q::Fraction &fr) : _day(0), _hour(0), _minute(0), _second(0), _frame(0), _frameRate(fr) {
-  unsigned ifr;
-  bool isDF = isDropFrame(ifr, _frameRate);
+NATIVE_WORD_DECL(timecode, to_tc_iiiif) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  if (!good_rate(PEEK_CAST(const stack::Fraction,rpn.stack.peek_const(5)))) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto frame = rpn.stack.pop_integer();
+  auto second = rpn.stack.pop_integer();
+  auto minute = rpn.stack.pop_integer();
+  auto hour = rpn.stack.pop_integer();
+  auto ofrac = rpn.stack.pop();
+  const auto &fr = POP_CAST(stack::Fraction,ofrac);
+  rpn.stack.push(stack::Timecode(q::Timecode(hour,minute,second,frame,fr)));
+  return rv;
+}
 
-  int nominal_fps = ifr;
-  int dropCount = nominal_fps / 15;
+NATIVE_WORD_DECL(timecode, to_frames) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto otc = rpn.stack.pop();
+  const auto &tc = POP_CAST(stack::Timecode,otc);
+  rpn.stack.push_integer(tc.to_frames());
+  return rv;
+}
 
-  int frameLimit = maxFrames(fr);
-  int framesPerMin = 60 * nominal_fps;
-  int framesPer10Min = framesPerMin * 10;
-  int framesPerHour = framesPer10Min * 6;
+/*
+ * batches: the rate is looked up once for the whole array, and every
+ * element has to be the right type before anything is converted
+ */
 
-  if (frameInput >= frameLimit) {
-    frameInput %= frameLimit;
+// ( fr [frames] -- [timecodes] )
+NATIVE_WORD_DECL(timecode, to_tc_af) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &fr = PEEK_CAST(const stack::Fraction,rpn.stack.peek_const(2));
+  const auto &frames = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  if (!good_rate(fr)) {
+    return rpn::WordDefinition::Result::param_error;
   }
-
-  if (isDF) {
-    framesPerMin -= (nominal_fps / 15);
-    framesPer10Min = framesPerMin * 10 + dropCount;
-    framesPerHour = framesPer10Min * 6;
+  for(size_t i=0; i<frames.size(); i++) {
+    if (frames.value(i).tag() != rpn::tt_integer) {
+      return rpn::WordDefinition::Result::param_error;
+    }
   }
-
-  _hour = frameInput / framesPerHour;
-  frameInput %= framesPerHour;
-
-  if (isDF) {
-    // By subtracting two frames while calculating minutes and adding them
-    // back in afterward, you avoid landing on an invalid dropframe frame
-    // (frame 0 on any minute except every tenth minute)
-    int ten_minute = frameInput / framesPer10Min;
-    frameInput %= framesPer10Min;
-    frameInput -= dropCount;
-    int unit_minute = frameInput / framesPerMin;
-    frameInput %= framesPerMin;
-    _minute = ten_minute * 10 + unit_minute;
-    frameInput += dropCount;
-  } else {
-    _minute = (frameInput / framesPer10Min);
-    frameInput %= framesPer10Min;
-    _minute += frameInput / framesPerMin;
-    frameInput %= framesPerMin;
+  const q::FrameRate &rate = q::FrameRate::get(fr);
+  StArray::Elements tcs;
+  tcs.reserve(frames.size());
+  for(size_t i=0; i<frames.size(); i++) {
+    int64_t f = static_cast<const StInteger&>(frames.value(i));
+    tcs.push_back(std::make_unique<stack::Timecode>(q::Timecode(f, rate)));
   }
-
-  _second = frameInput / nominal_fps;
-  frameInput %= nominal_fps;
-
-  _frame = frameInput;
+  rpn.stack.pop();
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StArray>(std::move(tcs)));
+  return rv;
 }
 
-q::Timecode::Timecode(const Timecode &rhs) : _day(rhs._day), _hour(rhs._hour), _minute(rhs._minute), _second(rhs._second), _frame(rhs._frame), _frameRate(rhs._frameRate) {
-  normalize();
+// ( [timecodes] -- [frames] )
+NATIVE_WORD_DECL(timecode, to_frames_a) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &tcs = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  for(size_t i=0; i<tcs.size(); i++) {
+    if (tcs.value(i).tag() != rpn::type_tag<stack::Timecode>()) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+  }
+  StArray::Elements frames;
+  frames.reserve(tcs.size());
+  for(size_t i=0; i<tcs.size(); i++) {
+    frames.push_back(std::make_unique<StInteger>(static_cast<const stack::Timecode&>(tcs.value(i)).to_frames()));
+  }
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StArray>(std::move(frames)));
+  return rv;
 }
 
-void
-q::Timecode::normalize() {
-  int64_t ifr = std::ceil(double(_frameRate));
-  int64_t carry = std::floor(_frame/ifr);
-  _frame = _frame%ifr;
-
-  _second += carry;
-  carry = std::floor(_second/60.);
-  _second = _second%60;
-
-  _minute += carry;
-  carry = std::floor(_minute/60.);
-  _minute = _minute%60;
-
-  _hour += carry;
-  carry = std::floor(_hour/24.);
-  _hour = _hour%24;
-
-  _day += carry; // do we care about this?
+/*
+ * the session rate, for timecode literals and EDL->
+ */
+NATIVE_WORD_DECL(timecode, to_fps_f) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &fr = PEEK_CAST(const stack::Fraction,rpn.stack.peek_const(1));
+  if (!good_rate(fr)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.setFrameRate(q::FrameRate::get(fr));
+  rpn.stack.pop();
+  return rv;
 }
 
-bool
-q::Timecode::operator==(const q::Timecode &rhs) const {
-  return (_hour == rhs._hour &&
-	  _minute == rhs._minute &&
-	  _second == rhs._second &&
-	  _frame == rhs._frame &&
-	  _frameRate == rhs._frameRate);
+NATIVE_WORD_DECL(timecode, to_fps_i) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  if (rpn.stack.peek_integer(1) <= 0) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.setFrameRate(q::FrameRate::get(q::Fraction(rpn.stack.pop_integer(), 1)));
+  return rv;
 }
 
-q::Timecode
-q::Timecode::operator+(const q::Timecode &rhs) const {
-  return rhs;
+NATIVE_WORD_DECL(timecode, to_fps_d) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  q::Fraction fr = q::Fraction::from_rate(rpn.stack.peek_double(1));
+  if (!good_rate(fr)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.setFrameRate(q::FrameRate::get(fr));
+  rpn.stack.pop();
+  return rv;
 }
 
-q::Timecode
-q::Timecode::operator-(const q::Timecode &rhs) const {
-  return *this;
+NATIVE_WORD_DECL(timecode, fps_to) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const q::FrameRate &rate = rpn.frameRate();
+  rpn.stack.push(stack::Fraction(rate.numerator, rate.denominator));
+  return rv;
 }
 
-q::Timecode
-q::Timecode::operator+(int64_t &rhs) const {
-  return *this;
+/*
+ * ( "path" -- [events] ) reads a CMX3600 edit decision list a line at a
+ * time.  each event line becomes an object with
+ *   event       integer
+ *   reel, track, transition   strings, "D", "W001", "K B" etc
+ *   duration    frames, 0 for cuts
+ *   src-in, src-out, rec-in, rec-out   timecodes at the session rate
+ *   clip        from a "* FROM CLIP NAME:" comment after it, or ""
+ * TITLE:, FCM: and other comments are skipped.  a file that won't open or
+ * an event that won't parse is a param_error and leaves the path in place.
+ */
+static bool
+all_digits(const std::string &s) {
+  return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; });
 }
 
-q::Timecode
-q::Timecode::operator-(int64_t &rhs) const {
-  return *this;
+static bool
+edl_number(const std::string &s, int64_t &n) {
+  auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+  return ec == std::errc() && end == s.data() + s.size();
 }
 
-int64_t
-q::Timecode::to_frames() const {
-  unsigned ifr;
-  bool isDF = isDropFrame(ifr, _frameRate);
-  int nominal_fps = ifr;
-  int framesPerMin = 60 * nominal_fps;
-  int framesPer10Min = framesPerMin * 10;
-  int framesPerHour = framesPer10Min * 6;
-  int totalFrames = 0;
-
-  if (isDF) {
-    int dropCount = nominal_fps / 15;
-    framesPerMin -= dropCount;
-    framesPer10Min = (framesPerMin * 10) + dropCount;
-    framesPerHour = framesPer10Min * 6;
+static bool
+edl_event(const std::vector<std::string> &fields, const q::FrameRate &rate, StObject &event) {
+  if (fields.size() < 8) {
+    return false;
+  }
+  q::Fraction fr(rate.numerator, rate.denominator);
+  static const char *sk_tcNames[] = { "src-in", "src-out", "rec-in", "rec-out" };
+  size_t tc0 = fields.size() - 4;
+  for(size_t i=0; i<4; i++) {
+    int64_t h, m, s, f;
+    if (!q::Timecode::parse(fields[tc0+i], rate, h, m, s, f)) {
+      return false;
+    }
+    event.add_value(sk_tcNames[i], stack::Timecode(q::Timecode(h, m, s, f, fr)));
   }
 
-  totalFrames += _hour * framesPerHour;
-  totalFrames += (_minute % 10) * framesPerMin;
-  totalFrames += (_minute / 10) * framesPer10Min;
-  totalFrames += _second * nominal_fps;
-  totalFrames += _frame;
-
-  return totalFrames;
-}
-
-std::string
-q::Timecode::to_string() const {
-  double fr = _frameRate;
-  bool isDF = (std::floor(fr) != fr); // it's probably more nuanced than this.
-  char tmp[64];
-  snprintf(tmp, sizeof(tmp), "TC/%s %02d:%02d:%02d%c%02d @ %2.2f", (isDF?"DF":"NDF"), _hour, _minute, _second, (isDF?';':':'), _frame, double(_frameRate));
-  return tmp;
+  // the transition's duration follows it, if it has one
+  size_t end = tc0;
+  int64_t duration = 0;
+  if (end - 3 > 1 && all_digits(fields[end-1]) && !edl_number(fields[--end], duration)) {
+    return false;
+  }
+  std::string transition = fields[3];
+  for(size_t i=4; i<end; i++) {
+    transition += " " + fields[i];
+  }
+  int64_t number;
+  if (!edl_number(fields[0], number)) {
+    return false;
+  }
+  event.add_value("event", StInteger(number));
+  event.add_value("reel", StString(fields[1]));
+  event.add_value("track", StString(fields[2]));
+  event.add_value("transition", StString(transition));
+  event.add_value("duration", StInteger(duration));
+  return true;
 }
 
-NATIVE_WORD_DECL(timecode, to_tc_if) {
+NATIVE_WORD_DECL(timecode, edl_to) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto frame = rpn.stack.pop_integer();
-  auto ofrac = rpn.stack.pop();
-  const auto &fr = POP_CAST(stack::Fraction,ofrac);
-  rpn.stack.push(stack::Timecode(q::Timecode(frame,fr)));
-  return rv;
-}
+  std::string path = rpn.stack.peek_string(1);
+  std::ifstream ifs(path);
+  if (!ifs) {
+    return rpn::WordDefinition::Result::param_error;
+  }
 
-NATIVE_WORD_DECL(timecode, to_tc_iiiif) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto frame = rpn.stack.pop_integer();
-  auto second = rpn.stack.pop_integer();
-  auto minute = rpn.stack.pop_integer();
-  auto hour = rpn.stack.pop_integer();
-  auto ofrac = rpn.stack.pop();
-  const auto &fr = POP_CAST(stack::Fraction,ofrac);
-  rpn.stack.push(stack::Timecode(q::Timecode(hour,minute,second,frame,fr)));
-  return rv;
-}
+  const q::FrameRate &rate = rpn.frameRate();
+  StArray::Elements events;
+  std::unique_ptr<StObject> event; // held until its clip name might turn up
+  std::string clip;
+  auto flush = [&]() {
+    if (event) {
+      event->add_value("clip", StString(clip));
+      events.push_back(std::move(event));
+    }
+    clip.clear();
+  };
+
+  static const std::string sk_clipName = "* FROM CLIP NAME:";
+  std::string line;
+  while (rv == rpn::WordDefinition::Result::ok && std::getline(ifs, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    std::istringstream words(line);
+    std::vector<std::string> fields;
+    for(std::string w; words >> w; ) {
+      fields.push_back(w);
+    }
+
+    if (!fields.empty() && all_digits(fields[0])) {
+      flush();
+      event = std::make_unique<StObject>();
+      if (!edl_event(fields, rate, *event)) {
+	rv = rpn::WordDefinition::Result::param_error;
+      }
+
+    } else if (line.compare(0, sk_clipName.size(), sk_clipName) == 0) {
+      clip = line.substr(sk_clipName.size());
+      clip.erase(0, clip.find_first_not_of(" \t"));
+      clip.erase(clip.find_last_not_of(" \t") + 1);
+    }
+  }
 
-NATIVE_WORD_DECL(timecode, to_frames) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto otc = rpn.stack.pop();
-  const auto &tc = POP_CAST(stack::Timecode,otc);
-  rpn.stack.push_integer(tc.to_frames());
+  if (rv == rpn::WordDefinition::Result::ok) {
+    flush();
+    rpn.stack.pop();
+    rpn.stack.push(std::make_unique<StArray>(std::move(events)));
+  }
   return rv;
 }
 
@@ -214,14 +290,35 @@ void
 rpn::Interp::addTimecodeWords() {
   rpn::Interp &rpn = *this; // in case we want to move this out someday
   rpn.addDefinition("->TC", NATIVE_WORD_WDEF(timecode, frac_validator::d2_int_frac, to_tc_if, nullptr));
+  rpn.addDefinition("->TC", NATIVE_WORD_WDEF(timecode, rpn::StrictTypeValidator::d2_integer_double, to_tc_id, nullptr));
   rpn.addDefinition("->TC", NATIVE_WORD_WDEF(timecode, frac_validator::d5_int_int_int_int_frac, to_tc_iiiif, nullptr));
   rpn.addDefinition("FR", NATIVE_WORD_WDEF(timecode, timecode_validator::d1_tc, framerate, nullptr));
+  rpn.addDefinition("->TC", NATIVE_WORD_WDEF(timecode, timecode_validator::d2_array_frac, to_tc_af, nullptr));
   rpn.addDefinition("->FRAMES", NATIVE_WORD_WDEF(timecode, timecode_validator::d1_tc, to_frames, nullptr));
+  rpn.addDefinition("->FRAMES", NATIVE_WORD_WDEF(timecode, rpn::StrictTypeValidator::d1_array, to_frames_a, nullptr));
+  rpn.addDefinition("->FPS", NATIVE_WORD_WDEF(timecode, frac_validator::d1_frac, to_fps_f, nullptr));
+  rpn.addDefinition("->FPS", NATIVE_WORD_WDEF(timecode, rpn::StrictTypeValidator::d1_integer, to_fps_i, nullptr));
+  rpn.addDefinition("->FPS", NATIVE_WORD_WDEF(timecode, rpn::StrictTypeValidator::d1_double, to_fps_d, nullptr));
+  rpn.addDefinition("FPS->", NATIVE_WORD_WDEF(timecode, rpn::StackSizeValidator::zero, fps_to, nullptr));
+  rpn.addDefinition("EDL->", NATIVE_WORD_WDEF(timecode, rpn::StrictTypeValidator::d1_string, edl_to, nullptr));
 }
 
-const rpn::StrictTypeValidator timecode_validator::d1_tc({typeid(stack::Timecode).hash_code()}, "d1_tc");
-const rpn::StrictTypeValidator timecode_validator::d2_tc_tc({typeid(stack::Timecode).hash_code(),typeid(stack::Timecode).hash_code()}, "d2_tc_tc");
-const rpn::StrictTypeValidator timecode_validator::d2_int_tc({typeid(StInteger).hash_code(),typeid(stack::Timecode).hash_code()}, "d2_int_tc");
-const rpn::StrictTypeValidator timecode_validator::d2_tc_int({typeid(stack::Timecode).hash_code(),typeid(StInteger).hash_code()}, "d2_tc_int");
+static const rpn::TypeTag sk_timecodeTag = rpn::TypeRegistry::add<stack::Timecode>("Timecode");
+
+const rpn::StrictTypeValidator timecode_validator::d1_tc({rpn::type_tag<stack::Timecode>()}, "d1_tc");
+const rpn::StrictTypeValidator timecode_validator::d2_tc_tc({rpn::type_tag<stack::Timecode>(),rpn::type_tag<stack::Timecode>()}, "d2_tc_tc");
+const rpn::StrictTypeValidator timecode_validator::d2_int_tc({rpn::type_tag<StInteger>(),rpn::type_tag<stack::Timecode>()}, "d2_int_tc");
+const rpn::StrictTypeValidator timecode_validator::d2_tc_int({rpn::type_tag<stack::Timecode>(),rpn::type_tag<StInteger>()}, "d2_tc_int");
+const rpn::StrictTypeValidator timecode_validator::d2_array_frac({rpn::type_tag<StArray>(),rpn::type_tag<stack::Fraction>()}, "d2_array_frac");
+
+static const bool sk_timecodeImage = rpn::ImageReader::addType("Timecode", [](rpn::ImageReader &r) {
+    int64_t h = r.i64();
+    int64_t m = r.i64();
+    int64_t s = r.i64();
+    int64_t f = r.i64();
+    int64_t n = r.i64();
+    int64_t d = r.i64();
+    return std::make_unique<stack::Timecode>(q::Timecode(h, m, s, f, q::Fraction(n, d)));
+  });
 
 /* end of QInc/Projects/color-calc/src/libs/rpn-lang/src/timecode-dict.cpp */
@@ -0,0 +1,241 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/timecode.cpp
+ *
+ * @file    timecode.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2024-2026
+ * @copyright (C) Copyright Q, Inc. 2024-2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "timecode.h"
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+/****************************************
+ * frame rate descriptors
+ *
+ * Reference: https://github.com/bradcordeiro/libedl/blob/master/src/timecode.cpp
+ */
+
+static const q::FrameRate *
+make_rate(int64_t n, int64_t d) {
+  auto *rv = new q::FrameRate;
+  rv->numerator = n;
+  rv->denominator = d;
+  rv->dropFrame = (n % d) != 0; // it's probably more nuanced than this.
+  rv->nominal = (n + d - 1) / d;
+  rv->dropCount = rv->dropFrame ? rv->nominal / 15 : 0;
+  rv->perMinute = 60 * rv->nominal - rv->dropCount;
+  rv->per10Minutes = rv->perMinute * 10 + rv->dropCount;
+  rv->perHour = rv->per10Minutes * 6;
+  rv->perDay = rv->perHour * 24;
+  return rv;
+}
+
+const q::FrameRate &
+q::FrameRate::get(const q::Fraction &fr) {
+  int64_t n = fr._numerator;
+  int64_t d = fr._denominator;
+  if (d < 0) {
+    n = -n;
+    d = -d;
+  }
+  if (n <= 0 || d == 0) {
+    throw std::range_error("timecode: frame rate must be positive");
+  }
+  int64_t g = std::gcd(n, d);
+  n /= g;
+  d /= g;
+
+  // conversions come in runs at one rate, so remember the last one
+  thread_local const q::FrameRate *last = nullptr;
+  if (last != nullptr && last->numerator == n && last->denominator == d) {
+    return *last;
+  }
+
+  static std::mutex mx;
+  static std::map<std::pair<int64_t,int64_t>,std::unique_ptr<const q::FrameRate>> rates;
+  std::lock_guard lg(mx);
+  auto &slot = rates[{n, d}];
+  if (!slot) {
+    slot.reset(make_rate(n, d));
+  }
+  last = slot.get();
+  return *last;
+}
+
+/****************************************
+ * timecode methods
+ */
+
+// rounds toward negative infinity, leaves the remainder in [0,d)
+static int64_t
+floor_div(int64_t &v, int64_t d) {
+  int64_t q = v / d;
+  v %= d;
+  if (v < 0) {
+    v += d;
+    q--;
+  }
+  return q;
+}
+
+q::Timecode::Timecode(int64_t h, int64_t m, int64_t s, int64_t f, const q::Fraction &fr) : _day(0), _hour(h), _minute(m), _second(s), _frame(f), _frameRate(fr), _rate(&FrameRate::get(fr)) {
+  normalize();
+}
+
+q::Timecode::Timecode(int64_t frameInput, const q::Fraction &fr) : _day(0), _hour(0), _minute(0), _second(0), _frame(0), _frameRate(fr), _rate(&FrameRate::get(fr)) {
+  set_frames(frameInput);
+}
+
+q::Timecode::Timecode(int64_t frameInput, const FrameRate &rate) : _day(0), _hour(0), _minute(0), _second(0), _frame(0), _frameRate(rate.numerator, rate.denominator), _rate(&rate) {
+  set_frames(frameInput);
+}
+
+// frame counts wrap at 24 hours
+void
+q::Timecode::set_frames(int64_t frameInput) {
+  const FrameRate &r = *_rate;
+  floor_div(frameInput, r.perDay);
+
+  _hour = frameInput / r.perHour;
+  frameInput %= r.perHour;
+
+  if (r.dropFrame) {
+    // By subtracting the dropped frames while calculating minutes and adding
+    // them back in afterward, you avoid landing on an invalid dropframe frame
+    // (frame 0 on any minute except every tenth minute)
+    int64_t ten_minute = frameInput / r.per10Minutes;
+    frameInput %= r.per10Minutes;
+    frameInput -= r.dropCount;
+    int64_t unit_minute = frameInput / r.perMinute;
+    frameInput %= r.perMinute;
+    _minute = ten_minute * 10 + unit_minute;
+    frameInput += r.dropCount;
+  } else {
+    _minute = frameInput / r.perMinute;
+    frameInput %= r.perMinute;
+  }
+
+  _second = frameInput / r.nominal;
+  _frame = frameInput % r.nominal;
+}
+
+void
+q::Timecode::normalize() {
+  int64_t v = _frame;
+  int64_t carry = floor_div(v, _rate->nominal);
+  _frame = v;
+
+  v = _second + carry;
+  carry = floor_div(v, 60);
+  _second = v;
+
+  v = _minute + carry;
+  carry = floor_div(v, 60);
+  _minute = v;
+
+  v = _hour + carry;
+  carry = floor_div(v, 24);
+  _hour = v;
+
+  _day += carry; // do we care about this?
+}
+
+bool
+q::Timecode::operator==(const q::Timecode &rhs) const {
+  return (_hour == rhs._hour &&
+	  _minute == rhs._minute &&
+	  _second == rhs._second &&
+	  _frame == rhs._frame &&
+	  (_rate == rhs._rate || _frameRate == rhs._frameRate));
+}
+
+// frames / rate, cross multiplied.  a day's frames times a reduced rate
+// stays well inside 64 bits
+bool
+q::Timecode::operator<(const q::Timecode &rhs) const {
+  if (_rate == rhs._rate) {
+    return to_frames() < rhs.to_frames();
+  }
+  return (to_frames() * _rate->denominator * rhs._rate->numerator <
+	  rhs.to_frames() * rhs._rate->denominator * _rate->numerator);
+}
+
+q::Timecode
+q::Timecode::operator+(const q::Timecode &rhs) const {
+  return rhs;
+}
+
+q::Timecode
+q::Timecode::operator-(const q::Timecode &/*rhs*/) const {
+  return *this;
+}
+
+q::Timecode
+q::Timecode::operator+(int64_t &/*rhs*/) const {
+  return *this;
+}
+
+q::Timecode
+q::Timecode::operator-(int64_t &/*rhs*/) const {
+  return *this;
+}
+
+int64_t
+q::Timecode::to_frames() const {
+  const FrameRate &r = *_rate;
+  return (_hour * r.perHour +
+	  (_minute / 10) * r.per10Minutes +
+	  (_minute % 10) * r.perMinute +
+	  _second * r.nominal +
+	  _frame);
+}
+
+bool
+q::Timecode::parse(const std::string &text, const FrameRate &rate, int64_t &h, int64_t &m, int64_t &s, int64_t &f) {
+  int64_t fields[4] = { 0, 0, 0, 0 };
+  size_t n = 0;
+  size_t i = 0;
+  while (n < 4) {
+    size_t start = i;
+    int64_t v = 0;
+    for(; i < text.size() && i-start < 3 && text[i] >= '0' && text[i] <= '9'; i++) {
+      v = v*10 + (text[i] - '0');
+    }
+    if (i == start) {
+      return false;
+    }
+    fields[n++] = v;
+    if (n < 4) {
+      if (i >= text.size() || !(text[i] == ':' || text[i] == ';')) {
+	return false;
+      }
+      i++;
+    }
+  }
+  h = fields[0];
+  m = fields[1];
+  s = fields[2];
+  f = fields[3];
+  return (i == text.size() && h < 24 && m < 60 && s < 60 && f < rate.nominal);
+}
+
+std::string
+q::Timecode::to_string() const {
+  bool isDF = _rate->dropFrame;
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "TC/%s %02d:%02d:%02d%c%02d @ %2.2f", (isDF?"DF":"NDF"), _hour, _minute, _second, (isDF?';':':'), _frame, double(_frameRate));
+  return tmp;
+}
+
+/* end of qinc/rpn-lang/src/timecode.cpp */
@@ -17,14 +17,36 @@
 #include "fraction.h"
 
 namespace q {
+  /*
+   * everything a conversion needs to know about a frame rate, worked out
+   * once.  descriptors are interned on the reduced rate, so they live
+   * forever and equal rates share one
+   */
+  struct FrameRate {
+    static const FrameRate &get(const q::Fraction &fr); // throws std::range_error unless fr > 0
+
+    int64_t numerator;   // reduced
+    int64_t denominator;
+    bool dropFrame;      // any rate that isn't a whole number
+    int64_t nominal;     // frames counted per timecode second
+    int64_t dropCount;   // frame numbers skipped per minute, except every tenth
+    int64_t perMinute;
+    int64_t per10Minutes;
+    int64_t perHour;
+    int64_t perDay;
+  };
+
   class Timecode {
   public:
     Timecode(int64_t frames, const q::Fraction &fr);
+    Timecode(int64_t frames, const FrameRate &rate); // no lookup, for batches
     Timecode(int64_t h, int64_t m, int64_t s, int64_t f, const q::Fraction &fr);
-    Timecode(const Timecode &rhs);
+    Timecode(const Timecode &rhs) = default;
     void normalize();
 
     bool operator==(const Timecode &rhs) const;
+    bool operator<(const Timecode &rhs) const; // in time, so rates can differ
+    bool operator>(const Timecode &rhs) const { return rhs < *this; }
     std::string to_string() const;
     Timecode operator+(const Timecode &rhs) const;
     Timecode operator-(const Timecode &rhs) const;
@@ -33,6 +55,10 @@ namespace q {
 
     int64_t to_frames() const;
 
+    // "HH:MM:SS:FF", drop frame's ';' separators are fine too.  false
+    // unless every field is in range for rate
+    static bool parse(const std::string &text, const FrameRate &rate, int64_t &h, int64_t &m, int64_t &s, int64_t &f);
+
     //  private: // do we really care about privatizing these
 
     int _day; // really just for addition carry
@@ -42,6 +68,10 @@ namespace q {
     int _frame;
 
     q::Fraction _frameRate;
+    const FrameRate *_rate;
+
+  private:
+    void set_frames(int64_t frames);
   };
 }
 
@@ -56,6 +86,14 @@ public:
       const stack::Timecode &rhs = PEEK_CAST(const stack::Timecode,orhs);
       return ((const q::Timecode &)*this) == ((const q::Timecode &)rhs);
     };
+    virtual bool operator<(const Object &orhs) const override {
+      const stack::Timecode &rhs = PEEK_CAST(const stack::Timecode,orhs);
+      return ((const q::Timecode &)*this) < ((const q::Timecode &)rhs);
+    };
+    virtual bool operator>(const Object &orhs) const override {
+      const stack::Timecode &rhs = PEEK_CAST(const stack::Timecode,orhs);
+      return ((const q::Timecode &)*this) > ((const q::Timecode &)rhs);
+    };
 
     virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Timecode>(*this); };
     virtual operator std::string() const override {
@@ -68,6 +106,16 @@ public:
       rv += std::to_string(_frameRate._denominator) + " ->FRAC ->TC";
       return rv;
     }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("Timecode");
+      w.i64(_hour);
+      w.i64(_minute);
+      w.i64(_second);
+      w.i64(_frame);
+      w.i64(_frameRate._numerator);
+      w.i64(_frameRate._denominator);
+      return true;
+    }
   };
 } // namespace stack
 
@@ -76,6 +124,7 @@ namespace timecode_validator {
   extern const rpn::StrictTypeValidator d2_tc_tc;
   extern const rpn::StrictTypeValidator d2_int_tc;
   extern const rpn::StrictTypeValidator d2_tc_int;
+  extern const rpn::StrictTypeValidator d2_array_frac;
 }
 #endif
 
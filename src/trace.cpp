@@ -0,0 +1,340 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/trace.cpp
+ *
+ * @file    trace.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+static_assert(sizeof(rpn::TraceEvent) == 32, "TraceEvent is written as is");
+
+namespace {
+  /*
+   * a slot is 0 while its thread writes it, then which it is (the head it
+   * went in at, plus one) and whether it's text following an event.  a
+   * reader copies a slot between two looks at that, and drops it unless
+   * both are the one it wanted
+   */
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> data[4];
+  };
+  static_assert(sizeof(rpn::TraceEvent) == sizeof(uint64_t[4]), "a TraceEvent is a slot");
+
+  struct Ring {
+    std::atomic<uint64_t> head{0}; // the next slot
+    Slot slots[rpn::Tracer::k_ringSize];
+
+    void put(uint64_t h, const void *bytes, size_t n, bool text) {
+      uint64_t words[4] = {};
+      std::memcpy(words, bytes, n);
+      Slot &sl = slots[h & (rpn::Tracer::k_ringSize-1)];
+      sl.seq.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for(size_t i=0; i<4; i++) {
+	sl.data[i].store(words[i], std::memory_order_relaxed);
+      }
+      sl.seq.store(((h+1) << 1) | (text ? 1 : 0), std::memory_order_release);
+    }
+    bool get(uint64_t h, void *bytes, bool text) const {
+      uint64_t words[4];
+      const Slot &sl = slots[h & (rpn::Tracer::k_ringSize-1)];
+      uint64_t seq = sl.seq.load(std::memory_order_acquire);
+      for(size_t i=0; i<4; i++) {
+	words[i] = sl.data[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq != (((h+1) << 1) | (text ? 1 : 0)) || sl.seq.load(std::memory_order_relaxed) != seq) {
+	return false;
+      }
+      std::memcpy(bytes, words, sizeof(words));
+      return true;
+    }
+  };
+
+  struct State {
+    std::mutex mx; // rings and words, never taken while recording a known word
+    std::vector<std::unique_ptr<Ring>> rings; // kept after their thread is gone, for dump()
+    std::vector<uint32_t> idle; // rings whose thread is gone, for the next one
+    std::vector<std::string> words;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::atomic<uint16_t> sessions{0};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+  };
+
+  State &state() {
+    static State *s = new State; // recorded into from threads that may outlive main()
+    return *s;
+  }
+
+  struct ThreadRing {
+    Ring *ring = nullptr;
+    uint32_t index = 0;
+    ~ThreadRing() {
+      if (ring != nullptr) {
+	State &s = state();
+	std::lock_guard lg(s.mx);
+	s.idle.push_back(index);
+      }
+    }
+  };
+
+  ThreadRing &thread_ring() {
+    thread_local ThreadRing tr;
+    if (tr.ring == nullptr) {
+      State &s = state();
+      std::lock_guard lg(s.mx);
+      if (s.idle.empty()) {
+	s.rings.push_back(std::make_unique<Ring>());
+	tr.index = uint32_t(s.rings.size()-1);
+      } else {
+	tr.index = s.idle.back(); // its events stay, under the same thread number
+	s.idle.pop_back();
+      }
+      tr.ring = s.rings[tr.index].get();
+    }
+    return tr;
+  }
+
+  const char *sk_kinds[] = { "start", "text", "word", "enter", "local", "define", "cut" };
+  const char *sk_results[] = { "ok", "parse_error", "dict_error", "param_error",
+			       "eval_error", "compile_error", "implementation_error" };
+}
+
+uint64_t
+rpn::Tracer::now() {
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - state().epoch).count());
+}
+
+uint32_t
+rpn::Tracer::word(const std::string &w) {
+  thread_local std::unordered_map<std::string, uint32_t> cache;
+  auto it = cache.find(w);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  State &s = state();
+  uint32_t rv;
+  {
+    std::lock_guard lg(s.mx);
+    auto [id, added] = s.ids.emplace(w, uint32_t(s.words.size()));
+    if (added) {
+      s.words.push_back(w);
+    }
+    rv = id->second;
+  }
+  cache.emplace(w, rv);
+  return rv;
+}
+
+uint16_t
+rpn::Tracer::session() {
+  return state().sessions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+rpn::Tracer::record(Kind kind, const std::string &w, bool known, uint8_t result,
+		    size_t depth, size_t rdepth, uint16_t session, uint64_t start) {
+  uint64_t elapsed = now() - start;
+  ThreadRing &tr = thread_ring();
+  TraceEvent ev;
+  ev.ns = start;
+  ev.elapsed = uint32_t(std::min<uint64_t>(elapsed, UINT32_MAX));
+  ev.word = known ? word(w) : k_inline | uint32_t(std::min<size_t>(w.size(), k_inline-1));
+  ev.depth = uint32_t(depth);
+  ev.rdepth = uint32_t(rdepth);
+  ev.session = session;
+  ev.kind = kind;
+  ev.result = result;
+  ev.thread = tr.index;
+  uint64_t h = tr.ring->head.load(std::memory_order_relaxed);
+  tr.ring->put(h++, &ev, sizeof(ev), false);
+  if (!known) {
+    size_t kept = std::min(w.size(), k_textMax);
+    for(size_t i=0; i<kept; i+=sizeof(TraceEvent)) {
+      tr.ring->put(h++, w.data()+i, std::min(kept-i, sizeof(TraceEvent)), true);
+    }
+  }
+  tr.ring->head.store(h, std::memory_order_release);
+}
+
+/*
+ * 'T', the word table, each event field by field, 'E'
+ */
+bool
+rpn::Tracer::dump(const std::string &path) {
+  State &s = state();
+  std::vector<TraceEvent> events;
+  std::vector<std::string> words; // only the ones these events use
+  std::unordered_map<std::string, uint32_t> ids;
+  auto id = [&](const std::string &w) {
+    auto [it, added] = ids.emplace(w, uint32_t(words.size()));
+    if (added) {
+      words.push_back(w);
+    }
+    return it->second;
+  };
+  {
+    std::lock_guard lg(s.mx); // the words' ids are all in s.words
+    for(const auto &r : s.rings) {
+      uint64_t head = r->head.load(std::memory_order_acquire);
+      uint64_t h = head > k_ringSize ? head - k_ringSize : 0;
+      while (h < head) {
+	TraceEvent ev;
+	if (!r->get(h++, &ev, false)) {
+	  continue; // overwritten, being written, or text whose event is gone
+	}
+	if ((ev.word & k_inline) == 0) {
+	  ev.word = id(s.words[ev.word]);
+	  events.push_back(ev);
+	  continue;
+	}
+	size_t length = ev.word & ~k_inline;
+	std::string text(std::min<size_t>(length, k_textMax), '\0');
+	bool whole = true;
+	for(size_t i=0; whole && i<text.size(); i+=sizeof(TraceEvent)) {
+	  char bytes[sizeof(TraceEvent)];
+	  whole = r->get(h++, bytes, true);
+	  std::memcpy(&text[i], bytes, std::min(text.size()-i, sizeof(TraceEvent)));
+	}
+	if (whole) {
+	  if (text.size() < length && ev.kind == ev_text) {
+	    ev.kind = ev_cut;
+	  }
+	  ev.word = id(text);
+	  events.push_back(ev);
+	}
+      }
+    }
+  }
+
+  rpn::ImageWriter w;
+  w.header();
+  w.u8('T');
+  w.u32(uint32_t(words.size()));
+  for(const auto &word : words) {
+    w.str(word);
+  }
+  w.u32(uint32_t(events.size()));
+  for(const auto &ev : events) {
+    w.i64(int64_t(ev.ns));
+    w.u32(ev.elapsed);
+    w.u32(ev.word);
+    w.u32(ev.depth);
+    w.u32(ev.rdepth);
+    w.u32(ev.session);
+    w.u8(ev.kind);
+    w.u8(ev.result);
+    w.u32(ev.thread);
+  }
+  w.u8('E');
+  return w.write(path);
+}
+
+bool
+rpn::Tracer::load(const std::string &path, Trace &out) {
+  rpn::ImageMap map(path);
+  if (!map.ok()) {
+    return false;
+  }
+  rpn::ImageReader r(map.data(), map.size());
+  try {
+    if (!r.header() || r.u8() != 'T') {
+      return false;
+    }
+    out.words.resize(r.u32());
+    for(auto &word : out.words) {
+      word = r.str();
+    }
+    out.events.resize(r.u32());
+    for(auto &ev : out.events) {
+      ev.ns = uint64_t(r.i64());
+      ev.elapsed = r.u32();
+      ev.word = r.u32();
+      ev.depth = r.u32();
+      ev.rdepth = r.u32();
+      ev.session = uint16_t(r.u32());
+      ev.kind = r.u8();
+      ev.result = r.u8();
+      ev.thread = r.u32();
+      if (ev.word >= out.words.size()) {
+	return false;
+      }
+    }
+    if (r.u8() != 'E' || !r.at_end()) {
+      return false;
+    }
+  } catch(const std::exception &) {
+    return false;
+  }
+  std::stable_sort(out.events.begin(), out.events.end(),
+		   [](const TraceEvent &a, const TraceEvent &b) { return a.ns < b.ns; });
+  return true;
+}
+
+void
+rpn::Tracer::decode(const Trace &t, FILE *out) {
+  for(const auto &ev : t.events) {
+    const char *kind = ev.kind < sizeof(sk_kinds)/sizeof(sk_kinds[0]) ? sk_kinds[ev.kind] : "?";
+    const char *result = ev.result < sizeof(sk_results)/sizeof(sk_results[0]) ? sk_results[ev.result] : "?";
+    fprintf(out, "%12.3f t%-2u s%-2u %-6s %*s%-20s %-12s [%u] %.3fus\n",
+	    double(ev.ns)/1e3, ev.thread, ev.session, kind, int(2*ev.rdepth), "",
+	    t.words[ev.word].c_str(), result, ev.depth, double(ev.elapsed)/1e3);
+  }
+}
+
+/*
+ * a replay starts from an empty stack, so depths are compared as offsets
+ * from where the stack was when TRACE turned on
+ */
+size_t
+rpn::Tracer::replay(const Trace &t, uint16_t session, Interp &rpn, FILE *out) {
+  size_t rv = 0;
+  int64_t offset = 0;
+  for(const auto &ev : t.events) {
+    if (ev.session != session) {
+      continue;
+    }
+    if (ev.kind == ev_start) {
+      offset = int64_t(ev.depth) - int64_t(rpn.stack.depth());
+    } else if (ev.kind == ev_cut) {
+      rv++;
+      if (out != nullptr) {
+	fprintf(out, "'%s...' was cut short, not replayed\n", t.words[ev.word].c_str());
+      }
+    } else if (ev.kind == ev_text) {
+      const std::string &text = t.words[ev.word];
+      auto result = uint8_t(rpn.sync_eval(text));
+      int64_t depth = int64_t(rpn.stack.depth()) + offset;
+      if (result != ev.result || depth != int64_t(ev.depth)) {
+	rv++;
+	if (out != nullptr) {
+	  fprintf(out, "'%s' was %s [%u], now %s [%lld]\n", text.c_str(),
+		  sk_results[std::min<size_t>(ev.result, 6)], ev.depth,
+		  sk_results[std::min<size_t>(result, 6)], (long long)depth);
+	}
+      }
+    }
+  }
+  return rv;
+}
+
+/* end of qinc/rpn-lang/src/trace.cpp */
@@ -0,0 +1,83 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/trace.h
+ *
+ * @file    trace.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace rpn {
+  class Interp;
+
+  struct TraceEvent {
+    uint64_t ns;      // when it started, since the tracer did
+    uint32_t elapsed; // ns, saturates
+    uint32_t word;    // Tracer::word(), or in a ring k_inline and the text's length
+    uint32_t depth;   // data stack, after
+    uint32_t rdepth;  // return stack
+    uint16_t session; // which Interp
+    uint8_t kind;     // Tracer::Kind
+    uint8_t result;   // WordDefinition::Result
+    uint32_t thread;  // which ring
+  };
+
+  /*
+   * TRACE <true> records each word an Interp evaluates as a TraceEvent in
+   * a ring per thread, the oldest are overwritten.  Only the thread that
+   * owns a ring writes it, so there are no locks on the way; a dump
+   * taken while other threads are tracing may miss their oldest events.
+   * Dictionary words are numbered once for good, anything else (a line,
+   * a literal, a local) is kept in the ring after its event, up to
+   * k_textMax bytes.  A ring goes to the next new thread when its own
+   * ends.  tools/rpn-trace decodes and replays a dump
+   */
+  class Tracer {
+  public:
+    enum Kind : uint8_t {
+      ev_start,  // TRACE turned on, depth is the stack a replay starts without
+      ev_text,   // a top level word, with any text it consumed (a replay runs these)
+      ev_word,   // a word evaluated by another word
+      ev_enter,  // a compiled local word
+      ev_local,  // a local variable pushed
+      ev_define, // a word added to the dictionary
+      ev_cut,    // an ev_text too long to keep, not replayed
+    };
+    static constexpr size_t k_ringSize = 16384; // slots per thread, an event and its text
+    static constexpr size_t k_textMax = 256;
+    static constexpr uint32_t k_inline = 0x80000000;
+
+    static uint64_t now();
+    static uint32_t word(const std::string &w);
+    static uint16_t session(); // a new one
+    // known is for a dictionary word, numbered by word() rather than kept as text
+    static void record(Kind kind, const std::string &word, bool known, uint8_t result,
+		       size_t depth, size_t rdepth, uint16_t session, uint64_t start);
+
+    // every ring, see Trace for reading it back
+    static bool dump(const std::string &path);
+
+    struct Trace {
+      std::vector<std::string> words;
+      std::vector<TraceEvent> events; // in time order
+    };
+    static bool load(const std::string &path, Trace &out);
+    static void decode(const Trace &t, FILE *out);
+    // a session's ev_text words evaluated again in rpn, the number that came out differently
+    static size_t replay(const Trace &t, uint16_t session, Interp &rpn, FILE *out);
+  };
+}
+
+/* end of qinc/rpn-lang/src/trace.h */
@@ -0,0 +1,115 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/trie.cpp
+ *
+ * @file    trie.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "trie.h"
+
+#include <algorithm>
+
+// where c's child is, or would go
+size_t
+q::Trie::slot(const Node &n, unsigned char c) {
+  auto ni = std::lower_bound(n.next.begin(), n.next.end(), c, [](const Child &e, unsigned char c) { return e.first < c; });
+  return size_t(ni - n.next.begin());
+}
+
+uint32_t &
+q::Trie::operator[](const std::string &word) {
+  Node *n = &_root;
+  for(unsigned char c : word) {
+    size_t at = slot(*n, c);
+    if (at == n->next.size() || n->next[at].first != c) {
+      n->next.emplace(n->next.begin() + at, c, std::make_unique<Node>());
+    }
+    n = n->next[at].second.get();
+  }
+  if (!n->word) {
+    n->word = true;
+    n->value = 0;
+    _size++;
+  }
+  return n->value;
+}
+
+const uint32_t *
+q::Trie::find(const std::string &word) const {
+  const Node *n = &_root;
+  for(unsigned char c : word) {
+    size_t at = slot(*n, c);
+    if (at == n->next.size() || n->next[at].first != c) {
+      return nullptr;
+    }
+    n = n->next[at].second.get();
+  }
+  return n->word ? &n->value : nullptr;
+}
+
+bool
+q::Trie::erase(const std::string &word) {
+  // the path down, so empty nodes can be pruned on the way back up
+  std::vector<std::pair<Node*,size_t>> path;
+  Node *n = &_root;
+  for(unsigned char c : word) {
+    size_t at = slot(*n, c);
+    if (at == n->next.size() || n->next[at].first != c) {
+      return false;
+    }
+    path.emplace_back(n, at);
+    n = n->next[at].second.get();
+  }
+  if (!n->word) {
+    return false;
+  }
+  n->word = false;
+  _size--;
+  for(auto pi = path.rbegin(); pi != path.rend(); pi++) {
+    Node *child = pi->first->next[pi->second].second.get();
+    if (child->word || !child->next.empty()) {
+      break;
+    }
+    pi->first->next.erase(pi->first->next.begin() + pi->second);
+  }
+  return true;
+}
+
+void
+q::Trie::visit(const std::string &prefix, const Visitor &fn) const {
+  const Node *n = &_root;
+  for(unsigned char c : prefix) {
+    size_t at = slot(*n, c);
+    if (at == n->next.size() || n->next[at].first != c) {
+      return;
+    }
+    n = n->next[at].second.get();
+  }
+  std::string path = prefix;
+  walk(*n, path, fn);
+}
+
+bool
+q::Trie::walk(const Node &n, std::string &path, const Visitor &fn) {
+  if (n.word && !fn(path, n.value)) {
+    return false;
+  }
+  for(const auto &e : n.next) {
+    path.push_back(char(e.first));
+    bool more = walk(*e.second, path, fn);
+    path.pop_back();
+    if (!more) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* end of qinc/rpn-lang/src/trie.cpp */
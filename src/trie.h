@@ -0,0 +1,57 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/trie.h
+ *
+ * @file    trie.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace q {
+  /*
+   * a prefix tree of words, each with a value.  children are kept in
+   * byte order so a walk comes out sorted the same as std::string's <
+   */
+  class Trie {
+  public:
+    // the word's value, zero (and inserted) if it's new
+    uint32_t &operator[](const std::string &word);
+    // nullptr if it isn't there
+    const uint32_t *find(const std::string &word) const;
+    bool erase(const std::string &word);
+    size_t size() const { return _size; }
+
+    // words starting with prefix, in order, until fn returns false
+    using Visitor = std::function<bool(const std::string &word, uint32_t value)>;
+    void visit(const std::string &prefix, const Visitor &fn) const;
+
+  private:
+    struct Node;
+    using Child = std::pair<unsigned char,std::unique_ptr<Node>>;
+    struct Node {
+      std::vector<Child> next;
+      uint32_t value = 0;
+      bool word = false;
+    };
+    static size_t slot(const Node &n, unsigned char c);
+    static bool walk(const Node &n, std::string &path, const Visitor &fn);
+    Node _root;
+    size_t _size = 0;
+  };
+}
+
+/* end of qinc/rpn-lang/src/trie.h */
@@ -15,51 +15,15 @@
 #include "../rpn.h"
 
 #include <cmath>
-
-/***************************************************
- * Integer
- */
-// to_integer
-NATIVE_WORD_DECL(types, to_int) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double dval = rpn.stack.pop_as_double();
-  int64_t ival = std::round(dval);
-  rpn.stack.push_integer(ival);
-  return rv;
-}
-
-
-/***************************************************
- * Float
- */
-NATIVE_WORD_DECL(types, to_float) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double dval = rpn.stack.pop_as_double();
-  rpn.stack.push_double(dval);
-  return rv;
-}
-
-/***************************************************
- * String
- */
-NATIVE_WORD_DECL(types, to_string) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto obj = rpn.stack.pop();
-  rpn.stack.push_string((std::string)*obj);
-  return rv;
-}
+#include <algorithm>
 
 /***************************************************
  * Object
  */
-NATIVE_WORD_DECL(t_object, to_object) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  std::string ident = rpn.stack.pop_string();
-  auto val = rpn.stack.pop();
+static StObject to_object(const rpn::Stack::Object &val, const std::string &ident) {
   StObject obj;
-  obj.add_value(ident,*val.get());
-  rpn.stack.push(obj);
-  return rv;
+  obj.add_value(ident,val);
+  return obj;
 }
 
 NATIVE_WORD_DECL(t_object, object_to) {
@@ -87,34 +51,116 @@ NATIVE_WORD_DECL(t_object, add_object_string_any) {
  */
 NATIVE_WORD_DECL(t_array, to_array) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  size_t n = size_t(rpn.stack.pop_integer());
-  rpn.stack.reversen(n);
-  StArray array;
-  for(size_t i=0; i<n; i++) {
-    array.add_value(*rpn.stack.pop());
+  int64_t n = PEEK_CAST(const StInteger,rpn.stack.peek_const(1));
+  if (n < 0 || size_t(n) >= rpn.stack.depth()) {
+    return rpn::WordDefinition::Result::param_error; // popn() would come back empty
   }
-  rpn.stack.push(array);
+  rpn.stack.pop();
+  // the values move straight into the array, nothing is copied
+  rpn.stack.push(std::make_unique<StArray>(rpn.stack.popn(size_t(n))));
   return rv;
 }
 
 NATIVE_WORD_DECL(t_array, array_to) {
   rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
   auto sob = rpn.stack.pop();
-  const auto &v = PEEK_CAST(StArray,*sob).val();
-  for(auto ri = v.rbegin(); ri != v.rend(); ri++) {
-    rpn.stack.push(**ri);
-  }
-  rpn.stack.push_integer(v.size());
+  auto v = PEEK_CAST(StArray,*sob).release();
+  size_t n = v.size();
+  std::reverse(v.begin(), v.end()); // element 0 ends up nearest the top
+  rpn.stack.pushn(std::move(v));
+  rpn.stack.push_integer(int64_t(n));
   return rv;
 }
 
+/*
+ * the indexed words change the array where it sits on the stack; it's
+ * only copied when another stack level still shares it.  indices are
+ * zero based, a bad index leaves the stack alone.
+ *
+ *   APPEND ( arr x -- arr' )     INSERT ( arr x i -- arr' )
+ *   GET    ( arr i -- arr x )    PUT    ( arr i x -- arr' )
+ *   SLICE  ( arr b e -- arr' )   CONCAT ( arr1 arr2 -- arr' )
+ *   LENGTH ( arr -- arr n )      SLICE keeps [b,e)
+ */
 NATIVE_WORD_DECL(t_array, add_array_any) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::implementation_error;
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto arr = rpn.stack.pop();
+  PEEK_CAST(StArray,*arr).insert_value(0, rpn.stack.pop());
+  rpn.stack.push(std::move(arr));
   return rv;
 }
 
 NATIVE_WORD_DECL(t_array, add_any_array) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::implementation_error;
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto val = rpn.stack.pop();
+  StArray &arr = PEEK_CAST(StArray,rpn.stack.peek(1));
+  arr.add_value(std::move(val));
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, insert) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::param_error;
+  int64_t at = rpn.stack.peek_integer(1);
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(3));
+  if (at >= 0 && size_t(at) <= arr.size()) {
+    rpn.stack.drop();
+    auto val = rpn.stack.pop();
+    PEEK_CAST(StArray,rpn.stack.peek(1)).insert_value(size_t(at), std::move(val));
+    rv = rpn::WordDefinition::Result::ok;
+  }
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, get) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::param_error;
+  int64_t at = rpn.stack.peek_integer(1);
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(2));
+  if (at >= 0 && size_t(at) < arr.size()) {
+    rpn.stack.drop();
+    rpn.stack.push(arr.value(size_t(at)));
+    rv = rpn::WordDefinition::Result::ok;
+  }
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, put) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::param_error;
+  int64_t at = rpn.stack.peek_integer(2);
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(3));
+  if (at >= 0 && size_t(at) < arr.size()) {
+    auto val = rpn.stack.pop();
+    rpn.stack.drop();
+    PEEK_CAST(StArray,rpn.stack.peek(1)).put_value(size_t(at), std::move(val));
+    rv = rpn::WordDefinition::Result::ok;
+  }
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, slice) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::param_error;
+  int64_t e = rpn.stack.peek_integer(1);
+  int64_t b = rpn.stack.peek_integer(2);
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(3));
+  if (b >= 0 && b <= e && size_t(e) <= arr.size()) {
+    rpn.stack.dropn(2);
+    PEEK_CAST(StArray,rpn.stack.peek(1)).slice(size_t(b), size_t(e));
+    rv = rpn::WordDefinition::Result::ok;
+  }
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, concat) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto tail = rpn.stack.pop();
+  StArray &arr = PEEK_CAST(StArray,rpn.stack.peek(1));
+  arr.append(std::move(PEEK_CAST(StArray,*tail)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(t_array, length) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  rpn.stack.push_integer(int64_t(arr.size()));
   return rv;
 }
 
@@ -165,10 +211,10 @@ static double nan_sub_0(double a, double b) {
     rv = a - b;
     break;
   case 1:
-    rv = -b;
+    rv = a;
     break;
   case 2:
-    rv = a;
+    rv = -b;
     break;
   case 3:
     // rv is already nan
@@ -192,110 +238,40 @@ static double nan_sub(double a, double b) {
   return rv;
 }
 
-// vec3+number
-NATIVE_WORD_DECL(vec3, add_vec3) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto o1 = rpn.stack.pop();
-  auto o2 = rpn.stack.pop();
-  const auto &v1 = POP_CAST(StVec3,o1);
-  const auto &v2 = POP_CAST(StVec3,o2);
-  rpn.stack.push(StVec3(nan_add_0(v1._x, v2._x), nan_add_0(v1._y, v2._y), nan_add_0(v1._z, v2._z)));
-  return rv;
-}
-
-// number+vec3
-NATIVE_WORD_DECL(vec3, add_num_vec3) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double n1 = rpn.stack.pop_as_double();
-  auto o2 = rpn.stack.pop();
-  const auto &v2 = POP_CAST(StVec3,o2);
-  rpn.stack.push(StVec3(nan_add(n1, v2._x), nan_add(n1, v2._y), nan_add(n1, v2._z)));
-  return rv;
-}
-
 // add two vec3's
-NATIVE_WORD_DECL(vec3, add_vec3_num) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto o1 = rpn.stack.pop();
-  double n2 = rpn.stack.pop_as_double();
-  const auto &v1 = POP_CAST(StVec3,o1);
-  rpn.stack.push(StVec3(nan_add(v1._x, n2), nan_add(v1._y, n2), nan_add(v1._z, n2)));
-  return rv;
+static StVec3 add_vec3(const StVec3 &v2, const StVec3 &v1) {
+  return StVec3(nan_add_0(v1._x, v2._x), nan_add_0(v1._y, v2._y), nan_add_0(v1._z, v2._z));
 }
 
-NATIVE_WORD_DECL(vec3, sub_vec3) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto o2 = rpn.stack.pop();
-  auto o1 = rpn.stack.pop();
-  const auto &v1 = POP_CAST(StVec3,o1);
-  const auto &v2 = POP_CAST(StVec3,o2);
-  rpn.stack.push(StVec3(nan_sub_0(v1._x, v2._x), nan_sub_0(v1._y, v2._y), nan_sub_0(v1._z, v2._z)));
-  return rv;
+// vec3+number
+static StVec3 add_vec3_num(const StVec3 &v2, double n1) {
+  return StVec3(nan_add(n1, v2._x), nan_add(n1, v2._y), nan_add(n1, v2._z));
 }
 
 // number+vec3
-NATIVE_WORD_DECL(vec3, sub_num_vec3) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double n1 = rpn.stack.pop_as_double();
-  auto o2 = rpn.stack.pop();
-  const auto &v2 = POP_CAST(StVec3,o2);
-  rpn.stack.push(StVec3(nan_sub(n1, v2._x), nan_sub(n1, v2._y), nan_sub(n1, v2._z)));
-  return rv;
+static StVec3 add_num_vec3(double n2, const StVec3 &v1) {
+  return StVec3(nan_add(v1._x, n2), nan_add(v1._y, n2), nan_add(v1._z, n2));
 }
 
-// add two vec3's
-NATIVE_WORD_DECL(vec3, sub_vec3_num) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto o1 = rpn.stack.pop();
-  double n2 = rpn.stack.pop_as_double();
-  const auto &v1 = POP_CAST(StVec3,o1);
-  rpn.stack.push(StVec3(nan_sub(v1._x, n2), nan_sub(v1._y, n2), nan_sub(v1._z, n2)));
-  return rv;
+static StVec3 sub_vec3(const StVec3 &v1, const StVec3 &v2) {
+  return StVec3(nan_sub_0(v1._x, v2._x), nan_sub_0(v1._y, v2._y), nan_sub_0(v1._z, v2._z));
 }
 
-// 3 numbers to a vec3
-NATIVE_WORD_DECL(vec3, to_vec3) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double z = rpn.stack.pop_as_double();
-  double y = rpn.stack.pop_as_double();
-  double x = rpn.stack.pop_as_double();
-  rpn.stack.push(StVec3(x,y,z));
-  return rv;
+// vec3-number
+static StVec3 sub_vec3_num(const StVec3 &v2, double n1) {
+  return StVec3(nan_sub(v2._x, n1), nan_sub(v2._y, n1), nan_sub(v2._z, n1));
+}
+
+// number-vec3
+static StVec3 sub_num_vec3(double n2, const StVec3 &v1) {
+  return StVec3(nan_sub(n2, v1._x), nan_sub(n2, v1._y), nan_sub(n2, v1._z));
 }
 
 // vec3 to 3 doubles
-NATIVE_WORD_DECL(vec3, vec3_to) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  auto o1 = rpn.stack.pop();
-  const auto &v1 = POP_CAST(StVec3,o1);
+static void vec3_to(rpn::Interp &rpn, const StVec3 &v1) {
   rpn.stack.push_double(v1._x);
   rpn.stack.push_double(v1._y);
   rpn.stack.push_double(v1._z);
-  return rv;
-}
-
-//  number to x-value in Vec3
-NATIVE_WORD_DECL(vec3, to_vec3x) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double n1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StVec3(n1,std::nan(""),std::nan("")));
-  return rv;
-}
-
-//  number to y-value in Vec3
-NATIVE_WORD_DECL(vec3, to_vec3y) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double n1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StVec3(std::nan(""),n1,std::nan("")));
-  return rv;
-}
-
-//  number to z-value in Vec3
-NATIVE_WORD_DECL(vec3, to_vec3z) {
-  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
-  double n1 = rpn.stack.pop_as_double();
-  rpn.stack.push(StVec3(std::nan(""),std::nan(""),n1));
-  return rv;
 }
 
 NATIVE_WORD_DECL(t_array, reverse) {
@@ -308,46 +284,45 @@ NATIVE_WORD_DECL(t_array, reverse) {
 
 void
 rpn::Interp::addTypeWords() {
-  addDefinition("->INT", NATIVE_WORD_WDEF(types, rpn::StrictTypeValidator::d1_double, to_int, nullptr));
-  addDefinition("->FLOAT", NATIVE_WORD_WDEF(types, rpn::StrictTypeValidator::d1_integer, to_float, nullptr));
-  addDefinition("->STRING", NATIVE_WORD_WDEF(types, rpn::StackSizeValidator::one, to_string, nullptr));
+  def<int64_t(const StDouble&)>("->INT", [](const StDouble &d) { return int64_t(std::round(d.val())); });
+  def<double(int64_t)>("->FLOAT", [](int64_t i) { return double(i); });
+  def<std::string(const rpn::Stack::Object&)>("->STRING", [](const rpn::Stack::Object &o) { return std::string(o); });
 
-  addDefinition("->OBJ", NATIVE_WORD_WDEF(t_object, rpn::StrictTypeValidator::d2_string_any, to_object, nullptr));
+  def<StObject(const rpn::Stack::Object&,const std::string&)>("->OBJ", to_object);
   addDefinition("OBJ->", NATIVE_WORD_WDEF(t_object, rpn::StrictTypeValidator::d1_object, object_to, nullptr));
   addDefinition("->ARRAY", NATIVE_WORD_WDEF(t_array, rpn::StackSizeValidator::ntos, to_array, nullptr));
   addDefinition("OBJ->", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d1_array, array_to, nullptr));
 
   addDefinition("ARREV", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d1_array, reverse, nullptr));
+  addDefinition("APPEND", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_any_array, add_any_array, nullptr));
+  addDefinition("INSERT", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d3_integer_any_array, insert, nullptr));
+  addDefinition("GET", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_integer_array, get, nullptr));
+  addDefinition("PUT", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d3_any_integer_array, put, nullptr));
+  addDefinition("SLICE", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d3_integer_integer_array, slice, nullptr));
+  addDefinition("CONCAT", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_array_array, concat, nullptr));
+  addDefinition("LENGTH", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d1_array, length, nullptr));
 
   addDefinition("+", NATIVE_WORD_WDEF(t_object, rpn::StrictTypeValidator::d3_object_string_any, add_object_string_any, nullptr));
   addDefinition("+", NATIVE_WORD_WDEF(t_object, rpn::StrictTypeValidator::d3_string_any_object, add_string_any_object, nullptr));
+  addDefinition("+", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_array_array, concat, nullptr));
   addDefinition("+", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_array_any, add_array_any, nullptr));
   addDefinition("+", NATIVE_WORD_WDEF(t_array, rpn::StrictTypeValidator::d2_any_array, add_any_array, nullptr));
 
-  addDefinition("+", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_vec3, add_vec3, nullptr));
-  addDefinition("+", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_double, add_vec3_num, nullptr));
-  addDefinition("+", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_integer, add_vec3_num, nullptr));
-  addDefinition("+", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_double_vec3, add_num_vec3, nullptr));
-  addDefinition("+", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_integer_vec3, add_num_vec3, nullptr));
-
-  addDefinition("-", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_vec3, sub_vec3, nullptr));
-  addDefinition("-", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_double, sub_vec3_num, nullptr));
-  addDefinition("-", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_vec3_integer, sub_vec3_num, nullptr));
-  addDefinition("-", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_double_vec3, sub_num_vec3, nullptr));
-  addDefinition("-", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d2_integer_vec3, sub_num_vec3, nullptr));
-
-  ADD_NATIVE_3_NUMBER_WDEF(vec3, (*this), "->VEC3", to_vec3, to_vec3, nullptr);
-  addDefinition("->VEC3x", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_double, to_vec3x, nullptr));
-  addDefinition("->VEC3x", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_integer, to_vec3x, nullptr));
+  def<StVec3(const StVec3&,const StVec3&)>("+", add_vec3);
+  def<StVec3(const StVec3&,double)>("+", add_vec3_num);
+  def<StVec3(double,const StVec3&)>("+", add_num_vec3);
 
-  addDefinition("->VEC3y", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_double, to_vec3y, nullptr));
-  addDefinition("->VEC3y", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_integer, to_vec3y, nullptr));
+  def<StVec3(const StVec3&,const StVec3&)>("-", sub_vec3);
+  def<StVec3(const StVec3&,double)>("-", sub_vec3_num);
+  def<StVec3(double,const StVec3&)>("-", sub_num_vec3);
 
-  addDefinition("->VEC3z", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_double, to_vec3z, nullptr));
-  addDefinition("->VEC3z", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_integer, to_vec3z, nullptr));
+  def<StVec3(double,double,double)>("->VEC3", [](double x, double y, double z) { return StVec3(x,y,z); });
+  def<StVec3(double)>("->VEC3x", [](double x) { return StVec3(x,std::nan(""),std::nan("")); });
+  def<StVec3(double)>("->VEC3y", [](double y) { return StVec3(std::nan(""),y,std::nan("")); });
+  def<StVec3(double)>("->VEC3z", [](double z) { return StVec3(std::nan(""),std::nan(""),z); });
 
-  addDefinition("VEC3->", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_vec3, vec3_to, nullptr));
-  addDefinition("OBJ->", NATIVE_WORD_WDEF(vec3, rpn::StrictTypeValidator::d1_vec3, vec3_to, nullptr));
+  def<void(rpn::Interp&,const StVec3&)>("VEC3->", vec3_to);
+  def<void(rpn::Interp&,const StVec3&)>("OBJ->", vec3_to);
 
   //  std:: string line = ": VEC3->{xy} ( <v3> <v3'> ) VEC3-> DROP ->{y} SWAP ->{x} + ;";
   //  line = ": VEC3->{xy} ( <v3> -- <v3'> ) VEC3-> DROP ->{y} SWAP ->{x} + ;";
@@ -0,0 +1,338 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/vec3-dict.cpp
+ *
+ * @file    vec3-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "../rpn.h"
+#include "vec3.h"
+
+using StVec3Array = stack::Vec3Array;
+
+/*
+ * the words take a Vec3 array or a single Vec3 on either side; a single
+ * Vec3 is a Vec3s of one.  an array is only the result when one went in.
+ */
+static const q::Vec3s &
+operand(const rpn::Stack::Object &o, q::Vec3s &single) {
+  if (o.tag() == rpn::type_tag<StVec3Array>()) {
+    return static_cast<const StVec3Array&>(o).val();
+  }
+  const auto &v = static_cast<const StVec3&>(o);
+  single = q::Vec3s(v._x, v._y, v._z);
+  return single;
+}
+
+static void
+push_vec3s(rpn::Interp &rpn, q::Vec3s &&v, bool array) {
+  if (array) {
+    rpn.stack.push(std::make_unique<StVec3Array>(std::move(v)));
+  } else {
+    rpn.stack.push(StVec3(v.x[0], v.y[0], v.z[0]));
+  }
+}
+
+static void
+push_doubles(rpn::Interp &rpn, const std::vector<double> &v, bool array) {
+  if (array) {
+    StArray::Elements rv;
+    rv.reserve(v.size());
+    for(auto const &d : v) {
+      rv.push_back(std::make_unique<StDouble>(d));
+    }
+    rpn.stack.push(std::make_unique<StArray>(std::move(rv)));
+  } else {
+    rpn.stack.push_double(v[0]);
+  }
+}
+
+/*
+ * a transform is 16 numbers, or 12 without the bottom row, row-major; or
+ * the same as 3 or 4 arrays of 4
+ */
+static bool
+is_number(const rpn::Stack::Object &o) {
+  return o.tag() == rpn::tt_double || o.tag() == rpn::tt_integer;
+}
+
+static bool
+affine(const StArray &a, double m[16]) {
+  if (a.size() == 12 || a.size() == 16) {
+    for(size_t i=0; i<a.size(); i++) {
+      if (!is_number(a.value(i))) {
+	return false;
+      }
+      m[i] = double(a.value(i));
+    }
+    return true;
+  }
+  if (a.size() == 3 || a.size() == 4) {
+    for(size_t r=0; r<a.size(); r++) {
+      if (a.value(r).tag() != rpn::tt_array) {
+	return false;
+      }
+      const auto &row = static_cast<const StArray&>(a.value(r));
+      if (row.size() != 4) {
+	return false;
+      }
+      for(size_t c=0; c<4; c++) {
+	if (!is_number(row.value(c))) {
+	  return false;
+	}
+	m[r*4+c] = double(row.value(c));
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// ( [vec3s] -- v3array )
+NATIVE_WORD_DECL(vec3a, to_v3a) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &arr = PEEK_CAST(const StArray,rpn.stack.peek_const(1));
+  q::Vec3s v(arr.size());
+  for(size_t i=0; i<arr.size(); i++) {
+    if (arr.value(i).tag() != rpn::tt_vec3) {
+      return rpn::WordDefinition::Result::param_error;
+    }
+    const auto &e = static_cast<const StVec3&>(arr.value(i));
+    v.x[i] = e._x;
+    v.y[i] = e._y;
+    v.z[i] = e._z;
+  }
+  rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StVec3Array>(std::move(v)));
+  return rv;
+}
+
+// ( v3array -- [vec3s] )
+NATIVE_WORD_DECL(vec3a, v3a_to) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ova = rpn.stack.pop();
+  const auto &v = POP_CAST(StVec3Array,ova).val();
+  StArray::Elements vs;
+  vs.reserve(v.size());
+  for(size_t i=0; i<v.size(); i++) {
+    vs.push_back(std::make_unique<StVec3>(v.x[i], v.y[i], v.z[i]));
+  }
+  rpn.stack.push(std::make_unique<StArray>(std::move(vs)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(vec3a, length) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  const auto &va = PEEK_CAST(const StVec3Array,rpn.stack.peek_const(1));
+  rpn.stack.push_integer(int64_t(va.size()));
+  return rv;
+}
+
+/*
+ * two vector operands, level 2 on the left
+ */
+template<typename Fn>
+static rpn::WordDefinition::Result
+vector_vector(rpn::Interp &rpn, Fn fn) {
+  const auto &l = rpn.stack.peek_const(2);
+  const auto &r = rpn.stack.peek_const(1);
+  bool array = l.tag() == rpn::type_tag<StVec3Array>() || r.tag() == rpn::type_tag<StVec3Array>();
+  q::Vec3s ls, rs;
+  const q::Vec3s &a = operand(l, ls);
+  const q::Vec3s &b = operand(r, rs);
+  if (!q::conformable(a, b)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  auto result = fn(a, b);
+  rpn.stack.pop();
+  rpn.stack.pop();
+  if constexpr (std::is_same_v<decltype(result), q::Vec3s>) {
+    push_vec3s(rpn, std::move(result), array);
+  } else {
+    push_doubles(rpn, result, array);
+  }
+  return rpn::WordDefinition::Result::ok;
+}
+
+NATIVE_WORD_DECL(vec3a, add) {
+  return vector_vector(rpn, [](const q::Vec3s &a, const q::Vec3s &b) { return q::add(a, b); });
+}
+
+NATIVE_WORD_DECL(vec3a, sub) {
+  return vector_vector(rpn, [](const q::Vec3s &a, const q::Vec3s &b) { return q::subtract(a, b); });
+}
+
+NATIVE_WORD_DECL(vec3a, dot) {
+  return vector_vector(rpn, [](const q::Vec3s &a, const q::Vec3s &b) { return q::dot(a, b); });
+}
+
+NATIVE_WORD_DECL(vec3a, cross) {
+  return vector_vector(rpn, [](const q::Vec3s &a, const q::Vec3s &b) { return q::cross(a, b); });
+}
+
+/*
+ * a vector operand and a number, either way around
+ */
+NATIVE_WORD_DECL(vec3a, add_vn) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  double n = rpn.stack.pop_as_double();
+  auto ova = rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StVec3Array>(q::add(POP_CAST(StVec3Array,ova).val(), n)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(vec3a, add_nv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ova = rpn.stack.pop();
+  double n = rpn.stack.pop_as_double();
+  rpn.stack.push(std::make_unique<StVec3Array>(q::add(POP_CAST(StVec3Array,ova).val(), n)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(vec3a, sub_vn) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  double n = rpn.stack.pop_as_double();
+  auto ova = rpn.stack.pop();
+  rpn.stack.push(std::make_unique<StVec3Array>(q::subtract(POP_CAST(StVec3Array,ova).val(), n)));
+  return rv;
+}
+
+NATIVE_WORD_DECL(vec3a, sub_nv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ova = rpn.stack.pop();
+  double n = rpn.stack.pop_as_double();
+  rpn.stack.push(std::make_unique<StVec3Array>(q::subtract(n, POP_CAST(StVec3Array,ova).val())));
+  return rv;
+}
+
+// ( v n -- v*n ) for a Vec3 or a Vec3 array
+NATIVE_WORD_DECL(vec3a, scale_vn) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  double n = rpn.stack.pop_as_double();
+  auto ov = rpn.stack.pop();
+  q::Vec3s single;
+  bool array = ov->tag() == rpn::type_tag<StVec3Array>();
+  push_vec3s(rpn, q::scale(operand(*ov, single), n), array);
+  return rv;
+}
+
+// ( n v -- n*v )
+NATIVE_WORD_DECL(vec3a, scale_nv) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ov = rpn.stack.pop();
+  double n = rpn.stack.pop_as_double();
+  q::Vec3s single;
+  bool array = ov->tag() == rpn::type_tag<StVec3Array>();
+  push_vec3s(rpn, q::scale(operand(*ov, single), n), array);
+  return rv;
+}
+
+// ( v -- |v| )
+NATIVE_WORD_DECL(vec3a, norm) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ov = rpn.stack.pop();
+  q::Vec3s single;
+  bool array = ov->tag() == rpn::type_tag<StVec3Array>();
+  push_doubles(rpn, q::norm(operand(*ov, single)), array);
+  return rv;
+}
+
+// ( v -- v/|v| )
+NATIVE_WORD_DECL(vec3a, normalize) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  auto ov = rpn.stack.pop();
+  q::Vec3s single;
+  bool array = ov->tag() == rpn::type_tag<StVec3Array>();
+  push_vec3s(rpn, q::normalize(operand(*ov, single)), array);
+  return rv;
+}
+
+// ( v [m] -- v' )
+NATIVE_WORD_DECL(vec3a, transform) {
+  rpn::WordDefinition::Result rv = rpn::WordDefinition::Result::ok;
+  double m[16];
+  if (!affine(PEEK_CAST(const StArray,rpn.stack.peek_const(1)), m)) {
+    return rpn::WordDefinition::Result::param_error;
+  }
+  rpn.stack.pop();
+  auto ov = rpn.stack.pop();
+  q::Vec3s single;
+  bool array = ov->tag() == rpn::type_tag<StVec3Array>();
+  push_vec3s(rpn, q::transform(operand(*ov, single), m), array);
+  return rv;
+}
+
+void
+rpn::Interp::addVec3Words() {
+  rpn::Interp &rpn = *this; // in case we want to move this out someday
+  rpn.addDefinition("->VEC3ARRAY", NATIVE_WORD_WDEF(vec3a, rpn::StrictTypeValidator::d1_array, to_v3a, nullptr));
+  rpn.addDefinition("VEC3ARRAY->", NATIVE_WORD_WDEF(vec3a, vec3_validator::d1_v3a, v3a_to, nullptr));
+  rpn.addDefinition("OBJ->", NATIVE_WORD_WDEF(vec3a, vec3_validator::d1_v3a, v3a_to, nullptr));
+  rpn.addDefinition("LENGTH", NATIVE_WORD_WDEF(vec3a, vec3_validator::d1_v3a, length, nullptr));
+
+  for(auto v : { &vec3_validator::d2_v3a_v3a, &vec3_validator::d2_v3a_vec3, &vec3_validator::d2_vec3_v3a }) {
+    rpn.addDefinition("+", NATIVE_WORD_WDEF(vec3a, *v, add, nullptr));
+    rpn.addDefinition("-", NATIVE_WORD_WDEF(vec3a, *v, sub, nullptr));
+  }
+  for(auto v : { &vec3_validator::d2_v3a_v3a, &vec3_validator::d2_v3a_vec3, &vec3_validator::d2_vec3_v3a, &rpn::StrictTypeValidator::d2_vec3_vec3 }) {
+    rpn.addDefinition("DOT", NATIVE_WORD_WDEF(vec3a, *v, dot, nullptr));
+    rpn.addDefinition("CROSS", NATIVE_WORD_WDEF(vec3a, *v, cross, nullptr));
+  }
+
+  rpn.addDefinition("+", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_double_v3a, add_vn, nullptr));
+  rpn.addDefinition("+", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_integer_v3a, add_vn, nullptr));
+  rpn.addDefinition("+", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_double, add_nv, nullptr));
+  rpn.addDefinition("+", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_integer, add_nv, nullptr));
+  rpn.addDefinition("-", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_double_v3a, sub_vn, nullptr));
+  rpn.addDefinition("-", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_integer_v3a, sub_vn, nullptr));
+  rpn.addDefinition("-", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_double, sub_nv, nullptr));
+  rpn.addDefinition("-", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_integer, sub_nv, nullptr));
+
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_double_v3a, scale_vn, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_integer_v3a, scale_vn, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_double, scale_nv, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_v3a_integer, scale_nv, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, rpn::StrictTypeValidator::d2_double_vec3, scale_vn, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, rpn::StrictTypeValidator::d2_integer_vec3, scale_vn, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, rpn::StrictTypeValidator::d2_vec3_double, scale_nv, nullptr));
+  rpn.addDefinition("*", NATIVE_WORD_WDEF(vec3a, rpn::StrictTypeValidator::d2_vec3_integer, scale_nv, nullptr));
+
+  for(auto v : { &vec3_validator::d1_v3a, &rpn::StrictTypeValidator::d1_vec3 }) {
+    rpn.addDefinition("NORM", NATIVE_WORD_WDEF(vec3a, *v, norm, nullptr));
+    rpn.addDefinition("NORMALIZE", NATIVE_WORD_WDEF(vec3a, *v, normalize, nullptr));
+  }
+  rpn.addDefinition("TRANSFORM", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_array_v3a, transform, nullptr));
+  rpn.addDefinition("TRANSFORM", NATIVE_WORD_WDEF(vec3a, vec3_validator::d2_array_vec3, transform, nullptr));
+}
+
+static const rpn::TypeTag sk_v3aTag = rpn::TypeRegistry::add<StVec3Array>("Vec3Array");
+
+const rpn::StrictTypeValidator vec3_validator::d1_v3a({rpn::type_tag<StVec3Array>()}, "d1_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_v3a_v3a({rpn::type_tag<StVec3Array>(),rpn::type_tag<StVec3Array>()}, "d2_v3a_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_v3a_vec3({rpn::type_tag<StVec3Array>(),rpn::type_tag<StVec3>()}, "d2_v3a_vec3");
+const rpn::StrictTypeValidator vec3_validator::d2_vec3_v3a({rpn::type_tag<StVec3>(),rpn::type_tag<StVec3Array>()}, "d2_vec3_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_v3a_double({rpn::type_tag<StVec3Array>(),rpn::type_tag<StDouble>()}, "d2_v3a_double");
+const rpn::StrictTypeValidator vec3_validator::d2_double_v3a({rpn::type_tag<StDouble>(),rpn::type_tag<StVec3Array>()}, "d2_double_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_v3a_integer({rpn::type_tag<StVec3Array>(),rpn::type_tag<StInteger>()}, "d2_v3a_integer");
+const rpn::StrictTypeValidator vec3_validator::d2_integer_v3a({rpn::type_tag<StInteger>(),rpn::type_tag<StVec3Array>()}, "d2_integer_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_array_v3a({rpn::type_tag<StArray>(),rpn::type_tag<StVec3Array>()}, "d2_array_v3a");
+const rpn::StrictTypeValidator vec3_validator::d2_array_vec3({rpn::type_tag<StArray>(),rpn::type_tag<StVec3>()}, "d2_array_vec3");
+
+static const bool sk_vec3ArrayImage = rpn::ImageReader::addType("Vec3Array", [](rpn::ImageReader &r) {
+    q::Vec3s v(r.u32());
+    for(size_t i=0; i<v.size(); i++) {
+      v.x[i] = r.f64();
+      v.y[i] = r.f64();
+      v.z[i] = r.f64();
+    }
+    return std::make_unique<StVec3Array>(std::move(v));
+  });
+
+/* end of qinc/rpn-lang/src/vec3-dict.cpp */
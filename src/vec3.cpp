@@ -0,0 +1,229 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/vec3.cpp
+ *
+ * @file    vec3.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "vec3.h"
+#include "simd.h"
+
+#include <limits>
+#include <algorithm>
+
+/*
+ * the vectorizer gives up on nested selects, so the NaN
+ * handling is done with the single-select helpers below and arithmetic.
+ * a single vector operand is a stride of 0, which gets its own
+ * instantiation.
+ */
+
+static const double sk_nan = std::numeric_limits<double>::quiet_NaN();
+
+// a missing component as 0
+static inline double present(double v) { return std::isnan(v) ? 0. : v; }
+// 1 for a component that's there
+static inline double there(double v) { return std::isnan(v) ? 0. : 1.; }
+// NaN to add in when nothing was there
+static inline double none(double count) { return (count == 0.) ? sk_nan : 0.; }
+// NaN to add in when v is missing
+static inline double absent(double v) { return std::isnan(v) ? v : 0.; }
+
+template<bool BA, bool BB, typename Op>
+static void
+zip(size_t n, const double *RESTRICT a, const double *RESTRICT b, double *RESTRICT out, Op op) {
+  for(size_t i=0; i<n; i++) {
+    out[i] = op(a[BA ? 0 : i], b[BB ? 0 : i]);
+  }
+}
+
+template<typename Op>
+static void
+zip(size_t n, bool ba, bool bb, const double *a, const double *b, double *out, Op op) {
+  if (ba) {
+    zip<true,false>(n, a, b, out, op);
+  } else if (bb) {
+    zip<false,true>(n, a, b, out, op);
+  } else {
+    zip<false,false>(n, a, b, out, op);
+  }
+}
+
+template<typename Op>
+static void
+map(size_t n, const double *RESTRICT a, double *RESTRICT out, Op op) {
+  for(size_t i=0; i<n; i++) {
+    out[i] = op(a[i]);
+  }
+}
+
+// a single vector only broadcasts against something bigger
+static size_t
+result_size(const q::Vec3s &a, const q::Vec3s &b, bool &ba, bool &bb) {
+  size_t n = std::max(a.size(), b.size());
+  ba = a.size() == 1 && n > 1;
+  bb = b.size() == 1 && n > 1;
+  return n;
+}
+
+template<typename Op>
+static q::Vec3s
+componentwise(const q::Vec3s &a, const q::Vec3s &b, Op op) {
+  bool ba, bb;
+  q::Vec3s rv(result_size(a, b, ba, bb));
+  zip(rv.size(), ba, bb, a.x.data(), b.x.data(), rv.x.data(), op);
+  zip(rv.size(), ba, bb, a.y.data(), b.y.data(), rv.y.data(), op);
+  zip(rv.size(), ba, bb, a.z.data(), b.z.data(), rv.z.data(), op);
+  return rv;
+}
+
+template<typename Op>
+static q::Vec3s
+componentwise(const q::Vec3s &a, Op op) {
+  q::Vec3s rv(a.size());
+  map(rv.size(), a.x.data(), rv.x.data(), op);
+  map(rv.size(), a.y.data(), rv.y.data(), op);
+  map(rv.size(), a.z.data(), rv.z.data(), op);
+  return rv;
+}
+
+bool
+q::Vec3s::operator==(const q::Vec3s &rhs) const {
+  auto same = [](const std::vector<double> &l, const std::vector<double> &r) {
+    for(size_t i=0; i<l.size(); i++) {
+      if (!(l[i] == r[i] || (std::isnan(l[i]) && std::isnan(r[i])))) {
+	return false;
+      }
+    }
+    return true;
+  };
+  return size() == rhs.size() && same(x, rhs.x) && same(y, rhs.y) && same(z, rhs.z);
+}
+
+bool
+q::conformable(const q::Vec3s &a, const q::Vec3s &b) {
+  return a.size() == b.size() || a.size() == 1 || b.size() == 1;
+}
+
+q::Vec3s
+q::add(const q::Vec3s &a, const q::Vec3s &b) {
+  return componentwise(a, b, [](double l, double r) {
+      return present(l) + present(r) + none(there(l) + there(r));
+    });
+}
+
+q::Vec3s
+q::subtract(const q::Vec3s &a, const q::Vec3s &b) {
+  return componentwise(a, b, [](double l, double r) {
+      return present(l) - present(r) + none(there(l) + there(r));
+    });
+}
+
+q::Vec3s
+q::add(const q::Vec3s &a, double s) {
+  return componentwise(a, [s](double v) { return v + s; });
+}
+
+q::Vec3s
+q::subtract(const q::Vec3s &a, double s) {
+  return componentwise(a, [s](double v) { return v - s; });
+}
+
+q::Vec3s
+q::subtract(double s, const q::Vec3s &a) {
+  return componentwise(a, [s](double v) { return s - v; });
+}
+
+q::Vec3s
+q::scale(const q::Vec3s &a, double s) {
+  return componentwise(a, [s](double v) { return v * s; });
+}
+
+std::vector<double>
+q::dot(const q::Vec3s &a, const q::Vec3s &b) {
+  bool ba, bb;
+  size_t n = result_size(a, b, ba, bb);
+  std::vector<double> px(n), py(n), pz(n), rv(n);
+  auto product = [](double l, double r) { return l * r; };
+  zip(n, ba, bb, a.x.data(), b.x.data(), px.data(), product);
+  zip(n, ba, bb, a.y.data(), b.y.data(), py.data(), product);
+  zip(n, ba, bb, a.z.data(), b.z.data(), pz.data(), product);
+  const double *RESTRICT x = px.data();
+  const double *RESTRICT y = py.data();
+  const double *RESTRICT z = pz.data();
+  double *RESTRICT out = rv.data();
+  for(size_t i=0; i<n; i++) {
+    out[i] = present(x[i]) + present(y[i]) + present(z[i]) + none(there(x[i]) + there(y[i]) + there(z[i]));
+  }
+  return rv;
+}
+
+q::Vec3s
+q::cross(const q::Vec3s &a, const q::Vec3s &b) {
+  bool ba, bb;
+  size_t n = result_size(a, b, ba, bb);
+  q::Vec3s rv(n);
+  std::vector<double> p(n), t(n);
+  auto product = [](double l, double r) { return l * r; };
+  auto difference = [](double l, double r) { return l - r; };
+  // x = ay*bz - az*by, and around
+  zip(n, ba, bb, a.y.data(), b.z.data(), p.data(), product);
+  zip(n, ba, bb, a.z.data(), b.y.data(), t.data(), product);
+  zip(n, false, false, p.data(), t.data(), rv.x.data(), difference);
+  zip(n, ba, bb, a.z.data(), b.x.data(), p.data(), product);
+  zip(n, ba, bb, a.x.data(), b.z.data(), t.data(), product);
+  zip(n, false, false, p.data(), t.data(), rv.y.data(), difference);
+  zip(n, ba, bb, a.x.data(), b.y.data(), p.data(), product);
+  zip(n, ba, bb, a.y.data(), b.x.data(), t.data(), product);
+  zip(n, false, false, p.data(), t.data(), rv.z.data(), difference);
+  return rv;
+}
+
+std::vector<double>
+q::norm(const q::Vec3s &a) {
+  std::vector<double> sq = dot(a, a);
+  std::vector<double> rv(sq.size());
+  map(sq.size(), sq.data(), rv.data(), [](double v) { return std::sqrt(v); });
+  return rv;
+}
+
+q::Vec3s
+q::normalize(const q::Vec3s &a) {
+  std::vector<double> len = norm(a);
+  q::Vec3s rv(a.size());
+  auto divide = [](double l, double r) { return l / r; };
+  zip(a.size(), false, false, a.x.data(), len.data(), rv.x.data(), divide);
+  zip(a.size(), false, false, a.y.data(), len.data(), rv.y.data(), divide);
+  zip(a.size(), false, false, a.z.data(), len.data(), rv.z.data(), divide);
+  return rv;
+}
+
+q::Vec3s
+q::transform(const q::Vec3s &a, const double m[16]) {
+  size_t n = a.size();
+  q::Vec3s rv(n);
+  const double *RESTRICT x = a.x.data();
+  const double *RESTRICT y = a.y.data();
+  const double *RESTRICT z = a.z.data();
+  double *RESTRICT ox = rv.x.data();
+  double *RESTRICT oy = rv.y.data();
+  double *RESTRICT oz = rv.z.data();
+  for(size_t i=0; i<n; i++) {
+    double xi = present(x[i]);
+    double yi = present(y[i]);
+    double zi = present(z[i]);
+    ox[i] = m[0]*xi + m[1]*yi + m[2]*zi + m[3] + absent(x[i]);
+    oy[i] = m[4]*xi + m[5]*yi + m[6]*zi + m[7] + absent(y[i]);
+    oz[i] = m[8]*xi + m[9]*yi + m[10]*zi + m[11] + absent(z[i]);
+  }
+  return rv;
+}
+
+/* end of qinc/rpn-lang/src/vec3.cpp */
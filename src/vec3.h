@@ -0,0 +1,127 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/vec3.h
+ *
+ * @file    vec3.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace q {
+  /*
+   * many Vec3s as three parallel arrays.  a NaN component is missing,
+   * the same as in StVec3: adding or subtracting two vectors takes a
+   * missing component from the other side, anything else involving it
+   * stays missing.
+   *
+   * the two vector operands of add, subtract, dot and cross either have
+   * the same size, or one of them is a single vector that goes with
+   * every element of the other.
+   */
+  struct Vec3s {
+    Vec3s() = default;
+    explicit Vec3s(size_t n) : x(n, 0.), y(n, 0.), z(n, 0.) {}
+    Vec3s(double x0, double y0, double z0) : x(1, x0), y(1, y0), z(1, z0) {}
+    size_t size() const { return x.size(); }
+    bool operator==(const Vec3s &rhs) const;
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+  };
+
+  bool conformable(const Vec3s &a, const Vec3s &b);
+
+  Vec3s add(const Vec3s &a, const Vec3s &b);
+  Vec3s subtract(const Vec3s &a, const Vec3s &b);
+  Vec3s add(const Vec3s &a, double s);
+  Vec3s subtract(const Vec3s &a, double s);
+  Vec3s subtract(double s, const Vec3s &a);
+  Vec3s scale(const Vec3s &a, double s);
+  // over the components both sides have, NaN when there aren't any
+  std::vector<double> dot(const Vec3s &a, const Vec3s &b);
+  Vec3s cross(const Vec3s &a, const Vec3s &b);
+  // over the components that are there, NaN when there aren't any
+  std::vector<double> norm(const Vec3s &a);
+  Vec3s normalize(const Vec3s &a);
+  // m is a row-major 4x4 affine transform, the bottom row is ignored.
+  // missing components count as 0 going in and stay missing coming out
+  Vec3s transform(const Vec3s &a, const double m[16]);
+}
+
+#ifdef _RPN_LANG_RPN_H_
+namespace stack {
+  /*
+   * copies share the components until one of them is changed
+   */
+  class Vec3Array : public rpn::Stack::Object {
+  public:
+    Vec3Array() : _v(std::make_shared<q::Vec3s>()) {}
+    Vec3Array(q::Vec3s &&v) : _v(std::make_shared<q::Vec3s>(std::move(v))) {}
+    Vec3Array(const Vec3Array &va) = default;
+    virtual bool operator==(const rpn::Stack::Object &orhs) const override {
+      auto &rhs = PEEK_CAST(const Vec3Array, orhs);
+      return _v == rhs._v || *_v == *rhs._v;
+    }
+    virtual std::unique_ptr<rpn::Stack::Object> deep_copy() const override { return std::make_unique<Vec3Array>(*this); };
+    virtual operator std::string() const override {
+      std::string rv = "[";
+      for(size_t i=0; i<_v->size(); i++) {
+	rv += StVec3(_v->x[i], _v->y[i], _v->z[i]).to_string();
+	rv += ", ";
+      }
+      rv += "]";
+      return rv;
+    }
+    virtual std::string deparse() const override {
+      std::string rv;
+      for(size_t i=0; i<_v->size(); i++) {
+	rv += std::to_string(_v->x[i]) + " ";
+	rv += std::to_string(_v->y[i]) + " ";
+	rv += std::to_string(_v->z[i]) + " ->VEC3 ";
+      }
+      rv += std::to_string(_v->size()) + " ->ARRAY ->VEC3ARRAY";
+      return rv;
+    }
+    virtual bool image(rpn::ImageWriter &w) const override {
+      w.record("Vec3Array");
+      w.u32(uint32_t(_v->size()));
+      for(size_t i=0; i<_v->size(); i++) {
+	w.f64(_v->x[i]);
+	w.f64(_v->y[i]);
+	w.f64(_v->z[i]);
+      }
+      return true;
+    }
+    size_t size() const { return _v->size(); }
+    const q::Vec3s &val() const { return *_v; }
+  private:
+    std::shared_ptr<q::Vec3s> _v;
+  };
+} // namespace stack
+
+namespace vec3_validator {
+  extern const rpn::StrictTypeValidator d1_v3a;
+  extern const rpn::StrictTypeValidator d2_v3a_v3a;
+  extern const rpn::StrictTypeValidator d2_v3a_vec3;
+  extern const rpn::StrictTypeValidator d2_vec3_v3a;
+  extern const rpn::StrictTypeValidator d2_v3a_double;
+  extern const rpn::StrictTypeValidator d2_double_v3a;
+  extern const rpn::StrictTypeValidator d2_v3a_integer;
+  extern const rpn::StrictTypeValidator d2_integer_v3a;
+  extern const rpn::StrictTypeValidator d2_array_v3a;
+  extern const rpn::StrictTypeValidator d2_array_vec3;
+}
+#endif
+
+/* end of qinc/rpn-lang/src/vec3.h */
@@ -0,0 +1,104 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/work-pool.cpp
+ *
+ * @file    work-pool.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ */
+
+#include "work-pool.h"
+
+rpn::WorkPool::WorkPool(unsigned threads) {
+  for(unsigned i=0; i<threads; i++) {
+    _queues.push_back(std::make_unique<Queue>());
+  }
+  for(unsigned i=0; i<threads; i++) {
+    _threads.emplace_back(&rpn::WorkPool::loop, this, i);
+  }
+}
+
+rpn::WorkPool::~WorkPool() {
+  {
+    std::lock_guard lg(_mx);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for(auto &t : _threads) {
+    t.join();
+  }
+}
+
+void
+rpn::WorkPool::run(std::vector<Task> &tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+  {
+    // set first, a thread still draining the last batch can pick the
+    // new tasks up as soon as they're queued
+    std::lock_guard lg(_mx);
+    _pending = tasks.size();
+  }
+  for(size_t i=0; i<tasks.size(); i++) {
+    Queue &q = *_queues[i % _queues.size()];
+    std::lock_guard lg(q.mx);
+    q.tasks.push_back(&tasks[i]);
+  }
+  std::unique_lock ul(_mx);
+  _batch++;
+  _wake.notify_all();
+  _done.wait(ul, [this]{ return _pending == 0; });
+}
+
+rpn::WorkPool::Task *
+rpn::WorkPool::next(unsigned me) {
+  {
+    Queue &q = *_queues[me];
+    std::lock_guard lg(q.mx);
+    if (!q.tasks.empty()) {
+      Task *t = q.tasks.front();
+      q.tasks.pop_front();
+      return t;
+    }
+  }
+  for(size_t i=1; i<_queues.size(); i++) {
+    Queue &q = *_queues[(me+i) % _queues.size()];
+    std::lock_guard lg(q.mx);
+    if (!q.tasks.empty()) {
+      Task *t = q.tasks.back();
+      q.tasks.pop_back();
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+void
+rpn::WorkPool::loop(unsigned me) {
+  uint64_t seen = 0;
+  for(;;) {
+    {
+      std::unique_lock ul(_mx);
+      _wake.wait(ul, [this, seen]{ return _stop || _batch != seen; });
+      if (_stop) {
+	return;
+      }
+      seen = _batch;
+    }
+    while (Task *t = next(me)) {
+      (*t)(me);
+      std::lock_guard lg(_mx);
+      if (--_pending == 0) {
+	_done.notify_all();
+      }
+    }
+  }
+}
+
+/* end of qinc/rpn-lang/src/work-pool.cpp */
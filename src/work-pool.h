@@ -0,0 +1,63 @@
+/***************************************************
+ * file: qinc/rpn-lang/src/work-pool.h
+ *
+ * @file    work-pool.h
+ * @author  Eric L. Hernes
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C/C++ header
+ *
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace rpn {
+  /*
+   * a fixed set of threads, each with its own deque of tasks.  a thread
+   * works from the front of its own deque and, when that's empty, steals
+   * from the back of the others'.
+   */
+  class WorkPool {
+  public:
+    using Task = std::function<void(unsigned worker)>; // worker is 0..size()-1
+
+    explicit WorkPool(unsigned threads);
+    ~WorkPool();
+
+    unsigned size() const { return unsigned(_threads.size()); }
+
+    // runs every task and returns when they're all done.  task i is
+    // queued on worker i % size()
+    void run(std::vector<Task> &tasks);
+
+  private:
+    struct Queue {
+      std::mutex mx;
+      std::deque<Task*> tasks;
+    };
+    void loop(unsigned me);
+    Task *next(unsigned me);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mx;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    size_t _pending = 0;
+    uint64_t _batch = 0;
+    bool _stop = false;
+  };
+}
+
+/* end of qinc/rpn-lang/src/work-pool.h */
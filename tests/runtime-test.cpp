@@ -18,10 +18,86 @@
 #include "rpn.h"
 #include "src/fraction.h"
 #include "src/timecode.h"
+#include "src/fft.h"
+#include "src/vec3.h"
+#include "src/matrix.h"
+#include "src/bignum.h"
+#include "src/trace.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <random>
+#include <thread>
 
 rpn::Interp g_rpn;
 
+// a directory for one test's files, removed with everything in it
+struct TempDir {
+  TempDir() : path(std::filesystem::temp_directory_path() /
+		   ("rpn-test-" + std::to_string(std::random_device()()))) {
+    std::filesystem::create_directories(path);
+  }
+  ~TempDir() {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+  }
+  std::string operator/(const std::string &name) const { return (path / name).string(); }
+  std::filesystem::path path;
+};
+
+// a then b leave two equal values
+static void
+require_same(rpn::Interp &rpn, const std::string &a, const std::string &b) {
+  INFO("'" << a << "' vs '" << b << "'");
+  rpn.stack.clear();
+  REQUIRE( (rpn.sync_eval(a + " " + b) == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (2 == rpn.stack.depth()) );
+  REQUIRE( (rpn.stack.peek(1) == rpn.stack.peek(2)) );
+}
+
+static void
+require_same(rpn::Interp &rpn, const std::vector<std::pair<std::string,std::string>> &same) {
+  for(auto const &s : same) {
+    require_same(rpn, s.first, s.second);
+  }
+}
+
+// a and b leave as many values each, pairwise within 1e-6; arrays are
+// compared element by element
+static void
+require_close(rpn::Interp &rpn, const std::string &a, const std::string &b) {
+  INFO("'" << a << "' vs '" << b << "'");
+  rpn.stack.clear();
+  REQUIRE( (rpn.sync_eval(a) == rpn::WordDefinition::Result::ok) );
+  size_t depth = rpn.stack.depth();
+  REQUIRE( (rpn.sync_eval(b) == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (2*depth == rpn.stack.depth()) );
+  for(size_t i=1; i<=depth; i++) {
+    const auto &l = rpn.stack.peek_const(int(i+depth));
+    const auto &r = rpn.stack.peek_const(int(i));
+    if (typeid(l) == typeid(StArray)) {
+      const auto &la = PEEK_CAST(const StArray, l);
+      const auto &ra = PEEK_CAST(const StArray, r);
+      REQUIRE( (la.size() == ra.size()) );
+      for(size_t j=0; j<la.size(); j++) {
+	REQUIRE_THAT(double(la.value(j)), Catch::Matchers::WithinAbs(double(ra.value(j)), 0.000001));
+      }
+    } else {
+      REQUIRE_THAT(rpn.stack.peek_as_double(int(i)), Catch::Matchers::WithinAbs(rpn.stack.peek_as_double(int(i+depth)), 0.000001));
+    }
+  }
+}
+
+static void
+require_close(rpn::Interp &rpn, const std::vector<std::pair<std::string,std::string>> &same) {
+  for(auto const &s : same) {
+    require_close(rpn, s.first, s.second);
+  }
+}
+
 TEST_CASE( "parse", "Stack Words" ) {
 
   /*
@@ -569,6 +645,40 @@ TEST_CASE( "other tests", "math" ) {
  
 }
 
+TEST_CASE( "precision", "formatting" ) {
+  rpn::Interp a;
+  rpn::Interp b;
+  std::string line = ("3 ->PRECISION 2. 3. / 1.e300 3. -2.5 2. 3. / -1. 0. / 0.");
+  auto st = a.sync_eval(line);
+  REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+  line = ("2. 3. /");
+  st = b.sync_eval(line);
+  REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+
+  // each interpreter keeps its own
+  REQUIRE( ("0.667" == a.stack.peek_as_string(7)) );
+  REQUIRE( ("0.6666666667" == b.stack.peek_as_string(1)) );
+
+  REQUIRE( ("1e+300" == a.stack.peek_as_string(6)) );
+  REQUIRE( ("3." == a.stack.peek_as_string(5)) );
+  REQUIRE( ("-2.5" == a.stack.peek_as_string(4)) );
+  REQUIRE( ("-inf" == a.stack.peek_as_string(2)) );
+  REQUIRE( ("0." == a.stack.peek_as_string(1)) );
+
+  line = ("->STRING");
+  st = a.sync_eval(line);
+  REQUIRE( ("0." == a.stack.peek_string(1)) );
+  line = ("DROP DROP ->STRING PRECISION->");
+  st = a.sync_eval(line);
+  REQUIRE( (3 == a.stack.peek_integer(1)) );
+  REQUIRE( ("0.667" == a.stack.peek_string(2)) );
+
+  char buf[32];
+  rpn::NumberFormat f;
+  f.decimals = 1;
+  REQUIRE( ("0.7" == std::string(buf, rpn::to_chars(buf, buf+sizeof(buf), 2./3., f))) );
+}
+
 TEST_CASE( "loop tests", "control" ) {
   std::string line;
   // simple single for loop
@@ -817,6 +927,195 @@ TEST_CASE( "loop tests", "control" ) {
 
 }
 
+TEST_CASE( "return stack", "control" ) {
+  std::string line;
+  {
+    g_rpn.stack.clear();
+    line = (": rs-1 1 + ; : rs-2 rs-1 2 * ; : rs-3 rs-2 3 * ; : rs-4 rs-3 4 * ;");
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+
+    line = ("1 rs-4");
+    st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == g_rpn.stack.depth() ) );
+    REQUIRE( (48 == g_rpn.stack.peek_integer(1)) );
+  }
+
+  // nesting deeper than the limit fails cleanly
+  {
+    g_rpn.stack.clear();
+    line = ("3 ->RLIMIT 1 rs-4");
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::eval_error) );
+
+    g_rpn.stack.clear();
+    line = ("4 ->RLIMIT 1 rs-4 RLIMIT-> 65536 ->RLIMIT");
+    st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (4 == g_rpn.stack.peek_integer(1)) );
+    REQUIRE( (48 == g_rpn.stack.peek_integer(2)) );
+  }
+
+  // tail calls reuse the caller's frame
+  {
+    g_rpn.stack.clear();
+    line = (": rt-1 1 + ; : rt-2 2 + rt-1 ; : rt-3 3 + rt-2 ; : rt-4 4 + rt-3 ;");
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+
+    line = ("2 ->RLIMIT 0 rt-4 65536 ->RLIMIT");
+    st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == g_rpn.stack.depth() ) );
+    REQUIRE( (10 == g_rpn.stack.peek_integer(1)) );
+  }
+}
+
+TEST_CASE( "image", "state" ) {
+  TempDir tmp;
+  const std::string image = tmp / "image-test.rpni";
+  std::string line;
+  g_rpn.stack.clear();
+  line = (": img-sum 0 1 4 FOR i i + NEXT ;"
+	  " 42 3.25 TRUE .\" some text\" 1 2 3 3 ->ARRAY"
+	  " 3.6 .\" abc\" ->OBJ 2.8 .\" def\" + 1 2 ->FRAC 1. 2. ->COMPLEX");
+  auto st = g_rpn.sync_eval(line);
+  REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+  g_rpn.stack.push(StVec3(1., 2., 3.));
+  g_rpn.stack.push(stack::Timecode(q::Timecode(1, 2, 3, 4, q::Fraction(24, 1))));
+  size_t depth = g_rpn.stack.depth();
+
+  REQUIRE( g_rpn.saveImage(image) );
+  REQUIRE( (depth == g_rpn.stack.depth()) );
+
+  {
+    rpn::Interp rpn;
+    rpn.stack.push_integer(99);
+    REQUIRE( rpn.loadImage(image) );
+    REQUIRE( (depth == rpn.stack.depth()) );
+    for(size_t i=1; i<=depth; i++) {
+      REQUIRE( (rpn.stack.peek(int(i)) == g_rpn.stack.peek(int(i))) );
+    }
+
+    // the user word comes along, with its loop
+    rpn.stack.clear();
+    line = ("img-sum");
+    st = rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == rpn.stack.depth()) );
+    REQUIRE( (6. == rpn.stack.peek_as_double(1)) );
+
+    // loading again replaces the word rather than adding another
+    REQUIRE( rpn.loadImage(image) );
+    line = ("WORDLIST");
+    st = rpn.sync_eval(line);
+    auto &words = PEEK_CAST(StArray, rpn.stack.peek(1));
+    REQUIRE( (std::count_if(words.val().begin(), words.val().end(),
+			    [](const auto &w) { return std::string(*w) == "img-sum"; }) == 1) );
+
+    REQUIRE( !rpn.loadImage(tmp / "no-such-image.rpni") );
+  }
+
+  // a word can load an image that replaces it, it finishes first
+  {
+    rpn::Interp saver;
+    REQUIRE( (saver.sync_eval(": RELOAD 1 ;") == rpn::WordDefinition::Result::ok) );
+    saver.stack.clear();
+    REQUIRE( saver.saveImage(tmp / "reload.rpni") );
+
+    rpn::Interp rpn;
+    REQUIRE( (rpn.sync_eval(": RELOAD .\" " + (tmp / "reload.rpni") + "\" LOAD-IMAGE 7 ;") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (rpn.sync_eval("RELOAD") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == rpn.stack.depth()) );
+    REQUIRE( (7 == rpn.stack.peek_integer(1)) );
+    REQUIRE( (rpn.sync_eval("RELOAD") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == rpn.stack.peek_integer(1)) );
+  }
+
+  // queued behind an eval, on the Interp's own thread
+  {
+    rpn::Interp rpn;
+    std::promise<rpn::WordDefinition::Result> evaled, saved, loaded, missing;
+    rpn.eval(": QUEUED 5 ; QUEUED", [&](rpn::WordDefinition::Result rv) { evaled.set_value(rv); });
+    rpn.saveImage(tmp / "queued.rpni", [&](rpn::WordDefinition::Result rv) { saved.set_value(rv); });
+    rpn.eval("DROP 6");
+    rpn.loadImage(tmp / "queued.rpni", [&](rpn::WordDefinition::Result rv) { loaded.set_value(rv); });
+    REQUIRE( (evaled.get_future().get() == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (saved.get_future().get() == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (loaded.get_future().get() == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == rpn.stack.depth()) );
+    REQUIRE( (5 == rpn.stack.peek_integer(1)) );
+    rpn.loadImage(tmp / "no-such-image.rpni", [&](rpn::WordDefinition::Result rv) { missing.set_value(rv); });
+    REQUIRE( (missing.get_future().get() == rpn::WordDefinition::Result::eval_error) );
+  }
+
+  // through the words
+  {
+    g_rpn.stack.clear();
+    line = ("1 2 .\" " + image + "\" SAVE-IMAGE DROP DROP .\" " + image + "\" LOAD-IMAGE");
+    st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    REQUIRE( (2 == g_rpn.stack.peek_integer(1)) );
+  }
+}
+
+TEST_CASE( "parse cache", "parsing" ) {
+  // the caches are written next to the sources
+  TempDir tmp;
+  const std::string script = tmp / "tests.rpn";
+  const std::string changed = tmp / "cache-test.rpn";
+  std::filesystem::copy_file("tests.rpn", script);
+  rpn::Interp text;
+  text.setParseCache(true);
+  auto st = text.sync_parseFile(script);
+  REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (18 == text.stack.depth()) );
+  REQUIRE( std::ifstream(script + "c").good() );
+
+  {
+    rpn::Interp cached;
+    cached.setParseCache(true);
+    st = cached.sync_parseFile(script);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (18 == cached.stack.depth()) );
+    for(int i=1; i<=18; i++) {
+      REQUIRE( (cached.stack.peek(i) == text.stack.peek(i)) );
+    }
+    REQUIRE( cached.wordExists("circle-area") );
+  }
+
+  // a changed source makes the cache stale
+  {
+    std::ofstream(changed) << ": ct-w 2 * ;\n21 ct-w\n";
+    rpn::Interp rpn;
+    rpn.setParseCache(true);
+    st = rpn.sync_parseFile(changed);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (42 == rpn.stack.peek_integer(1)) );
+
+  }
+  {
+    std::ofstream(changed) << ": ct-w 3 * ;\n21 ct-w\n";
+    rpn::Interp rpn;
+    rpn.setParseCache(true);
+    st = rpn.sync_parseFile(changed);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (63 == rpn.stack.peek_integer(1)) );
+  }
+
+  // and a damaged one falls back to the text
+  {
+    std::ofstream(changed + "c") << "RPNI";
+    rpn::Interp rpn;
+    rpn.setParseCache(true);
+    st = rpn.sync_parseFile(changed);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (63 == rpn.stack.peek_integer(1)) );
+  }
+}
+
 TEST_CASE( "bolt-circle", "control" ) {
   std::string line;
 
@@ -895,14 +1194,14 @@ NEXT
 #include "validator-tests.h"
 
 static const std::map<std::size_t,std::string> sk_hashMap = {
-  { typeid(StDouble).hash_code(), "Double" },
-  { typeid(StInteger).hash_code(), "Integer" },
-  { typeid(StBoolean).hash_code(), "Boolean" },
-  { typeid(StString).hash_code(), "String" },
-  { typeid(StObject).hash_code(), "Object" },
-  { typeid(StArray).hash_code(), "Array" },
-  { typeid(stack::Fraction).hash_code(), "Fraction" },
-  { typeid(stack::Timecode).hash_code(), "Timecode" },
+  { rpn::type_tag<StDouble>(), "Double" },
+  { rpn::type_tag<StInteger>(), "Integer" },
+  { rpn::type_tag<StBoolean>(), "Boolean" },
+  { rpn::type_tag<StString>(), "String" },
+  { rpn::type_tag<StObject>(), "Object" },
+  { rpn::type_tag<StArray>(), "Array" },
+  { rpn::type_tag<stack::Fraction>(), "Fraction" },
+  { rpn::type_tag<stack::Timecode>(), "Timecode" },
 };
 
 TEST_CASE("validators", "strict-type") {
@@ -926,6 +1225,9 @@ TEST_CASE("validators", "strict-type") {
     { rpn::StrictTypeValidator::d2_integer_vec3, "8. 7. 6. ->VEC3 3" },
     { rpn::StrictTypeValidator::d2_array_any, "<true> <true> 1 ->ARRAY" },
     { rpn::StrictTypeValidator::d2_any_array, "1 2 3 3 ->ARRAY 4.5" },
+    { rpn::StrictTypeValidator::d2_array_array, "1 1 ->ARRAY 2 1 ->ARRAY" },
+    { rpn::StrictTypeValidator::d2_integer_array, "1 2 2 ->ARRAY 0" },
+    { rpn::StrictTypeValidator::d2_string_array, "1 2 2 ->ARRAY .\" key\"" },
     { rpn::StrictTypeValidator::d2_string_any, "<true> .\" flag\"" },
     { rpn::StrictTypeValidator::d2_any_string, ".\" abc\" <true> .\" flag\" ->OBJ" },
     { rpn::StrictTypeValidator::d2_object_any, "<true> .\" flag\" ->OBJ DUP" },
@@ -941,12 +1243,49 @@ TEST_CASE("validators", "strict-type") {
     { rpn::StrictTypeValidator::d3_any_any_boolean, "<true> 1 .\" string\"" }, 
     { rpn::StrictTypeValidator::d3_object_string_any, "99 .\" bottles\" 44 .\" xyz\" ->OBJ" },
     { rpn::StrictTypeValidator::d3_string_any_object, ".\" football\" .\" life\" ->OBJ 42 .\" meaning\"" },
+    { rpn::StrictTypeValidator::d3_integer_any_array, "1 2 2 ->ARRAY 3.5 1" },
+    { rpn::StrictTypeValidator::d3_any_integer_array, "1 2 2 ->ARRAY 1 3.5" },
+    { rpn::StrictTypeValidator::d3_integer_integer_array, "1 2 2 ->ARRAY 0 1" },
     { rpn::StrictTypeValidator::d4_double_double_double_integer, "5 1.2 2.3 3.4" },
     { rpn::StrictTypeValidator::d4_integer_double_double_double, "2.2 3.3 4.4 5" },
     { timecode_validator::d1_tc, "60000 1001 ->FRAC 12345 ->TC" },
     { timecode_validator::d2_tc_tc, "60000 1001 ->FRAC 12345 ->TC 60000 1001 ->FRAC 145 ->TC" },
     { timecode_validator::d2_int_tc, "60000 1001 ->FRAC 4444 ->TC 17" },
     { timecode_validator::d2_tc_int, "120 60000 1001 ->FRAC 12345 ->TC" },
+    { timecode_validator::d2_array_frac, "24 1 ->FRAC 1 2 2 ->ARRAY" },
+    { fft_validator::d1_carray, "1 2 2 ->ARRAY ->CARRAY" },
+    { fft_validator::d2_carray_carray, "1 2 2 ->ARRAY ->CARRAY 3 1 ->ARRAY ->CARRAY" },
+    { vec3_validator::d1_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY" },
+    { vec3_validator::d2_v3a_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY DUP" },
+    { vec3_validator::d2_v3a_vec3, "4 5 6 ->VEC3 1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY" },
+    { vec3_validator::d2_vec3_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY 4 5 6 ->VEC3" },
+    { vec3_validator::d2_v3a_double, "2.5 1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY" },
+    { vec3_validator::d2_double_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY 2.5" },
+    { vec3_validator::d2_v3a_integer, "2 1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY" },
+    { vec3_validator::d2_integer_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY 2" },
+    { vec3_validator::d2_array_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY 1 2 2 ->ARRAY" },
+    { vec3_validator::d2_array_vec3, "1 2 3 ->VEC3 1 2 2 ->ARRAY" },
+    { matrix_validator::d1_matrix, "1 2 2 ->ARRAY 1 ->ARRAY ->MATRIX" },
+    { matrix_validator::d2_matrix_matrix, "1 2 2 ->ARRAY 1 ->ARRAY ->MATRIX DUP" },
+    { matrix_validator::d2_array_matrix, "1 2 2 ->ARRAY 1 ->ARRAY ->MATRIX 1 1 ->ARRAY" },
+    { matrix_validator::d2_matrix_v3a, "1 2 3 ->VEC3 1 ->ARRAY ->VEC3ARRAY 1 2 2 ->ARRAY 1 ->ARRAY ->MATRIX" },
+    { matrix_validator::d2_matrix_vec3, "1 2 3 ->VEC3 1 2 2 ->ARRAY 1 ->ARRAY ->MATRIX" },
+    { bignum_validator::d1_bigint, "18446744073709551616" },
+    { bignum_validator::d1_bigfrac, "18446744073709551616 3 ->FRAC" },
+    { bignum_validator::d2_bigint_bigint, "18446744073709551616 DUP" },
+    { bignum_validator::d2_bigint_integer, "1 18446744073709551616" },
+    { bignum_validator::d2_integer_bigint, "18446744073709551616 1" },
+    { bignum_validator::d2_bigint_double, "1.5 18446744073709551616" },
+    { bignum_validator::d2_double_bigint, "18446744073709551616 1.5" },
+    { bignum_validator::d2_integer_bigfrac, "18446744073709551616 3 ->FRAC 1" },
+    { bignum_validator::d2_bigfrac_integer, "1 18446744073709551616 3 ->FRAC" },
+    { bignum_validator::d2_bigint_bigfrac, "18446744073709551616 3 ->FRAC 18446744073709551616" },
+    { bignum_validator::d2_bigfrac_bigint, "18446744073709551616 18446744073709551616 3 ->FRAC" },
+    { bignum_validator::d2_frac_bigfrac, "18446744073709551616 3 ->FRAC 1 2 ->FRAC" },
+    { bignum_validator::d2_bigfrac_frac, "1 2 ->FRAC 18446744073709551616 3 ->FRAC" },
+    { bignum_validator::d2_bigfrac_bigfrac, "18446744073709551616 3 ->FRAC DUP" },
+    { bignum_validator::d2_frac_bigint, "18446744073709551616 1 2 ->FRAC" },
+    { bignum_validator::d2_bigint_frac, "1 2 ->FRAC 18446744073709551616" },
     { frac_validator::d1_frac, "2 3 ->FRAC" },
     { frac_validator::d2_frac_frac, "1 2 ->FRAC 0.75 ->FRAC" },
     { frac_validator::d2_frac_int, "7 1 9 ->FRAC" },
@@ -986,7 +1325,7 @@ TEST_CASE( "object", "types" ) {
   {
     line = ("3.6");
     g_rpn.stack.clear();
-    auto st = g_rpn.sync_eval(line);
+    g_rpn.sync_eval(line);
     auto &so = g_rpn.stack.peek(1);
     REQUIRE_THROWS_AS( dynamic_cast<StObject&>(so),
 		       std::bad_cast);
@@ -995,9 +1334,987 @@ TEST_CASE( "object", "types" ) {
 }
 
 TEST_CASE( "array", "types" ) {
+  std::string line;
+  {
+    line = ("1 2 3 3 ->ARRAY 4 APPEND 0 0 INSERT LENGTH");
+    g_rpn.stack.clear();
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    REQUIRE( (5 == g_rpn.stack.peek_integer(1)) );
+    REQUIRE( ("[0, 1, 2, 3, 4, ]" == g_rpn.stack.peek_as_string(2)) );
+  }
+
+  {
+    line = ("1 2 3 3 ->ARRAY OBJ->");
+    g_rpn.stack.clear();
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (4 == g_rpn.stack.depth()) );
+    REQUIRE( (3 == g_rpn.stack.peek_integer(1)) );
+    REQUIRE( (1 == g_rpn.stack.peek_integer(2)) );
+    REQUIRE( (3 == g_rpn.stack.peek_integer(4)) );
+  }
+
+  for(auto bad : { "1 2 3 ->ARRAY", "1 2 -1 ->ARRAY" }) {
+    INFO("'" << bad << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(bad) == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (3 == g_rpn.stack.depth()) );
+    REQUIRE( (2 == g_rpn.stack.peek_integer(2)) );
+  }
+
+  {
+    line = ("10 20 30 3 ->ARRAY 1 GET SWAP 2 99 PUT 2 GET");
+    g_rpn.stack.clear();
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (3 == g_rpn.stack.depth()) );
+    REQUIRE( (99 == g_rpn.stack.peek_integer(1)) );
+    REQUIRE( (20 == g_rpn.stack.peek_integer(3)) );
+  }
+
+  {
+    std::vector<std::pair<std::string,std::string>> same = {
+      { "10 20 30 40 4 ->ARRAY 1 3 SLICE", "20 30 2 ->ARRAY" },
+      { "10 20 2 ->ARRAY 0 0 SLICE", "0 ->ARRAY" },
+      { "1 2 2 ->ARRAY 3 4 2 ->ARRAY CONCAT", "1 2 3 4 4 ->ARRAY" },
+      { "1 2 2 ->ARRAY DUP CONCAT", "1 2 1 2 4 ->ARRAY" },
+      { "1 2 2 ->ARRAY 3 4 2 ->ARRAY +", "1 2 3 4 4 ->ARRAY" },
+      { "1 2 2 ->ARRAY 3 +", "1 2 3 3 ->ARRAY" },
+      { "0 1 2 2 ->ARRAY +", "0 1 2 3 ->ARRAY" },
+    };
+    require_same(g_rpn, same);
+  }
+
+  {
+    // bad indices leave the stack alone
+    for(auto const &l : { "1 2 2 ->ARRAY 5 GET", "1 2 2 ->ARRAY 9 3 INSERT",
+			  "1 2 2 ->ARRAY -1 9 PUT", "1 2 2 ->ARRAY 1 3 SLICE" }) {
+      INFO(l);
+      g_rpn.stack.clear();
+      REQUIRE( (g_rpn.sync_eval(l) == rpn::WordDefinition::Result::param_error) );
+      REQUIRE( ("[1, 2, ]" == g_rpn.stack.peek_as_string(g_rpn.stack.depth())) );
+    }
+  }
+
+  {
+    // a shared array is copied before it's changed
+    line = ("1 2 2 ->ARRAY DUP 9 APPEND");
+    g_rpn.stack.clear();
+    g_rpn.sync_eval(line);
+    REQUIRE( ("[1, 2, 9, ]" == g_rpn.stack.peek_as_string(1)) );
+    REQUIRE( ("[1, 2, ]" == g_rpn.stack.peek_as_string(2)) );
+  }
+
+  {
+    line = ("0 ->ARRAY 0 20000 FOR i i APPEND NEXT LENGTH");
+    g_rpn.stack.clear();
+    auto st = g_rpn.sync_eval(line);
+    REQUIRE( (st == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (20000 == g_rpn.stack.peek_integer(1)) );
+  }
+}
+
+TEST_CASE( "sort", "types" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "3 1 2 3 ->ARRAY SORT", "1 2 3 3 ->ARRAY" },
+    { "3 1 2 3 ->ARRAY SORT-DESC", "3 2 1 3 ->ARRAY" },
+    { "2.5 1 -3. 3 ->ARRAY SORT", "-3. 1 2.5 3 ->ARRAY" },
+    { ".\" pear\" .\" apple\" .\" fig\" 3 ->ARRAY SORT", ".\" apple\" .\" fig\" .\" pear\" 3 ->ARRAY" },
+    { "1 2 2 3 3 3 1 7 ->ARRAY UNIQ", "1 2 3 1 4 ->ARRAY" },
+    { "1 2 2 3 3 3 1 7 ->ARRAY SORT UNIQ", "1 2 3 3 ->ARRAY" },
+    { "0 ->ARRAY SORT", "0 ->ARRAY" },
+    { "2 .\" n\" ->OBJ 1 .\" n\" ->OBJ 2 ->ARRAY .\" n\" SORT-BY",
+      "1 .\" n\" ->OBJ 2 .\" n\" ->OBJ 2 ->ARRAY" },
+  };
+  require_same(g_rpn, same);
+
+  {
+    // missing keys and mixed types are errors
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("1 .\" n\" ->OBJ 2 1 ->ARRAY .\" m\" SORT-BY") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (3 == g_rpn.stack.depth()) );
+    REQUIRE( (g_rpn.stack.peek_string(1) == "m") );
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("1 .\" n\" ->OBJ .\" a\" .\" n\" ->OBJ 2 ->ARRAY .\" n\" SORT-BY") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    REQUIRE( (g_rpn.stack.peek_string(1) == "n") );
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("1 .\" a\" 2 ->ARRAY SORT") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (1 == g_rpn.stack.depth()) );
+  }
+
+  {
+    // timecodes at one rate sort on frame count
+    q::Fraction fps(24, 1);
+    StArray arr;
+    for(int64_t f : { 100, 5, 2000, 42 }) {
+      arr.add_value(stack::Timecode(q::Timecode(f, fps)));
+    }
+    g_rpn.stack.clear();
+    g_rpn.stack.push(arr);
+    REQUIRE( (g_rpn.sync_eval("SORT") == rpn::WordDefinition::Result::ok) );
+    const auto &sorted = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+    int64_t last = -1;
+    for(size_t i=0; i<sorted.size(); i++) {
+      int64_t f = PEEK_CAST(const stack::Timecode, sorted.value(i)).to_frames();
+      REQUIRE( (f > last) );
+      last = f;
+    }
+  }
+
+  {
+    // big enough for the parallel path
+    StArray arr;
+    uint64_t x = 88172645463325252ull;
+    for(size_t i=0; i<200000; i++) {
+      x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+      arr.add_value(StDouble(double(x % 1000003) / 7.));
+    }
+    g_rpn.stack.clear();
+    g_rpn.stack.push(arr);
+    REQUIRE( (g_rpn.sync_eval("SORT-DESC") == rpn::WordDefinition::Result::ok) );
+    const auto &sorted = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+    REQUIRE( (sorted.size() == 200000) );
+    bool ordered = true;
+    for(size_t i=1; i<sorted.size(); i++) {
+      ordered &= double(sorted.value(i-1)) >= double(sorted.value(i));
+    }
+    REQUIRE( ordered );
+  }
+}
+
+TEST_CASE( "fraction", "types" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "0.75 ->FRAC OBJ->", "3 4" },
+    { "-2.5 ->FRAC OBJ->", "-5 2" },
+    { "29.97 ->FRAC OBJ->", "2997 100" },
+    { "23.976 ->FRAC OBJ->", "2997 125" },
+    { "29.97 ->FPS FPS-> OBJ-> 24 ->FPS", "30000 1001" },
+    { "23.976 0 ->TC FR OBJ->", "24000 1001" },
+    { "3.14159265358979 1000 ->FRAC OBJ->", "355 113" },
+    { "3.14159265358979 ->FRAC OBJ->", "104348 33215" },
+    { "1 2 ->FRAC 0.25 + ->FLOAT", "0.75" },
+    { "1 3 ->FRAC 0.5 * OBJ->", "1 6" },
+  };
+  require_close(g_rpn, same);
+
+  // the same answer from the memo
+  REQUIRE( (q::Fraction(0.1)._denominator == 10) );
+  REQUIRE( (q::Fraction(0.1)._denominator == 10) );
+  REQUIRE( (q::Fraction::approximate(2./3., 2, 0.)._denominator == 2) );
+  REQUIRE( (q::Fraction::approximate(2./3., 3, 0.)._denominator == 3) );
+  REQUIRE( (q::Fraction(60000./1001.)._numerator == 60000) );
+
+  // only a frame rate takes a typed 29.97 as 30000/1001
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval("29.97 ->FRAC ->FLOAT") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (g_rpn.stack.pop_double() == 29.97) );
+  REQUIRE( (g_rpn.sync_eval("1 2 ->FRAC 23.98 + ->FLOAT") == rpn::WordDefinition::Result::ok) );
+  REQUIRE_THAT(g_rpn.stack.pop_double(), Catch::Matchers::WithinAbs(24.48, 1e-9));
+  REQUIRE( (q::Fraction::from_rate(29.97)._denominator == 1001) );
+  REQUIRE( (q::Fraction::from_rate(23.976)._numerator == 24000) );
+  REQUIRE( (q::Fraction::from_rate(25.)._denominator == 1) );
+
+  // a number less a fraction
+  REQUIRE( (g_rpn.sync_eval("0.25 1 2 ->FRAC - OBJ->") == rpn::WordDefinition::Result::ok) );
+  int64_t den = g_rpn.stack.pop_integer();
+  int64_t num = g_rpn.stack.pop_integer();
+  REQUIRE( (num * 4 == -den) );
+  REQUIRE( (0 == g_rpn.stack.depth()) );
+
+  // past 2^62 it is already a whole number, and convergents stop before
+  // their denominator overflows
+  REQUIRE( (q::Fraction(5e18)._numerator == 5000000000000000000) );
+  REQUIRE( (q::Fraction(-5e18)._numerator == -5000000000000000000) );
+  REQUIRE( (q::Fraction(1e19)._numerator == INT64_MAX) );
+  q::Fraction deep = q::Fraction::approximate(0x1.a29e835c0e448p-33, INT64_MAX, 0.);
+  REQUIRE( (deep._denominator > 0) );
+  REQUIRE_THAT(double(deep._numerator)/double(deep._denominator), Catch::Matchers::WithinRel(0x1.a29e835c0e448p-33, 1e-15));
+}
+
+TEST_CASE( "timecode", "types" ) {
+  {
+    // drop frame skips ;00 and ;01 on every minute but the tenth
+    q::Fraction df(30000, 1001);
+    std::vector<std::pair<int64_t,std::string>> frames = {
+      { 1799, "TC/DF 00:00:59;29 @ 29.97" },
+      { 1800, "TC/DF 00:01:00;02 @ 29.97" },
+      { 17982, "TC/DF 00:10:00;00 @ 29.97" },
+      { 2589407, "TC/DF 23:59:59;29 @ 29.97" },
+      { 2589408, "TC/DF 00:00:00;00 @ 29.97" },
+      { -1, "TC/DF 23:59:59;29 @ 29.97" },
+    };
+    for(auto const &f : frames) {
+      q::Timecode tc(f.first, df);
+      INFO(f.first);
+      REQUIRE( (tc.to_string() == f.second) );
+    }
+    auto &rate = q::FrameRate::get(df);
+    REQUIRE( (&rate == &q::FrameRate::get(q::Fraction(60000, 2002))) );
+    bool right = true;
+    for(int64_t f=0; f<rate.perDay; f+=7) {
+      right &= (q::Timecode(f, rate).to_frames() == f);
+    }
+    REQUIRE( right );
+    REQUIRE( (q::Timecode(0, 1, 0, 0, df).to_frames() == 1798) );
+    REQUIRE( (q::Timecode(0, 0, 0, -1, q::Fraction(24, 1)).to_string() == "TC/NDF 23:59:59:23 @ 24.00") );
+  }
+
+  {
+    // whole arrays at once
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("24 1 ->FRAC 0 24 1440 3 ->ARRAY ->TC") == rpn::WordDefinition::Result::ok) );
+    const auto &tcs = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+    REQUIRE( (tcs.size() == 3) );
+    REQUIRE( (std::string(tcs.value(2)) == "TC/NDF 00:01:00:00 @ 24.00") );
+    REQUIRE( (g_rpn.sync_eval("->FRAMES 0 24 1440 3 ->ARRAY") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (g_rpn.stack.peek(1) == g_rpn.stack.peek(2)) );
+
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("24 1 ->FRAC 0 2.5 2 ->ARRAY ->TC") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("0 1 ->FRAC 10 ->TC") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+  }
+
+  {
+    // literals at the session rate, ordered by time
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("30000 1001 ->FRAC ->FPS 00:10:00;00 ->FRAMES") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (g_rpn.stack.pop_integer() == 17982) );
+    REQUIRE( (g_rpn.sync_eval("01:00:00:00 24 ->FPS 01:00:00:00 < 00:00:01:00 00:00:00:23 >") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( g_rpn.stack.pop_boolean() );
+    REQUIRE( g_rpn.stack.pop_boolean() );
+    REQUIRE( (g_rpn.sync_eval("00:00:00:24") == rpn::WordDefinition::Result::parse_error) );
+    REQUIRE( (g_rpn.sync_eval("00:00:02:00 00:00:01:00 2 ->ARRAY SORT 0 GET ->FRAMES") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (g_rpn.stack.pop_integer() == 24) );
+  }
+
+  {
+    TempDir tmp;
+    std::ofstream edl(tmp / "edl-test.edl");
+    edl << "TITLE: runtime-test\r\n"
+	<< "FCM: NON-DROP FRAME\r\n"
+	<< "\r\n"
+	<< "001  AX       V     C        01:00:00:00 01:00:05:00 00:00:00:00 00:00:05:00\r\n"
+	<< "* FROM CLIP NAME:  shot one.mov\r\n"
+	<< "002  AX       V     C        02:00:00:00 02:00:00:00 00:00:05:00 00:00:05:00\r\n"
+	<< "002  BL       V     D    012 00:00:00:00 00:00:02:00 00:00:05:00 00:00:07:00\r\n"
+	<< "003  R2       AA/V  K B      01:00:10:00 01:00:11:00 00:00:07:00 00:00:08:00\r\n";
+    edl.close();
+
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(".\" " + (tmp / "edl-test.edl") + "\" EDL->") == rpn::WordDefinition::Result::ok) );
+    const auto &events = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+    REQUIRE( (events.size() == 4) );
+    const auto &first = PEEK_CAST(const StObject, events.value(0));
+    REQUIRE( (std::string(first.member("clip")) == "shot one.mov") );
+    REQUIRE( (PEEK_CAST(const stack::Timecode, first.member("src-in")).to_frames() == 86400) );
+    REQUIRE( (PEEK_CAST(const stack::Timecode, first.member("rec-out")).to_frames() == 120) );
+    const auto &dissolve = PEEK_CAST(const StObject, events.value(2));
+    REQUIRE( (std::string(dissolve.member("transition")) == "D") );
+    REQUIRE( (int64_t(PEEK_CAST(const StInteger, dissolve.member("duration"))) == 12) );
+    REQUIRE( (std::string(dissolve.member("clip")) == "") );
+    const auto &key = PEEK_CAST(const StObject, events.value(3));
+    REQUIRE( (std::string(key.member("transition")) == "K B") );
+    REQUIRE( (std::string(key.member("track")) == "AA/V") );
+    REQUIRE( (first.shape() == key.shape()) );
+
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(".\" " + (tmp / "no-such.edl") + "\" EDL->") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (1 == g_rpn.stack.depth()) );
+
+    // an event number or duration too big for an integer
+    for(auto const &bad : { "99999999999999999999  AX  V  C        01:00:00:00 01:00:05:00 00:00:00:00 00:00:05:00\r\n",
+			    "001  BL  V  D  99999999999999999999 00:00:00:00 00:00:02:00 00:00:05:00 00:00:07:00\r\n" }) {
+      INFO(bad);
+      std::ofstream(tmp / "bad.edl") << bad;
+      g_rpn.stack.clear();
+      REQUIRE( (g_rpn.sync_eval(".\" " + (tmp / "bad.edl") + "\" EDL->") == rpn::WordDefinition::Result::param_error) );
+      REQUIRE( (1 == g_rpn.stack.depth()) );
+    }
+  }
+}
+
+TEST_CASE( "fft", "types" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "1 0 0 0 0 0 0 0 8 ->ARRAY FFT MAGNITUDE", "1 1 1 1 1 1 1 1 8 ->ARRAY" },
+    { "1 1 1 1 4 ->ARRAY FFT MAGNITUDE", "4 0 0 0 4 ->ARRAY" },
+    { "1 2 3 3 ->ARRAY 1 1 2 ->ARRAY CONV", "1. 3. 5. 3. 4 ->ARRAY" },
+    { "0 1 ->COMPLEX 1 0 ->COMPLEX -1 -1 ->COMPLEX 3 ->ARRAY ->CARRAY PHASE", "90. 0. -135. 3 ->ARRAY" },
+    { "3 4 ->COMPLEX MAGNITUDE", "5." },
+  };
+  require_close(g_rpn, same);
+
+  // power of two and Bluestein lengths against the textbook sum
+  for(size_t n : { 8, 12, 17, 64, 100 }) {
+    INFO("n = " << n);
+    q::Signal x(n);
+    for(size_t i=0; i<n; i++) {
+      x.re[i] = std::sin(double(i*i) * 0.37) + 0.25;
+      x.im[i] = std::cos(double(i) * 1.3);
+    }
+    q::Signal f = x;
+    q::fft(f);
+    for(size_t k=0; k<n; k++) {
+      double re = 0., im = 0.;
+      for(size_t j=0; j<n; j++) {
+	double a = -2. * M_PI * double((j*k) % n) / double(n);
+	re += x.re[j]*std::cos(a) - x.im[j]*std::sin(a);
+	im += x.re[j]*std::sin(a) + x.im[j]*std::cos(a);
+      }
+      REQUIRE_THAT(f.re[k], Catch::Matchers::WithinAbs(re, 0.000001));
+      REQUIRE_THAT(f.im[k], Catch::Matchers::WithinAbs(im, 0.000001));
+    }
+    q::fft(f, true);
+    for(size_t k=0; k<n; k++) {
+      REQUIRE_THAT(f.re[k], Catch::Matchers::WithinAbs(x.re[k], 0.000001));
+      REQUIRE_THAT(f.im[k], Catch::Matchers::WithinAbs(x.im[k], 0.000001));
+    }
+  }
+
+  // long enough to go through the transforms
+  {
+    q::Signal a(300), b(70);
+    for(size_t i=0; i<a.size(); i++) {
+      a.re[i] = double(i % 7) - 3.;
+    }
+    for(size_t i=0; i<b.size(); i++) {
+      b.re[i] = 1. / double(i+1);
+      b.im[i] = double(i % 3);
+    }
+    q::Signal c = q::convolve(a, b);
+    REQUIRE( (c.size() == a.size()+b.size()-1) );
+    for(size_t k=0; k<c.size(); k+=37) {
+      double re = 0., im = 0.;
+      for(size_t i=0; i<a.size(); i++) {
+	if (k >= i && k-i < b.size()) {
+	  re += a.re[i]*b.re[k-i];
+	  im += a.re[i]*b.im[k-i];
+	}
+      }
+      REQUIRE_THAT(c.re[k], Catch::Matchers::WithinAbs(re, 0.000001));
+      REQUIRE_THAT(c.im[k], Catch::Matchers::WithinAbs(im, 0.000001));
+    }
+  }
+
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval("1 .\" x\" 2 ->ARRAY FFT") == rpn::WordDefinition::Result::param_error) );
+  REQUIRE( (1 == g_rpn.stack.depth()) );
+  // the copy left behind by DUP doesn't see the transform
+  REQUIRE( (g_rpn.sync_eval("DROP 1 2 3 3 ->ARRAY ->CARRAY DUP FFT DROP 1 2 3 3 ->ARRAY ->CARRAY ==") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (1 == g_rpn.stack.depth()) );
+  REQUIRE( g_rpn.stack.peek_boolean(1) );
+}
+
+TEST_CASE( "matrix", "types" ) {
+  const std::string M = "1 2 2 ->ARRAY 3 4 2 ->ARRAY 2 ->ARRAY ->MATRIX ";
+  std::vector<std::pair<std::string,std::string>> same = {
+    { M + "MATRIX->", "1. 2. 2 ->ARRAY 3. 4. 2 ->ARRAY 2 ->ARRAY" },
+    { M + "TRANSPOSE", "1 3 2 ->ARRAY 2 4 2 ->ARRAY 2 ->ARRAY ->MATRIX" },
+    { M + "DUP MATMUL", "7 10 2 ->ARRAY 15 22 2 ->ARRAY 2 ->ARRAY ->MATRIX" },
+    { M + "DET", "-2." },
+    { "4 3 2 ->ARRAY 2 1 2 ->ARRAY 2 ->ARRAY ->MATRIX 7 3 2 ->ARRAY SOLVE", "1. 1. 2 ->ARRAY" },
+    { "4 3 2 ->ARRAY 2 1 2 ->ARRAY 2 ->ARRAY ->MATRIX INV", "-0.5 1.5 2 ->ARRAY 1 -2 2 ->ARRAY 2 ->ARRAY ->MATRIX" },
+    { "1 2 3 ->VEC3 1 0 0 5 4 ->ARRAY 0 1 0 0 4 ->ARRAY 0 0 1 0 4 ->ARRAY 3 ->ARRAY ->MATRIX TRANSFORM", "6 2 3 ->VEC3" },
+  };
+  require_same(g_rpn, same);
+
+  std::vector<std::string> bad = {
+    M + "1 2 3 3 ->ARRAY 1 ->ARRAY ->MATRIX MATMUL",
+    "1 2 2 ->ARRAY 2 4 2 ->ARRAY 2 ->ARRAY ->MATRIX INV",
+    "1 2 3 3 ->ARRAY 1 ->ARRAY ->MATRIX DET",
+    "1 2 2 ->ARRAY 3 1 ->ARRAY 2 ->ARRAY ->MATRIX",
+  };
+  for(auto const &b : bad) {
+    INFO("'" << b << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(b) == rpn::WordDefinition::Result::param_error) );
+  }
+
+  // across block boundaries, against the textbook loops
+  auto fill = [](size_t r, size_t c, unsigned seed) {
+    q::Matrix m(r, c);
+    for(auto &e : m.a) {
+      seed = seed * 1103515245 + 12345;
+      e = double((seed >> 8) % 2001) / 1000. - 1.;
+    }
+    return m;
+  };
+  q::Matrix a = fill(70, 65, 1);
+  q::Matrix b = fill(65, 90, 2);
+  q::Matrix p = q::multiply(a, b);
+  for(size_t i=0; i<a.rows; i+=7) {
+    for(size_t j=0; j<b.cols; j+=11) {
+      double s = 0.;
+      for(size_t k=0; k<a.cols; k++) {
+	s += a(i,k) * b(k,j);
+      }
+      REQUIRE_THAT(p(i,j), Catch::Matchers::WithinAbs(s, 0.000001));
+    }
+  }
+  REQUIRE( (q::transpose(q::transpose(a)) == a) );
+
+  q::Matrix sq = fill(64, 64, 3);
+  q::Matrix inv;
+  REQUIRE( q::inverse(sq, inv) );
+  q::Matrix id = q::multiply(sq, inv);
+  for(size_t i=0; i<id.rows; i++) {
+    for(size_t j=0; j<id.cols; j++) {
+      REQUIRE_THAT(id(i,j), Catch::Matchers::WithinAbs(i == j ? 1. : 0., 0.000001));
+    }
+  }
+  // det(AB) = det(A) det(B)
+  q::Matrix s2 = fill(64, 64, 4);
+  REQUIRE_THAT(q::determinant(q::multiply(sq, s2)),
+	       Catch::Matchers::WithinRel(q::determinant(sq) * q::determinant(s2), 0.000001));
+}
+
+TEST_CASE( "bignum", "types" ) {
+  std::string fact30 = "1";
+  for(int i=2; i<=30; i++) {
+    fact30 += " " + std::to_string(i) + " *";
+  }
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "9223372036854775807 1 +", "9223372036854775808" },
+    { "-9223372036854775807 2 -", "-9223372036854775809" },
+    { "4294967296 DUP *", "18446744073709551616" },
+    { "2 64 ^", "18446744073709551616" },
+    { fact30, "265252859812191058636308480000000" },
+    { "18446744073709551616 2 /", "9223372036854775808" },
+    { "18446744073709551616 4 /", "4611686018427387904" },
+    { "18446744073709551616 18446744073709551615 -", "1" },
+    { "-9223372036854775807 1 - CHS", "9223372036854775808" },
+    { "-9223372036854775807 1 - -1 /", "9223372036854775808" },
+    { "18446744073709551616 SQ", "340282366920938463463374607431768211456" },
+    { "18446744073709551616 0.5 *", "9223372036854775808." },
+    { "18446744073709551616 5 >", "TRUE" },
+    { "5 18446744073709551616 <", "TRUE" },
+    { "18446744073709551616 5 ==", "FALSE" },
+    { "4000000000 3 ->FRAC 4000000001 7 ->FRAC *", "16000000004000000000 21 ->FRAC" },
+    { "16000000004000000000 21 ->FRAC 1 2 ->FRAC +", "32000000008000000021 42 ->FRAC" },
+    { "1 4000000000 ->FRAC 1 4000000001 ->FRAC -", "1 16000000004000000000 ->FRAC" },
+    { "18446744073709551616 3 ->FRAC 3 *", "18446744073709551616 1 ->FRAC" },
+    { "18446744073709551616 3 ->FRAC INV OBJ-> DROP", "3" },
+    { "3037000500 1 ->FRAC 3037000500 *", "9223372037000250000 1 ->FRAC" },
+    { "1 3037000500 ->FRAC SQ", "1 9223372037000250000 ->FRAC" },
+    { "4611686018427387904 1 ->FRAC 4611686018427387904 +", "9223372036854775808 1 ->FRAC" },
+    { "4611686018427387904 4611686018427387904 1 ->FRAC +", "9223372036854775808 1 ->FRAC" },
+    { "-4611686018427387904 1 ->FRAC 4611686018427387905 -", "-9223372036854775809 1 ->FRAC" },
+    { "1 3037000500 ->FRAC 3037000500 /", "1 9223372037000250000 ->FRAC" },
+    { "3037000500 1 3037000500 ->FRAC /", "9223372037000250000 1 ->FRAC" },
+    { "9007199254740993 1 ->FRAC 1 +", "9007199254740994 1 ->FRAC" },
+  };
+  require_same(g_rpn, same);
+
+  std::vector<std::string> bad = {
+    "18446744073709551616 0 /",
+    "18446744073709551616 0 ->FRAC",
+    "18446744073709551616 -1 ^",
+    "2 100000000 ^",
+  };
+  for(auto const &b : bad) {
+    INFO("'" << b << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(b) == rpn::WordDefinition::Result::param_error) );
+  }
+
+  // negative integer powers, 0 has none
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval("0 -1 ^") == rpn::WordDefinition::Result::param_error) );
+  REQUIRE( (2 == g_rpn.stack.depth()) );
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval("2 -2 ^ 1 -5 ^ -1 -3 ^ -1 -4 ^") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (1 == g_rpn.stack.peek_integer(1)) );
+  REQUIRE( (-1 == g_rpn.stack.peek_integer(2)) );
+  REQUIRE( (1 == g_rpn.stack.peek_integer(3)) );
+  REQUIRE( (0.25 == g_rpn.stack.peek_double(4)) );
+
+  // well past the Karatsuba and reciprocal thresholds
+  std::string digits;
+  for(unsigned seed=1; digits.size() < 5000; ) {
+    seed = seed * 1103515245 + 12345;
+    digits += char('1' + (seed >> 16) % 9);
+  }
+  q::BigInt x, y;
+  REQUIRE( q::BigInt::parse(digits, x) );
+  REQUIRE( q::BigInt::parse("-" + digits.substr(0, 3100), y) );
+  REQUIRE( (x.to_string() == digits) );
+  REQUIRE( (((x+y)*(x+y)) == (x*x + q::BigInt(2)*x*y + y*y)) );
+  q::BigInt quotient, remainder;
+  // y is negative, the remainder takes the dividend's sign
+  q::BigInt::divide(x*y - q::BigInt(12345), y, quotient, remainder);
+  REQUIRE( (quotient == x) );
+  REQUIRE( (remainder == q::BigInt(-12345)) );
+  REQUIRE( (q::BigInt::gcd(x*y, y*y) == y.abs() * q::BigInt::gcd(x, y)) );
+}
+
+TEST_CASE( "lambda", "control" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "1 2 3 3 ->ARRAY << 10 * >> MAP", "10 20 30 3 ->ARRAY" },
+    { "1 2 3 4 4 ->ARRAY << 2 > >> FILTER", "3 4 2 ->ARRAY" },
+    { "1 2 3 4 4 ->ARRAY 0 << + >> REDUCE", "10" },
+    { "1 2 2 ->ARRAY 10 20 2 ->ARRAY << + >> ZIP-WITH", "11 22 2 ->ARRAY" },
+    { "0 ->ARRAY << 1 + >> MAP", "0 ->ARRAY" },
+    { ": tenfold 1 2 2 ->ARRAY << 10 * >> MAP ; tenfold", "10 20 2 ->ARRAY" },
+  };
+  require_same(g_rpn, same);
+
+  {
+    // a lambda has to leave exactly one value; the inputs come back
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("1 2 2 ->ARRAY << DUP >> MAP") == rpn::WordDefinition::Result::eval_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("1 1 ->ARRAY 1 2 2 ->ARRAY << + >> ZIP-WITH") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (3 == g_rpn.stack.depth()) );
+  }
+
+  {
+    // big enough for the pool, and again through a user word, which
+    // keeps it on this thread, also when the word is inside a nested loop
+    StArray arr;
+    for(int64_t i=0; i<100000; i++) {
+      arr.add_value(StInteger(i));
+    }
+    for(auto const &code : { "<< 2 * 1 + >> MAP", ": lambda-test-inc 1 + ; << 2 * lambda-test-inc >> MAP",
+			     "<< 2 * 0 1 FOR j lambda-test-inc NEXT >> MAP", "<< 2 * << 1 >> DROP 1 + >> MAP" }) {
+      INFO(code);
+      g_rpn.stack.clear();
+      g_rpn.stack.push(arr);
+      REQUIRE( (g_rpn.sync_eval(code) == rpn::WordDefinition::Result::ok) );
+      REQUIRE( (1 == g_rpn.stack.depth()) );
+      const auto &mapped = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+      REQUIRE( (mapped.size() == 100000) );
+      bool right = true;
+      for(size_t i=0; i<mapped.size(); i++) {
+	right &= int64_t(PEEK_CAST(const StInteger, mapped.value(i))) == int64_t(2*i+1);
+      }
+      REQUIRE( right );
+    }
+  }
+}
+
+TEST_CASE( "parfor", "control" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "0 4 PARFOR i i i * NEXT", "0. 1. 4. 9. 4 ->ARRAY" },
+    { "5 2 PARFOR i i NEXT", "0 ->ARRAY" },
+    { ": squares 0 3 PARFOR i i i * NEXT ; squares", "0. 1. 4. 3 ->ARRAY" },
+    { "0 2 PARFOR i 0 3 FOR j i j + NEXT + + NEXT", "3. 6. 2 ->ARRAY" },
+  };
+  require_same(g_rpn, same);
+
+  {
+    // each iteration starts from a copy of the inputs, which are left alone
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("10 0 3 PARFOR i i * NEXT") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    REQUIRE( (g_rpn.stack.peek_as_string(2) == "10") );
+    REQUIRE( (g_rpn.sync_eval("0. 10. 20. 3 ->ARRAY") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (g_rpn.stack.peek(1) == g_rpn.stack.peek(2)) );
+  }
+
+  {
+    // shared state and empty iterations fail with the bounds put back
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("0 3 PARFOR i .S NEXT") == rpn::WordDefinition::Result::eval_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("0 3 PARFOR i DROP NEXT") != rpn::WordDefinition::Result::ok) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+  }
+
+  {
+    // enough iterations for the pool, results in index order
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("7 0 50000 PARFOR i i 2 * + NEXT") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    const auto &r = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+    REQUIRE( (r.size() == 50000) );
+    bool right = true;
+    for(size_t i=0; i<r.size(); i++) {
+      right &= double(r.value(i)) == double(2*i + 7);
+    }
+    REQUIRE( right );
+  }
+}
+
+TEST_CASE( "random", "control" ) {
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "42 SEED DRAND NRAND RAND 3 ->ARRAY", "42 SEED DRAND NRAND RAND 3 ->ARRAY" },
+    { "7 SEED 0 100 PARFOR i DRAND NEXT", "7 SEED 0 100 PARFOR i DRAND NEXT" },
+    { "7 SEED 0 5000 PARFOR i NRAND NEXT", "7 SEED 0 5000 PARFOR i NRAND NEXT" },
+    { "9 SEED 1000 RANDS", "9 SEED 1000 RANDS" },
+    { "0 RANDS", "0 ->ARRAY" },
+  };
+  require_same(g_rpn, same);
+
+  std::vector<std::string> bad = {
+    "-1 RANDS",
+    "-1 NRANDS",
+    "1.5 SEED",
+  };
+  for(auto const &b : bad) {
+    INFO("'" << b << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(b) == rpn::WordDefinition::Result::param_error) );
+  }
+
+  {
+    // the bulk words sample the same distributions as DRAND and NRAND
+    for(auto const &w : { "RANDS", "NRANDS" }) {
+      INFO(w);
+      g_rpn.stack.clear();
+      REQUIRE( (g_rpn.sync_eval(std::string("3 SEED 100001 ") + w) == rpn::WordDefinition::Result::ok) );
+      const auto &r = PEEK_CAST(const StArray, g_rpn.stack.peek_const(1));
+      REQUIRE( (r.size() == 100001) );
+      double sum = 0., sq = 0., lo = 1., hi = 0.;
+      for(size_t i=0; i<r.size(); i++) {
+	double x = double(r.value(i));
+	sum += x;
+	sq += x*x;
+	lo = std::min(lo, x);
+	hi = std::max(hi, x);
+      }
+      double mean = sum / double(r.size());
+      double var = sq / double(r.size()) - mean*mean;
+      if (std::string(w) == "RANDS") {
+	REQUIRE( (lo >= 0. && hi < 1.) );
+	REQUIRE_THAT(mean, Catch::Matchers::WithinAbs(0.5, 0.01));
+	REQUIRE_THAT(var, Catch::Matchers::WithinAbs(1./12., 0.01));
+      } else {
+	REQUIRE_THAT(mean, Catch::Matchers::WithinAbs(0., 0.02));
+	REQUIRE_THAT(var, Catch::Matchers::WithinAbs(1., 0.02));
+      }
+    }
+  }
+
+  {
+    // iteration i draws from its own stream, not the thread that ran it,
+    // and the next loop gets different ones
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("5 SEED 0 2 PARFOR i DRAND NEXT 0 2 PARFOR i DRAND NEXT ==") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (false == g_rpn.stack.peek_boolean(1)) );
+  }
+}
+
+TEST_CASE( "def", "native" ) {
+  g_rpn.def<double(double,double)>("T-HYPOT", hypot);
+  g_rpn.def<int64_t(int64_t,int64_t)>("T-SUB", [](int64_t a, int64_t b) { return a - b; });
+  g_rpn.def<double(double,double)>("T-SUB", [](double a, double b) { return 1000. + a - b; });
+  g_rpn.def<std::string(const std::string&,int64_t)>("T-REP", [](const std::string &s, int64_t n) {
+      std::string rv;
+      for(int64_t i=0; i<n; i++) {
+	rv += s;
+      }
+      return rv;
+    });
+  g_rpn.def<rpn::WordDefinition::Result(rpn::Interp&,const StArray&,int64_t)>("T-AT", [](rpn::Interp &rpn, const StArray &a, int64_t i) {
+      if (i < 0 || size_t(i) >= a.size()) {
+	return rpn::WordDefinition::Result::param_error;
+      }
+      rpn.stack.push(a.value(size_t(i)));
+      return rpn::WordDefinition::Result::ok;
+    });
+
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "3 4 T-HYPOT", "5." },
+    { "3. 4 T-HYPOT", "5." },
+    { "3 4. T-HYPOT", "5." },
+    { "7 2 T-SUB", "5" },              // the Integer version came first
+    { "7. 2 T-SUB", "1005." },
+    { "7 2. T-SUB", "1005." },
+    { ".\" ab\" 3 T-REP", ".\" ababab\"" },
+    { "5 6 7 3 ->ARRAY 1 T-AT", "6" },
+  };
+  require_same(g_rpn, same);
+
+  std::vector<std::string> bad = {
+    ".\" a\" 3 T-HYPOT",
+    "2 .\" ab\" T-REP",
+  };
+  for(auto const &b : bad) {
+    INFO("'" << b << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(b) == rpn::WordDefinition::Result::param_error) );
+  }
+
+  {
+    // a word that refuses gets its arguments back
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval("5 6 2 ->ARRAY 9 T-AT") == rpn::WordDefinition::Result::param_error) );
+    REQUIRE( (2 == g_rpn.stack.depth()) );
+    REQUIRE( (g_rpn.stack.peek_integer(1) == 9) );
+    REQUIRE( (PEEK_CAST(const StArray, g_rpn.stack.peek_const(2)).size() == 2) );
+  }
+  for(auto w : { "T-HYPOT", "T-SUB", "T-REP", "T-AT" }) {
+    g_rpn.removeDefinition(w);
+  }
+}
+
+TEST_CASE( "tags", "types" ) {
+  REQUIRE( (rpn::type_tag<StDouble>() == rpn::tt_double) );
+  REQUIRE( (rpn::type_tag<StArray>() == rpn::tt_array) );
+  REQUIRE( (rpn::TypeRegistry::name(rpn::tt_integer) == "Integer") );
+  REQUIRE( (rpn::TypeRegistry::name(rpn::type_tag<stack::Fraction>()) == "Fraction") );
+  REQUIRE( (rpn::type_tag<stack::Fraction>() >= rpn::tt_registered) );
+  REQUIRE( (rpn::type_tag<stack::Fraction>() < rpn::TypeRegistry::size()) );
+  REQUIRE( (rpn::type_tag<stack::Fraction>() != rpn::type_tag<stack::Timecode>()) );
+
+  // an array element hasn't been pushed, it looks its tag up
+  StArray::Elements e;
+  e.push_back(std::make_unique<stack::Fraction>(1, 3));
+  StArray a(std::move(e));
+  REQUIRE( (a.value(0).tag() == rpn::type_tag<stack::Fraction>()) );
+
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval("1 3 ->FRAC 2.5") == rpn::WordDefinition::Result::ok) );
+  auto types = g_rpn.stack.types();
+  REQUIRE( (types.size() == 2) );
+  REQUIRE( (types[0] == rpn::tt_double) );
+  REQUIRE( (types[1] == rpn::type_tag<stack::Fraction>()) );
+  REQUIRE_THROWS( g_rpn.stack.pop_integer() );
+  REQUIRE_THROWS_AS( g_rpn.stack.peek_boolean(1), std::bad_cast );
+
+  std::vector<std::pair<std::string,bool>> compares = {
+    { "2 3 <", true },
+    { "2.5 1.5 >", true },
+    { "2 2 ==", true },
+    { "2 2. ==", false },
+    { ".\" a\" .\" b\" <=", true },
+    { "99999999999999999999 99999999999999999998 >", true },
+    { "99999999999999999999 99999999999999999999 !=", false },
+  };
+  for(auto const &c : compares) {
+    INFO("'" << c.first << "'");
+    g_rpn.stack.clear();
+    REQUIRE( (g_rpn.sync_eval(c.first) == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (1 == g_rpn.stack.depth()) );
+    REQUIRE( (g_rpn.stack.pop_boolean() == c.second) );
+  }
+}
+
+TEST_CASE( "lazy", "dictionary" ) {
+  // WORDLIST has every word, one any module defines has to bring that
+  // module in on its own
+  std::vector<std::string> words;
+  {
+    rpn::Interp full;
+    REQUIRE( (full.sync_eval("WORDLIST") == rpn::WordDefinition::Result::ok) );
+    auto &list = PEEK_CAST(const StArray, full.stack.peek_const(1));
+    for(size_t i=0; i<list.size(); i++) {
+      words.push_back(list.value(i));
+    }
+  }
+  REQUIRE( (words.size() > 100) );
+  for(auto const &w : words) {
+    INFO("'" << w << "'");
+    rpn::Interp fresh;
+    REQUIRE( fresh.wordExists(w) );
+  }
+
+  // a module added early doesn't get ahead of the ones before it
+  std::vector<std::pair<std::string,std::string>> same = {
+    { "1 3 ->FRAC DROP 2 3 +", "5" },
+    { "5 RANDS DROP 2. 3 *", "6." },
+    { "1 2 2 ->ARRAY ->CARRAY DROP 1 2 ->FRAC 1 2 ->FRAC +", "1 1 ->FRAC" },
+    // Type compiles words of its own, first needed while compiling CUBE
+    { ": CUBE DUP DUP * * ; 3 CUBE", "27" },
+  };
+  for(auto const &s : same) {
+    rpn::Interp fresh;
+    require_same(fresh, s.first, s.second);
+  }
+
+  {
+    // a user word of a built-in's name still comes after the built-in
+    rpn::Interp fresh;
+    REQUIRE( (fresh.sync_eval(": SQRT 99 ; 16 SQRT") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (fresh.stack.peek_double(1) == 4.) );
+  }
+
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval(".\" no-such-dictionary\" LOAD-DICT") == rpn::WordDefinition::Result::eval_error) );
+  REQUIRE( (1 == g_rpn.stack.depth()) );
+#ifdef RPN_TEST_DICT
+  {
+    rpn::Interp fresh;
+    REQUIRE( (fresh.sync_eval(std::string(".\" ") + RPN_TEST_DICT + "\" LOAD-DICT 21 T-TWICE 1.5 T-TWICE") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (fresh.stack.peek_integer(2) == 42) );
+    REQUIRE( (fresh.stack.peek_double(1) == 3.) );
+  }
+#endif
+}
+
+TEST_CASE( "complete", "dictionary" ) {
+  rpn::Interp fresh;
+  // SQRT is in a module nobody has asked for yet
+  REQUIRE( (fresh.complete("SQ") == std::vector<std::string>{ "SQ", "SQRT" }) );
+  REQUIRE( (fresh.sync_eval(": SQUID 1 ; : SQUAT 2 ;") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (fresh.complete("SQ") == std::vector<std::string>{ "SQ", "SQRT", "SQUAT", "SQUID" }) );
+  REQUIRE( (fresh.complete("SQ", 3) == std::vector<std::string>{ "SQ", "SQRT", "SQUAT" }) );
+  REQUIRE( (fresh.complete("SQU") == std::vector<std::string>{ "SQUAT", "SQUID" }) );
+  REQUIRE( fresh.complete("SQX").empty() );
+  fresh.removeDefinition("SQUID");
+  REQUIRE( (fresh.complete("SQU") == std::vector<std::string>{ "SQUAT" }) );
+  fresh.removeDefinition("SQRT");
+  REQUIRE( (fresh.complete("SQ") == std::vector<std::string>{ "SQ", "SQUAT" }) );
+
+  std::vector<std::pair<std::string,std::string>> same = {
+    { ".\" SQU\" WORDS-MATCHING", ".\" SQUAT\" 1 ->ARRAY" },
+    { ".\" ZZZ\" WORDS-MATCHING", "0 ->ARRAY" },
+    { ".\" ->VEC3x\" WORDS-MATCHING", ".\" ->VEC3x\" .\" ->VEC3xy\" 2 ->ARRAY" },
+  };
+  require_same(fresh, same);
+
+  fresh.stack.clear();
+  REQUIRE( (fresh.sync_eval("WORDLIST") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (PEEK_CAST(const StArray, fresh.stack.peek_const(1)).size() == fresh.complete("").size()) );
+}
+
+TEST_CASE( "trace", "state" ) {
+  TempDir tmp;
+  const std::string path = tmp / "trace-test.rpnt";
+  rpn::Interp fresh;
+  REQUIRE( (fresh.sync_eval("5 TRUE TRACE : SQ3 DUP DUP * * ; 3 SQ3 FALSE TRACE") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (fresh.sync_eval(".\" " + path + "\" TRACE-DUMP") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (2 == fresh.stack.depth()) );
+
+  rpn::Tracer::Trace t;
+  REQUIRE( rpn::Tracer::load(path, t) );
+  const rpn::TraceEvent *define = nullptr;
+  for(const auto &ev : t.events) {
+    if (ev.kind == rpn::Tracer::ev_define && t.words[ev.word] == "SQ3") {
+      define = &ev;
+    }
+  }
+  REQUIRE( define != nullptr );
+  uint16_t session = define->session;
+
+  std::vector<std::string> text;
+  size_t inner = 0;
+  for(const auto &ev : t.events) {
+    if (ev.session != session) {
+      continue;
+    }
+    if (ev.kind == rpn::Tracer::ev_start) {
+      REQUIRE( (1 == ev.depth) );
+    } else if (ev.kind == rpn::Tracer::ev_text) {
+      std::string w = t.words[ev.word];
+      w.erase(std::remove(w.begin(), w.end(), ' '), w.end());
+      text.push_back(w);
+    } else if (ev.kind == rpn::Tracer::ev_word && t.words[ev.word] == "DUP") {
+      REQUIRE( (ev.rdepth > 0) );
+      inner++;
+    }
+  }
+  REQUIRE( (2 == inner) );
+  REQUIRE( (std::find(text.begin(), text.end(), "3") != text.end()) );
+  REQUIRE( (std::find(text.begin(), text.end(), "SQ3") != text.end()) );
+
+  FILE *out = tmpfile();
+  rpn::Tracer::decode(t, out);
+  REQUIRE( (ftell(out) > 0) );
+  fclose(out);
+
+  // replayed from an empty stack, so without the 5
+  rpn::Interp replayed;
+  REQUIRE( (0 == rpn::Tracer::replay(t, session, replayed, stdout)) );
+  REQUIRE( (1 == replayed.stack.depth()) );
+  REQUIRE( (27 == replayed.stack.peek_integer(1)) );
+  REQUIRE( (replayed.sync_eval("2 SQ3") == rpn::WordDefinition::Result::ok) );
+  REQUIRE( (8 == replayed.stack.peek_integer(1)) );
+
+  REQUIRE( !rpn::Tracer::load(tmp / "no-such-trace.rpnt", t) );
+
+  {
+    // literals and lines don't take up word numbers
+    REQUIRE( (fresh.sync_eval("TRUE TRACE 1 2 DROP2 FALSE TRACE") == rpn::WordDefinition::Result::ok) );
+    uint32_t before = rpn::Tracer::word("trace-test-before");
+    REQUIRE( (fresh.sync_eval("TRUE TRACE 8675309 3.25 DROP2 FALSE TRACE") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( (rpn::Tracer::word("trace-test-after") == before+1) );
+  }
+
+  {
+    // a line too long to keep isn't replayed
+    rpn::Interp cut;
+    std::string line = ".\" " + std::string(rpn::Tracer::k_textMax, 'x') + "\"";
+    REQUIRE( (cut.sync_eval("TRUE TRACE " + line + " DROP FALSE TRACE") == rpn::WordDefinition::Result::ok) );
+    REQUIRE( rpn::Tracer::dump(path) );
+    REQUIRE( rpn::Tracer::load(path, t) );
+    const rpn::TraceEvent *cutEv = nullptr;
+    for(const auto &ev : t.events) {
+      if (ev.kind == rpn::Tracer::ev_cut) {
+	cutEv = &ev;
+      }
+    }
+    REQUIRE( cutEv != nullptr );
+    REQUIRE( (t.words[cutEv->word].size() == rpn::Tracer::k_textMax) );
+    REQUIRE( (line.compare(0, rpn::Tracer::k_textMax, t.words[cutEv->word]) == 0) );
+    rpn::Interp replayed;
+    REQUIRE( (rpn::Tracer::replay(t, cutEv->session, replayed, nullptr) > 0) );
+  }
+
+  {
+    // a thread's ring goes to the next thread, and dumps can be taken while it's written
+    uint16_t session = rpn::Tracer::session();
+    auto recorder = [session](size_t n) {
+      for(size_t i=0; i<n; i++) {
+	rpn::Tracer::record(rpn::Tracer::ev_text, std::to_string(i) + " DROP", false, 0, i, 0,
+			    session, rpn::Tracer::now());
+      }
+    };
+    std::thread(recorder, 1).join();
+    std::thread busy(recorder, 8*rpn::Tracer::k_ringSize);
+    for(int i=0; i<8; i++) {
+      REQUIRE( rpn::Tracer::dump(path) );
+      REQUIRE( rpn::Tracer::load(path, t) );
+    }
+    busy.join();
+    REQUIRE( rpn::Tracer::dump(path) );
+    REQUIRE( rpn::Tracer::load(path, t) );
+    const rpn::TraceEvent *first = nullptr;
+    bool right = true;
+    for(const auto &ev : t.events) {
+      if (ev.session == session) {
+	first = first ? first : &ev;
+	right &= ev.thread == first->thread && t.words[ev.word] == std::to_string(ev.depth) + " DROP";
+      }
+    }
+    REQUIRE( first != nullptr );
+    REQUIRE( right );
+  }
 }
 
 TEST_CASE( "vec3", "types" ) {
+  // the arrays against the same thing done a Vec3 at a time; A has no z
+  const std::string A = "1 ->VEC3x 2 ->VEC3y + ";
+  const std::string B = "1 2 3 ->VEC3 ";
+  const std::string AB = A + B + "2 ->ARRAY ->VEC3ARRAY ";
+  const std::string BA = B + A + "2 ->ARRAY ->VEC3ARRAY ";
+  std::vector<std::pair<std::string,std::string>> same = {
+    { AB + "5 6 7 ->VEC3 + VEC3ARRAY->", A + "5 6 7 ->VEC3 + " + B + "5 6 7 ->VEC3 + 2 ->ARRAY" },
+    { AB + BA + "- VEC3ARRAY->", A + B + "- " + B + A + "- 2 ->ARRAY" },
+    { AB + "2 * VEC3ARRAY->", A + "2 * " + B + "2 * 2 ->ARRAY" },
+    { AB + "0.5 - VEC3ARRAY->", A + "0.5 - " + B + "0.5 - 2 ->ARRAY" },
+    { "0.5 " + AB + "- VEC3ARRAY->", "0.5 " + A + "- 0.5 " + B + "- 2 ->ARRAY" },
+    { "3 2 1 ->VEC3 0.5 -", "2.5 1.5 0.5 ->VEC3" },
+    { AB + "LENGTH SWAP DROP", "2" },
+    { "1 0 0 ->VEC3 0 1 0 ->VEC3 2 ->ARRAY ->VEC3ARRAY 0 0 1 ->VEC3 CROSS VEC3ARRAY->", "0 -1 0 ->VEC3 1 0 0 ->VEC3 2 ->ARRAY" },
+    { AB + "1 1 1 ->VEC3 DOT", "3. 6. 2 ->ARRAY" },
+    { "3 4 0 ->VEC3 NORM", "5." },
+    { "3 ->VEC3x 4 ->VEC3y + NORMALIZE", "0.6 ->VEC3x 0.8 ->VEC3y +" },
+    { B + "1 0 0 10 4 ->ARRAY 0 1 0 20 4 ->ARRAY 0 0 1 30 4 ->ARRAY 3 ->ARRAY TRANSFORM", "11 22 33 ->VEC3" },
+    { AB + "2 0 0 0 0 2 0 0 0 0 2 0 12 ->ARRAY TRANSFORM VEC3ARRAY->", "2 ->VEC3x 4 ->VEC3y + 2 4 6 ->VEC3 2 ->ARRAY" },
+  };
+  require_same(g_rpn, same);
+
+  g_rpn.stack.clear();
+  REQUIRE( (g_rpn.sync_eval(AB + B + B + B + "3 ->ARRAY ->VEC3ARRAY +") == rpn::WordDefinition::Result::param_error) );
+  REQUIRE( (2 == g_rpn.stack.depth()) );
 }
 
 TEST_CASE( "double", "types" ) {
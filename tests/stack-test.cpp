@@ -388,6 +388,113 @@ TEST_CASE("stack operations" "stack") {
 
 }
 
+TEST_CASE("change journal" "stack") {
+  rpn::Stack s;
+  std::vector<rpn::Stack::Change> changed;
+
+  s.push_integer(1);
+  s.push_integer(2);
+  s.push_integer(3);
+  auto seen = s.changes(0, 10, changed);
+  REQUIRE(changed.size() == 3);
+  REQUIRE(changed[0].slot == 2);
+  REQUIRE(changed[0].text == "3");
+
+  changed.clear();
+  REQUIRE(s.changes(seen, 10, changed) == seen);
+  REQUIRE(changed.empty()); // nothing moved
+
+  s.push_integer(4);
+  s.swap();
+  seen = s.changes(seen, 10, changed);
+  REQUIRE(changed.size() == 2); // only the swapped pair
+  REQUIRE(changed[0].slot == 3);
+  REQUIRE(changed[0].text == "3");
+  REQUIRE(changed[1].slot == 2);
+  REQUIRE(changed[1].text == "4");
+
+  changed.clear();
+  s.drop();
+  seen = s.changes(seen, 10, changed);
+  REQUIRE(changed.empty()); // slots below the drop are untouched
+
+  s.push_double(0.5);
+  s.setPrecision(2);
+  changed.clear();
+  seen = s.changes(seen, 1, changed);
+  REQUIRE(changed.size() == 1); // limited to the top level
+  REQUIRE(changed[0].text == "0.5");
+}
+
+TEST_CASE("shared values" "stack") {
+  rpn::Stack s;
+  StArray arr;
+  for(int i=0; i<1000; i++) {
+    arr.add_value(StInteger(i));
+  }
+  s.push(arr);
+  REQUIRE(arr.shared()); // the stack holds the same elements
+  s.dup();
+  auto &top = PEEK_CAST(StArray, s.peek(1));
+  auto &next = PEEK_CAST(StArray, s.peek(2));
+  REQUIRE(&top.val() == &next.val());
+
+  top.add_value(StString("x")); // detaches only the top copy
+  REQUIRE(&top.val() != &next.val());
+  REQUIRE(top.val().size() == 1001);
+  REQUIRE(next.val().size() == 1000);
+  REQUIRE(arr == next);
+
+  StObject obj;
+  obj.add_value("a", arr);
+  StObject copy(obj);
+  copy.add_value("b", StInteger(2));
+  REQUIRE(!obj.has_member("b"));
+  REQUIRE(copy.has_member("a"));
+  REQUIRE(copy.value(0) == arr);
+  REQUIRE(obj.size() == 1);
+}
+
+TEST_CASE("bulk moves" "stack") {
+  rpn::Stack s;
+  s.push_integer(0);
+  s.push_integer(1);
+  s.push_string("two");
+  const auto *two = &s.peek_const(1);
+  auto obs = s.popn(2);
+  REQUIRE(s.depth() == 1);
+  REQUIRE(obs.size() == 2);
+  REQUIRE(obs[1].get() == two); // moved, not copied
+  REQUIRE(int64_t(PEEK_CAST(StInteger, *obs[0])) == 1);
+
+  s.pushn(std::move(obs));
+  REQUIRE(s.depth() == 3);
+  REQUIRE(&s.peek_const(1) == two);
+  REQUIRE(s.peek_integer(2) == 1);
+  REQUIRE(s.popn(4).empty()); // too deep
+}
+
+TEST_CASE("object shapes" "stack") {
+  StObject a, b;
+  a.add_value("y", StInteger(1));
+  a.add_value("x", StInteger(2));
+  b.add_value("x", StInteger(3));
+  b.add_value("y", StInteger(4));
+  REQUIRE(a.shape() == b.shape()); // same keys, same shape
+  REQUIRE(a.key(0) == "x");
+  REQUIRE(int64_t(PEEK_CAST(const StInteger, a.member("x"))) == 2);
+  REQUIRE(int64_t(PEEK_CAST(const StInteger, b.member("y"))) == 4);
+  REQUIRE(!(a == b));
+
+  a.add_value("x", StInteger(5)); // first value wins
+  REQUIRE(int64_t(PEEK_CAST(const StInteger, a.member("x"))) == 2);
+  b.add_value("z", StInteger(6));
+  REQUIRE(a.shape() != b.shape());
+  REQUIRE(b.has_member("z"));
+  REQUIRE(!a.has_member("z"));
+  REQUIRE(StObject::intern("x") == StObject::intern(std::string("x")));
+}
+
 // TEST_CASE("object-test StDouble", "[single-file]") {}
 // TEST_CASE("object-test StInteger", "[single-file]") {}
 // TEST_CASE("object-test StString", "[single-file]") {}
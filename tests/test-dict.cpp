@@ -0,0 +1,23 @@
+/***************************************************
+ * file: qinc/rpn-lang/tests/test-dict.cpp
+ *
+ * @file    test-dict.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ * a shared object dictionary for runtime-test's LOAD-DICT
+ */
+
+#include "rpn.h"
+
+RPN_DICTIONARY(rpn) {
+  rpn.def<int64_t(int64_t)>("T-TWICE", [](int64_t a) { return 2 * a; });
+  rpn.def<double(double)>("T-TWICE", [](double a) { return 2. * a; });
+}
+
+/* end of qinc/rpn-lang/tests/test-dict.cpp */
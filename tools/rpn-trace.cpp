@@ -0,0 +1,59 @@
+/***************************************************
+ * file: qinc/rpn-lang/tools/rpn-trace.cpp
+ *
+ * @file    rpn-trace.cpp
+ * @author  Eric L. Hernes
+ * @version V1.0
+ * @born_on   Monday, October 19, 2026
+ * @copyright (C) Copyright Eric L. Hernes 2026
+ * @copyright (C) Copyright Q, Inc. 2026
+ *
+ * @brief   An Eric L. Hernes Signature Series C++ module
+ *
+ * reads what TRACE-DUMP wrote:
+ *   rpn-trace file       every event, oldest first
+ *   rpn-trace -r file    each session's words again in a new Interp
+ */
+
+#include "rpn.h"
+#include "src/trace.h"
+
+#include <cstring>
+#include <set>
+
+int
+main(int argc, char **argv) {
+  bool replay = argc == 3 && strcmp(argv[1], "-r") == 0;
+  if (argc != (replay ? 3 : 2)) {
+    fprintf(stderr, "usage: %s [-r] trace-file\n", argv[0]);
+    return 2;
+  }
+
+  rpn::Tracer::Trace t;
+  if (!rpn::Tracer::load(argv[argc-1], t)) {
+    fprintf(stderr, "%s: can't read %s\n", argv[0], argv[argc-1]);
+    return 1;
+  }
+
+  if (!replay) {
+    rpn::Tracer::decode(t, stdout);
+    return 0;
+  }
+
+  std::set<uint16_t> sessions;
+  for(const auto &ev : t.events) {
+    if (ev.kind == rpn::Tracer::ev_text || ev.kind == rpn::Tracer::ev_cut) {
+      sessions.insert(ev.session);
+    }
+  }
+  size_t diverged = 0;
+  for(auto s : sessions) {
+    rpn::Interp rpn;
+    size_t n = rpn::Tracer::replay(t, s, rpn, stdout);
+    printf("session %u: %zu differ\n", s, n);
+    diverged += n;
+  }
+  return diverged == 0 ? 0 : 1;
+}
+
+/* end of qinc/rpn-lang/tools/rpn-trace.cpp */
@@ -108,8 +108,10 @@ struct QtKeypadController::Privates {
   Ui::RpnKeypad* _ui;
   QMenu *_mKeys;
   QMenu *_mFile;
+  std::vector<std::string> _rows; // rendered stack, 0 is the bottom
+  uint64_t _seen = 0; // stack generation of _rows
 
-  void redraw_display() const;
+  void redraw_display();
   void assign_button(unsigned column, unsigned row, const std::string &rpnword, const QString &label="");
   void assign_menu(const QString &menu, const std::string &rpnword, const QString &label="");
 
@@ -178,9 +180,27 @@ QtKeypadController::on_file_open() {
 
 void
 QtKeypadController::on_file_save_stack() {
+  QString fileName = QFileDialog::getSaveFileName(this,
+						  "Save Stack", "", "RPN Images (*.rpni)");
+  // not as SAVE-IMAGE text: the name may have a '"' in it
+  if (fileName != "") {
+    setEnabled(false);
+    _p->_rpn.saveImage(fileName.toStdString(), [this](rpn::WordDefinition::Result) {
+	emit signal_rpn_complete();
+      });
+  }
 }
+
 void
 QtKeypadController::on_file_restore_stack() {
+  QString fileName = QFileDialog::getOpenFileName(this,
+						  "Restore Stack", "", "RPN Images (*.rpni)");
+  if (fileName != "") {
+    setEnabled(false);
+    _p->_rpn.loadImage(fileName.toStdString(), [this](rpn::WordDefinition::Result) {
+	emit signal_rpn_complete();
+      });
+  }
 }
 
 /******************************** DIGITS ********************************/
@@ -310,15 +330,23 @@ void QtKeypadController::on_programmable_button_clicked() {
 /******************************** Stack display  ********************************/
 
 void
-QtKeypadController::Privates::redraw_display() const {
+QtKeypadController::Privates::redraw_display() {
   _ui->textEdit->clear();
   _ui->textEdit->setAlignment(Qt::AlignRight);
-  
-  for(size_t i=_rpn.stack.depth(); i!=0; i--) {
+
+  // only re-render the slots that changed since the last redraw
+  std::vector<rpn::Stack::Change> changed;
+  size_t depth = _rpn.stack.depth();
+  _rows.resize(depth);
+  _seen = _rpn.stack.changes(_seen, int(depth), changed);
+  for(auto &c : changed) {
+    _rows[c.slot] = c.text;
+  }
+
+  for(size_t i=depth; i!=0; i--) {
     char level[32];
-    snprintf(level, sizeof(level), " : %02d%s", i, i>1?"\n":"");
-    auto so = _rpn.stack.peek_as_string(i);
-    _ui->textEdit->insertPlainText(QString::fromStdString(so+level));
+    snprintf(level, sizeof(level), " : %02zu%s", i, i>1?"\n":"");
+    _ui->textEdit->insertPlainText(QString::fromStdString(_rows[depth-i]+level));
   }
   _ui->statusLabel->setText(QString::fromStdString(_rpn.status()));
   _ui->textEdit->verticalScrollBar()->setValue(_ui->textEdit->verticalScrollBar()->maximum());